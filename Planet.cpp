@@ -7,6 +7,7 @@
 *
 *	Functions Included:
 *
+*       int getBody();
 *       string getName();
 *       float getHoursPerDay();
 *       float getDaysPerYear();
@@ -19,6 +20,10 @@
 *       int getRows();
 *       int getCols();
 *       byte* getImage();
+*       void setTexture(GLuint texture);
+*       GLuint getTexture();
+*       void setLod(int level);
+*       int getLod();
 *       GLfloat getR();
 *       GLfloat getG();
 *       GLfloat getB();
@@ -26,7 +31,9 @@
 *	Description:
 *
 *       This class contains all of the information for the planet objects. It is
-*       a series of getters and setters for planet specific data.
+*       a series of getters and setters for planet specific data. A planet is a
+*       thin view of one row of the body table in bodies.cpp, which holds the
+*       data itself.
 *
 *	Modified: Original
 *
@@ -34,8 +41,8 @@
 
 /**************************** Library Includes *******************************/
 #include <iostream>
-#include <cmath>
 #include "Planet.h"
+#include "globals.h"
 
 /******************************* Name Space **********************************/
 
@@ -48,7 +55,8 @@ using namespace std;
 * Function:Planet
 *
 * Description:
-*       Constructor. Reads in the data for planet
+*       Constructor. Adds a new body, with no flags, to the body table and
+*       views it.
 *
 *
 * Parameters:
@@ -78,20 +86,47 @@ using namespace std;
 ******************************************************************************/
 Planet::Planet(string name, int hours, int days, int radius, int distance, int nrow, int cols, byte* image, GLfloat r, GLfloat g, GLfloat b)
 {
-    Name = name;
-    HoursPerDay = hours;
-    DaysPerYear = days;
-    Radius = radius;
-    Distance = distance;
-    HourOfDay = 0.0;
-    DayOfYear = 0.0;
-    Rows = nrow;
-    Col = cols;
-    Image = image;
-    R = r;
-    G = g;
-    B = b;
+    Body = AddBody(name, hours, days, radius, distance, nrow, cols, image, r, g, b, 0);
+}
+
 
+/******************************************************************************
+* Author: Daniel Hodgin and Savoy Schuler
+*
+* Function:Planet
+*
+* Description:
+*       Constructor. Views a body already in the body table.
+*
+*
+* Parameters:
+*
+*   body        -row of the body in the table
+*
+******************************************************************************/
+Planet::Planet(int body)
+{
+    Body = body;
+}
+
+
+/******************************************************************************
+* Author: Daniel Hodgin and Savoy Schuler
+*
+* Function:getBody
+*
+* Description:
+*
+*       Returns the row of the body in the body table.
+*
+* Parameters:
+*
+*   void        -no parameter
+*
+******************************************************************************/
+int Planet::getBody()
+{
+    return Body;
 }
 
 
@@ -111,11 +146,10 @@ Planet::Planet(string name, int hours, int days, int radius, int distance, int n
 ******************************************************************************/
 string Planet::getName()
 {
-    return Name;
+    return Bodies.Name[Body];
 }
 
 
-
 /******************************************************************************
 * Author: Daniel Hodgin and Savoy Schuler
 *
@@ -132,11 +166,10 @@ string Planet::getName()
 ******************************************************************************/
 float Planet::getHoursPerDay()
 {
-    return HoursPerDay;
+    return Bodies.HoursPerDay[Body];
 }
 
 
-
 /******************************************************************************
 * Author: Daniel Hodgin and Savoy Schuler
 *
@@ -153,7 +186,7 @@ float Planet::getHoursPerDay()
 ******************************************************************************/
 float Planet::getDaysPerYear()
 {
-    return DaysPerYear;
+    return Bodies.DaysPerYear[Body];
 }
 
 
@@ -173,7 +206,7 @@ float Planet::getDaysPerYear()
 ******************************************************************************/
 int Planet::getRadius()
 {
-    return Radius;
+    return Bodies.Radius[Body];
 }
 
 
@@ -193,11 +226,10 @@ int Planet::getRadius()
 ******************************************************************************/
 int Planet::getDistance()
 {
-    return Distance;
+    return Bodies.Distance[Body];
 }
 
 
-
 /******************************************************************************
 * Author: Daniel Hodgin and Savoy Schuler
 *
@@ -205,7 +237,9 @@ int Planet::getDistance()
 *
 * Description:
 *
-*   Set's planet's day of year.
+*   Set's planet's day of year. The planet jumps straight there, without
+*   blending from its previous day. Only the drawn copy of the body's phase
+*   is changed; the simulation keeps its own.
 *
 * Parameters:
 *
@@ -214,9 +248,11 @@ int Planet::getDistance()
 ******************************************************************************/
 void Planet::setDayOfYear(float day)
 {
-    DayOfYear = day;
-}
+    float days = Bodies.DaysPerYear[Body];
 
+    Bodies.Phases.Orbit[Body] = days > 0 ? day / days : 0.0;
+    Bodies.Phases.PrevOrbit[Body] = Bodies.Phases.Orbit[Body];
+}
 
 
 /******************************************************************************
@@ -235,9 +271,10 @@ void Planet::setDayOfYear(float day)
 ******************************************************************************/
 float Planet::getDayOfYear()
 {
-    return fmod(DayOfYear,DaysPerYear);
-}
+    float phase = Bodies.Phases.Orbit[Body];
 
+    return ( phase - ( int ) phase ) * Bodies.DaysPerYear[Body];
+}
 
 
 /******************************************************************************
@@ -247,7 +284,9 @@ float Planet::getDayOfYear()
 *
 * Description:
 *
-*   Sets planet's hour of the day.
+*   Sets planet's hour of the day. The planet jumps straight there, without
+*   blending from its previous hour. Only the drawn copy of the body's phase
+*   is changed; the simulation keeps its own.
 *
 * Parameters:
 *
@@ -256,9 +295,11 @@ float Planet::getDayOfYear()
 ******************************************************************************/
 void Planet::setHourOfDay(float hour)
 {
-    HourOfDay = hour;
-}
+    float hours = Bodies.HoursPerDay[Body];
 
+    Bodies.Phases.Spin[Body] = hours > 0 ? hour / hours : 0.0;
+    Bodies.Phases.PrevSpin[Body] = Bodies.Phases.Spin[Body];
+}
 
 
 /******************************************************************************
@@ -277,7 +318,9 @@ void Planet::setHourOfDay(float hour)
 ******************************************************************************/
 float Planet::getHourOfDay()
 {
-    return fmod(HourOfDay,HoursPerDay);
+    float phase = Bodies.Phases.Spin[Body];
+
+    return ( phase - ( int ) phase ) * Bodies.HoursPerDay[Body];
 }
 
 
@@ -297,7 +340,7 @@ float Planet::getHourOfDay()
 ******************************************************************************/
 int Planet::getRows()
 {
-    return Rows;
+    return Bodies.Rows[Body];
 }
 
 
@@ -317,11 +360,10 @@ int Planet::getRows()
 ******************************************************************************/
 int Planet::getCols()
 {
-    return Col;
+    return Bodies.Cols[Body];
 }
 
 
-
 /******************************************************************************
 * Author: Daniel Hodgin and Savoy Schuler
 *
@@ -338,10 +380,89 @@ int Planet::getCols()
 ******************************************************************************/
 byte* Planet::getImage()
 {
-    return Image;
+    return Bodies.Image[Body];
 }
 
 
+/******************************************************************************
+* Author: Daniel Hodgin and Savoy Schuler
+*
+* Function:setTexture
+*
+* Description:
+*
+*   Sets the OpenGL texture object created from planet's texture map.
+*
+* Parameters:
+*
+*   texture     -texture object name
+*
+******************************************************************************/
+void Planet::setTexture(GLuint texture)
+{
+    Bodies.Texture[Body] = texture;
+}
+
+
+/******************************************************************************
+* Author: Daniel Hodgin and Savoy Schuler
+*
+* Function:getTexture
+*
+* Description:
+*
+*   Returns planet's OpenGL texture object (0 if none has been created).
+*
+* Parameters:
+*
+*   void        -no parameter
+*
+******************************************************************************/
+GLuint Planet::getTexture()
+{
+    return Bodies.Texture[Body];
+}
+
+
+/******************************************************************************
+* Author: Daniel Hodgin and Savoy Schuler
+*
+* Function:setLod
+*
+* Description:
+*
+*   Sets the level of detail the planet was drawn with.
+*
+* Parameters:
+*
+*   level       -level of detail
+*
+******************************************************************************/
+void Planet::setLod(int level)
+{
+    Bodies.Lod[Body] = level;
+}
+
+
+/******************************************************************************
+* Author: Daniel Hodgin and Savoy Schuler
+*
+* Function:getLod
+*
+* Description:
+*
+*   Returns the level of detail the planet was last drawn with.
+*
+* Parameters:
+*
+*   void        -no parameter
+*
+******************************************************************************/
+int Planet::getLod()
+{
+    return Bodies.Lod[Body];
+}
+
 
 /******************************************************************************
 * Author: Daniel Hodgin and Savoy Schuler
@@ -359,11 +480,10 @@ byte* Planet::getImage()
 ******************************************************************************/
 GLfloat Planet::getR()
 {
-    return R;
+    return Bodies.R[Body];
 }
 
 
-
 /******************************************************************************
 * Author: Daniel Hodgin and Savoy Schuler
 *
@@ -380,11 +500,10 @@ GLfloat Planet::getR()
 ******************************************************************************/
 GLfloat Planet::getG()
 {
-    return G;
+    return Bodies.G[Body];
 }
 
 
-
 /******************************************************************************
 * Author: Daniel Hodgin and Savoy Schuler
 *
@@ -401,5 +520,5 @@ GLfloat Planet::getG()
 ******************************************************************************/
 GLfloat Planet::getB()
 {
-    return B;
+    return Bodies.B[Body];
 }
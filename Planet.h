@@ -7,6 +7,7 @@
 *
 *	Functions Included:
 *
+*       int getBody();
 *       string getName();
 *       float getHoursPerDay();
 *       float getDaysPerYear();
@@ -19,6 +20,10 @@
 *       int getRows();
 *       int getCols();
 *       byte* getImage();
+*       void setTexture(GLuint texture);
+*       GLuint getTexture();
+*       void setLod(int level);
+*       int getLod();
 *       GLfloat getR();
 *       GLfloat getG();
 *       GLfloat getB();
@@ -59,7 +64,8 @@ typedef unsigned char byte;
 *
 *       This class contains all of the size and positional information
 *       for the planet. Its a series of getters and setters abstract
-*       the data for the planets.
+*       the data for the planets. The data itself lives in one row of the
+*       body table (see bodies.cpp); a planet only remembers which row.
 *
 ******************************************************************************/
 class Planet
@@ -69,9 +75,11 @@ public:
     /// Constructors and Destructor
     Planet();
     Planet(string name, int hours, int days, int radius, int distance, int nrow, int cols, byte* image, GLfloat r, GLfloat g, GLfloat b);
+    Planet(int body);
     ~Planet();
 
     /// Get/Set functions
+    int getBody();                  //returns row in the body table
     string getName();               //returns name
     float getHoursPerDay();         //return hours per year
     float getDaysPerYear();         //returns days per year
@@ -84,25 +92,16 @@ public:
     int getRows();                  //returns rows
     int getCols();                  //returns columns
     byte* getImage();               //returns pointer to texture map
+    void setTexture(GLuint texture);//sets the texture object
+    GLuint getTexture();            //returns the texture object
+    void setLod(int level);         //sets the level of detail
+    int getLod();                   //returns the level of detail
     GLfloat getR();                 //returns red value
     GLfloat getG();                 //returns green value
     GLfloat getB();                 //returns blue value
 
 private:
-    string Name;        //planet name
-    float DayOfYear;    //day of the year
-    float HourOfDay;    //hour of the day
-    float HoursPerDay;  //planet's hours in a day
-    float DaysPerYear;  //planet's days in a year
-    int Radius;         //planet's raduis
-    int Distance;       //distance from the suns surface
-    int Rows;           //number of rows in planet's texture .bmp image
-    int Col;            //number of columns in planet's texture .bmp image
-    byte* Image;        //pointer to location in memory of planet's stored texture map
-    //read in from .bmp image
-    GLfloat R;          //planet's red value (used for color when no texture map)
-    GLfloat G;          //planet's green value (used for color when no texture map)
-    GLfloat B;          //planet's blue value (used for color when no texture map)
+    int Body;           //row of the planet in the body table
 };
 
 #endif
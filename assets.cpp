@@ -0,0 +1,737 @@
+/******************************************************************************
+*	File: assets.cpp
+*
+*	Authors: Savoy Schuler and Daniel Hodgin
+*
+*	Date: 11-17-16
+*
+*	Description:
+*
+*		This file contains the asset loader, which streams texture maps in as
+*       they are needed. Texture maps named in the catalog are registered here
+*       while it is read, one entry per file no matter how many bodies share
+*       it, but nothing is read yet. The first time a body is drawn with
+*       texture mapping on, its texture map is requested, and a pool of worker
+*       threads (one per core) decodes it in the background. Bodies never seen
+*       are never loaded. Texture maps found in the texture pack (see pack.cpp)
+*       need no decoding and go straight to upload.
+*
+*       Only the GLUT thread may talk to OpenGL, so the workers just hand each
+*       decoded image back on a list of finished textures. At the start of
+*       each frame UploadAssets creates the texture objects for whatever has
+*       finished and frees the decoded images, so texture maps are only held in
+*       memory while on their way to OpenGL. Until a body's texture arrives it
+*       has no texture object and is drawn in its own color (see
+*       BodyTextured).
+*
+*       Texture maps tiled in the pack are not loaded whole but drawn from
+*       the virtual texture cache instead (see vtexture.cpp), whose tiles are
+*       uploaded here too.
+*
+*       The backdrop's cube map (see skybox.cpp) is loaded the same way, by
+*       the same workers, and kept once uploaded.
+*
+*       Resident textures are kept in least recently drawn order. While they
+*       take more than TextureBudget bytes the least recently drawn texture is
+*       deleted, unless it was drawn in the last frame. Its bodies go back to
+*       their own color and request it again when next drawn.
+*
+*	File Order and Structure:
+*
+*       - Register and request textures.
+*       - Start/stop the workers.
+*       - Worker threads.
+*       - Upload and evict textures.
+*
+*	Modified:
+*
+*		Texture maps are loaded when first drawn, instead of all at startup,
+*       and evicted to stay within a memory budget.
+*
+*	Functions Included:
+*
+*           //Register and request textures.
+*
+*       void RegisterTexture( const char *filename, int body );
+*       void RequestTexture( int body );
+*       void RequestSkybox( int body, bool packed );
+*
+*           //Start/stop the workers.
+*
+*       void StartAssetLoader();
+*       void StopAssetLoader();
+*
+*           //Worker threads.
+*
+*       static void AssetWorker();
+*
+*           //Upload and evict textures.
+*
+*       bool UploadAssets();
+*       static void EvictTextures();
+*       bool AssetsPending();
+*       bool AssetsReady();
+*       bool TexturesLoading();
+*       void PrefetchAssets();
+*       int ResidentTextures();
+*       size_t ResidentTextureBytes();
+*
+******************************************************************************/
+
+/**************************** Library Includes *******************************/
+#include <condition_variable>
+#include <cstdlib>
+#include <deque>
+#include <GL/freeglut.h>
+#include <iostream>
+#include <list>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "Planet.h"
+#include "globals.h"
+#include "pack.h"
+
+/******************************* Name Space **********************************/
+
+using namespace std;
+
+/******************************** Type Def ***********************************/
+
+//Where a texture map is on its way from file to OpenGL.
+enum TextureState
+{
+    TextureUnloaded,    //not in memory
+    TextureLoading,     //requested and being decoded
+    TextureResident     //uploaded to its texture object
+};
+
+//A texture map and the bodies that use it.
+struct TextureEntry
+{
+    string Filename;            //.bmp file to read
+    vector<int> Bodies;         //rows of the bodies using it
+    TextureState State;         //where the texture map is
+    int Rows;                   //rows in the decoded image
+    int Cols;                   //columns in the decoded image
+    byte* Image;                //decoded image, until uploaded
+    byte* Mipmaps;              //mipmaps built from it, until uploaded
+    bool Packed;                //found in the texture pack
+    TextureLevels Levels;       //levels to upload, in the pack or built
+    int Cell;                   //atlas cell holding it, or -1
+    size_t Bytes;               //memory taken by its texture object
+    unsigned LastDrawn;         //frame it was last drawn in
+    list<int>::iterator Place;  //place in the resident list
+};
+
+/******************************* Constants **********************************/
+
+//Default most bytes of resident textures.
+static const size_t DefaultTextureBudget = 256 * 1024 * 1024;
+
+/********************************* Globals ***********************************/
+
+//Most bytes of resident textures, set by the -texmem command line option.
+size_t TextureBudget = DefaultTextureBudget;
+
+/* Owned by the GLUT thread, except each entry's Rows, Cols, Image, Mipmaps
+   and Levels while it is loading, which belong to the worker decoding it: */
+
+//Every texture map registered.
+static vector<TextureEntry> Textures;
+
+//Texture of each body, -1 for none.
+static vector<int> BodyTextures;
+
+//Texture index of each file registered.
+static unordered_map<string, int> TextureFiles;
+
+//Resident textures, most recently drawn first.
+static list<int> Resident;
+
+//Bytes taken by resident textures.
+static size_t ResidentBytes = 0;
+
+//Number of textures and skyboxes requested and not uploaded yet.
+static int Loading = 0;
+
+//Number of the frame being drawn.
+static unsigned Frame = 0;
+
+//The worker threads.
+static vector<thread> Workers;
+
+/* Shared between the threads: */
+
+//Textures requested and waiting for a worker.
+static deque<int> Requests;
+
+//Textures decoded and waiting to be uploaded.
+static vector<int> Finished;
+
+//Skyboxes, by body, requested and waiting for a worker, and loaded and
+//waiting to be uploaded.
+static deque<int> SkyboxRequests;
+static vector<int> SkyboxesFinished;
+
+//Guards the request and finished lists, and Quit.
+static mutex LoaderMutex;
+
+//Wakes workers when a texture or skybox is requested.
+static condition_variable LoaderSignal;
+
+//Set to end the worker threads.
+static bool Quit = false;
+
+/*************************** Function Prototypes *****************************/
+
+static void AssetWorker();
+static void EvictTextures();
+
+
+
+/******************************************************************************
+* Author: Savoy Schuler and Daniel Hodgin
+*
+* Function: RegisterTexture
+*
+* Description:
+*
+*   This function records the texture map of a body. A file already
+*   registered for another body is loaded only once and shared. Nothing is
+*   read until the body is drawn. Texture maps tiled in the pack go to the
+*   virtual texture cache instead.
+*
+* Parameters:
+*
+*   filename    - .bmp texture map
+*
+*   body        - row of the body in the table
+*
+******************************************************************************/
+void RegisterTexture( const char *filename, int body )
+{
+    if ( RegisterVirtualTexture( filename, body ) )
+        return;
+
+    unordered_map<string, int>::iterator texture = TextureFiles.find( filename );
+
+    if ( texture == TextureFiles.end() )
+    {
+        TextureEntry entry;
+        entry.Filename = filename;
+        entry.State = TextureUnloaded;
+        entry.Rows = entry.Cols = 0;
+        entry.Image = NULL;
+        entry.Mipmaps = NULL;
+        entry.Cell = -1;
+        entry.Bytes = 0;
+        entry.LastDrawn = 0;
+        entry.Packed = FindPackedTexture( filename, entry.Levels );
+
+        texture = TextureFiles.insert( make_pair( entry.Filename,
+                                                  Textures.size() ) ).first;
+        Textures.push_back( entry );
+    }
+
+    if ( ( int ) BodyTextures.size() <= body )
+        BodyTextures.resize( body + 1, -1 );
+
+    BodyTextures[body] = texture->second;
+    Textures[texture->second].Bodies.push_back( body );
+}
+
+
+
+/******************************************************************************
+* Author: Savoy Schuler and Daniel Hodgin
+*
+* Function: RequestTexture
+*
+* Description:
+*
+*   This function is called for each body drawn with texture mapping on. It
+*   marks the body's texture map as drawn in this frame, and if it is not in
+*   memory hands it to the workers to be decoded, or straight to UploadAssets
+*   if it is in the texture pack.
+*
+* Parameters:
+*
+*   body    - row of the body in the table
+*
+******************************************************************************/
+void RequestTexture( int body )
+{
+    if ( body >= ( int ) BodyTextures.size() || BodyTextures[body] < 0 )
+        return;
+
+    int index = BodyTextures[body];
+    TextureEntry &texture = Textures[index];
+
+    texture.LastDrawn = Frame;
+
+    //Move a resident texture to the front of the list.
+    if ( texture.State == TextureResident )
+    {
+        Resident.splice( Resident.begin(), Resident, texture.Place );
+        return;
+    }
+
+    if ( texture.State == TextureLoading )
+        return;
+
+    texture.State = TextureLoading;
+    Loading++;
+
+    //Nothing to decode.
+    if ( texture.Packed )
+    {
+        lock_guard<mutex> lock( LoaderMutex );
+        Finished.push_back( index );
+        return;
+    }
+
+    {
+        lock_guard<mutex> lock( LoaderMutex );
+        Requests.push_back( index );
+    }
+    LoaderSignal.notify_one();
+}
+
+
+
+/******************************************************************************
+* Author: Savoy Schuler and Daniel Hodgin
+*
+* Function: RequestSkybox
+*
+* Description:
+*
+*   This function is called by DrawSkybox the first time a backdrop is
+*   drawn. Its cube map is handed to the workers to be read or made, or
+*   straight to UploadAssets if its faces are in the texture pack.
+*
+* Parameters:
+*
+*   body    - row of the backdrop in the table
+*
+*   packed  - true if its faces are in the texture pack
+*
+******************************************************************************/
+void RequestSkybox( int body, bool packed )
+{
+    Loading++;
+
+    //Nothing to read.
+    if ( packed )
+    {
+        lock_guard<mutex> lock( LoaderMutex );
+        SkyboxesFinished.push_back( body );
+        return;
+    }
+
+    {
+        lock_guard<mutex> lock( LoaderMutex );
+        SkyboxRequests.push_back( body );
+    }
+    LoaderSignal.notify_one();
+}
+
+
+
+/******************************************************************************
+* Author: Savoy Schuler and Daniel Hodgin
+*
+* Function: StartAssetLoader
+*
+* Description:
+*
+*   This function starts one worker per core to decode texture maps as they
+*   are requested. The workers are stopped when the program exits.
+*
+* Parameters:
+*
+*		void	- No input parameters needed.
+*
+******************************************************************************/
+void StartAssetLoader()
+{
+    unsigned count = thread::hardware_concurrency();
+
+    if ( count == 0 )
+        count = 1;
+
+    for ( unsigned i = 0; i < count; i++ )
+        Workers.push_back( thread( AssetWorker ) );
+
+    atexit( StopAssetLoader );
+}
+
+
+
+/******************************************************************************
+* Author: Savoy Schuler and Daniel Hodgin
+*
+* Function: StopAssetLoader
+*
+* Description:
+*
+*   This function ends the worker threads and waits for them to finish.
+*   Requests not started yet are dropped.
+*
+* Parameters:
+*
+*		void	- No input parameters needed.
+*
+******************************************************************************/
+void StopAssetLoader()
+{
+    {
+        lock_guard<mutex> lock( LoaderMutex );
+        Quit = true;
+        Requests.clear();
+        SkyboxRequests.clear();
+    }
+    LoaderSignal.notify_all();
+
+    for ( unsigned i = 0; i < Workers.size(); i++ )
+        Workers[i].join();
+
+    Workers.clear();
+}
+
+
+
+/******************************************************************************
+* Author: Savoy Schuler and Daniel Hodgin
+*
+* Function: AssetWorker
+*
+* Description:
+*
+*   Each worker thread sleeps until a texture map is requested, decodes it,
+*   builds its mipmaps and adds it to the finished list, until the program
+*   exits. Skyboxes requested are loaded by LoadSkybox first, and go on a
+*   finished list of their own.
+*
+* Parameters:
+*
+*		void	- No input parameters needed.
+*
+******************************************************************************/
+static void AssetWorker()
+{
+    unique_lock<mutex> lock( LoaderMutex );
+
+    while ( true )
+    {
+        while ( !Quit && Requests.empty() && SkyboxRequests.empty() )
+            LoaderSignal.wait( lock );
+
+        if ( Quit )
+            return;
+
+        if ( !SkyboxRequests.empty() )
+        {
+            int body = SkyboxRequests.front();
+            SkyboxRequests.pop_front();
+
+            lock.unlock();
+            LoadSkybox( body );
+            lock.lock();
+
+            SkyboxesFinished.push_back( body );
+            continue;
+        }
+
+        int index = Requests.front();
+        Requests.pop_front();
+
+        //Decode without holding the lock.
+        lock.unlock();
+
+        TextureEntry &texture = Textures[index];
+
+        if ( LoadBmpFile( texture.Filename.c_str(), texture.Rows,
+                          texture.Cols, texture.Image ) )
+        {
+            texture.Mipmaps = BuildMipmaps( texture.Image, texture.Cols,
+                                            texture.Rows, texture.Levels );
+        }
+        else
+        {
+            texture.Rows = texture.Cols = 0;
+            texture.Image = NULL;
+        }
+
+        lock.lock();
+        Finished.push_back( index );
+    }
+}
+
+
+
+/******************************************************************************
+* Author: Savoy Schuler and Daniel Hodgin
+*
+* Function: UploadAssets
+*
+* Description:
+*
+*   This function is called by the GLUT thread at the start of each frame.
+*   The levels of each texture map decoded since the last call, or found in
+*   the texture pack, are uploaded to one texture object shared by every
+*   body using it, and the decoded image and its mipmaps are freed. Skyboxes
+*   loaded are handed to UploadSkybox. Textures are then evicted to stay
+*   within the budget, and tiles of virtual textures uploaded. Returns true
+*   if any body's texture changed.
+*
+* Parameters:
+*
+*		void	- No input parameters needed.
+*
+******************************************************************************/
+bool UploadAssets()
+{
+    vector<int> ready, skyboxes;
+
+    {
+        lock_guard<mutex> lock( LoaderMutex );
+        ready.swap( Finished );
+        skyboxes.swap( SkyboxesFinished );
+    }
+
+    for ( unsigned i = 0; i < skyboxes.size(); i++ )
+    {
+        UploadSkybox( skyboxes[i] );
+        Loading--;
+    }
+
+    for ( unsigned i = 0; i < ready.size(); i++ )
+    {
+        TextureEntry &texture = Textures[ready[i]];
+        int first = texture.Bodies[0];
+        bool loaded = texture.Packed || texture.Image != NULL;
+
+        //Upload once, then share the texture object and window.
+        texture.Cell = loaded ? CreateTextureLevels( first, texture.Levels ) : -1;
+
+        for ( unsigned j = 0; j < texture.Bodies.size(); j++ )
+        {
+            int body = texture.Bodies[j];
+
+            Bodies.Rows[body] = loaded ? texture.Levels.Rows : 0;
+            Bodies.Cols[body] = loaded ? texture.Levels.Cols : 0;
+            Bodies.Texture[body] = Bodies.Texture[first];
+            Bodies.Window[body] = Bodies.Window[first];
+        }
+
+        //OpenGL has its own copy now.
+        delete [] texture.Image;
+        delete [] texture.Mipmaps;
+        texture.Image = texture.Mipmaps = NULL;
+
+        //Count 4 bytes a texel, and a third more for the mipmaps of a
+        //texture object of its own.
+        texture.Bytes = loaded ? ( size_t ) texture.Levels.Rows *
+                        texture.Levels.Cols * 4 : 0;
+        if ( texture.Cell < 0 )
+            texture.Bytes = texture.Bytes * 4 / 3;
+        texture.State = TextureResident;
+        texture.Place = Resident.insert( Resident.begin(), ready[i] );
+        ResidentBytes += texture.Bytes;
+        Loading--;
+    }
+
+    EvictTextures();
+    Frame++;
+
+    bool tiles = UploadTiles();
+
+    return !ready.empty() || !skyboxes.empty() || tiles;
+}
+
+
+
+/******************************************************************************
+* Author: Savoy Schuler and Daniel Hodgin
+*
+* Function: EvictTextures
+*
+* Description:
+*
+*   This function deletes the least recently drawn textures until the rest
+*   fit within TextureBudget. Textures drawn in the last frame are kept even
+*   when over budget, so what is on screen does not flicker.
+*
+* Parameters:
+*
+*		void	- No input parameters needed.
+*
+******************************************************************************/
+static void EvictTextures()
+{
+    while ( ResidentBytes > TextureBudget && !Resident.empty() )
+    {
+        int index = Resident.back();
+        TextureEntry &texture = Textures[index];
+
+        //Drawn in the frame just finished.
+        if ( texture.LastDrawn == Frame )
+            return;
+
+        DeleteTexture( texture.Bodies[0], texture.Cell );
+        texture.Cell = -1;
+
+        for ( unsigned j = 0; j < texture.Bodies.size(); j++ )
+        {
+            Bodies.Texture[texture.Bodies[j]] = 0;
+            Bodies.Window[texture.Bodies[j]] = WholeTexture;
+        }
+
+        Resident.pop_back();
+        ResidentBytes -= texture.Bytes;
+        texture.State = TextureUnloaded;
+    }
+}
+
+
+
+/******************************************************************************
+* Author: Savoy Schuler and Daniel Hodgin
+*
+* Function: AssetsPending
+*
+* Description:
+*
+*   Returns true while any requested texture map, skybox or tile has not
+*   been uploaded yet.
+*
+* Parameters:
+*
+*		void	- No input parameters needed.
+*
+******************************************************************************/
+bool AssetsPending()
+{
+    return TexturesLoading() || TilesPending();
+}
+
+
+
+/******************************************************************************
+* Author: Savoy Schuler and Daniel Hodgin
+*
+* Function: AssetsReady
+*
+* Description:
+*
+*   Returns true if a texture map has been decoded, a skybox loaded, or a
+*   tile read, and is waiting for UploadAssets.
+*
+* Parameters:
+*
+*		void	- No input parameters needed.
+*
+******************************************************************************/
+bool AssetsReady()
+{
+    {
+        lock_guard<mutex> lock( LoaderMutex );
+
+        if ( !Finished.empty() || !SkyboxesFinished.empty() )
+            return true;
+    }
+
+    return TilesReady();
+}
+
+
+
+/******************************************************************************
+* Author: Savoy Schuler and Daniel Hodgin
+*
+* Function: TexturesLoading
+*
+* Description:
+*
+*   Returns true while any requested texture map or skybox is still being
+*   loaded. Unlike tiles, these always arrive: one that can not be read is
+*   handed back without an image.
+*
+* Parameters:
+*
+*		void	- No input parameters needed.
+*
+******************************************************************************/
+bool TexturesLoading()
+{
+    return Loading > 0;
+}
+
+
+
+/******************************************************************************
+* Author: Savoy Schuler and Daniel Hodgin
+*
+* Function: PrefetchAssets
+*
+* Description:
+*
+*   This function asks again for whatever is still on its way that may have
+*   been lost: the pages of requested tiles, which the kernel may drop
+*   before UploadTiles reads them. Called while waiting for assets.
+*
+* Parameters:
+*
+*		void	- No input parameters needed.
+*
+******************************************************************************/
+void PrefetchAssets()
+{
+    PrefetchTiles();
+}
+
+
+
+/******************************************************************************
+* Author: Savoy Schuler and Daniel Hodgin
+*
+* Function: ResidentTextures
+*
+* Description:
+*
+*   Returns the number of textures uploaded to texture objects.
+*
+* Parameters:
+*
+*		void	- No input parameters needed.
+*
+******************************************************************************/
+int ResidentTextures()
+{
+    return Resident.size();
+}
+
+
+
+/******************************************************************************
+* Author: Savoy Schuler and Daniel Hodgin
+*
+* Function: ResidentTextureBytes
+*
+* Description:
+*
+*   Returns the bytes taken by textures uploaded to texture objects.
+*
+* Parameters:
+*
+*		void	- No input parameters needed.
+*
+******************************************************************************/
+size_t ResidentTextureBytes()
+{
+    return ResidentBytes;
+}
@@ -0,0 +1,346 @@
+/******************************************************************************
+*	File: atlas.cpp
+*
+*	Authors: Savoy Schuler and Daniel Hodgin
+*
+*	Date: 11-17-16
+*
+*	Description:
+*
+*		This file contains the texture atlas: one texture object, AtlasSize
+*       texels square, shared by the texture maps of every body. Bodies drawn
+*       from the atlas all bind the same texture object, so drawing one after
+*       another needs no texture binds; each body instead carries the window
+*       of the atlas holding its texture map, which is loaded into the texture
+*       matrix before it is drawn (see SetTextureWindow).
+*
+*       Texture maps are already a power of two on each side, so the atlas is
+*       handed out as a binary tree of cells: a free cell too big for a map
+*       is halved across the side with more room to spare until it fits, and
+*       a freed cell is joined back with its other half once both are free.
+*       Texture maps larger than AtlasLargest, or that no longer fit, get
+*       their own texture object instead.
+*
+*       Only the largest level of each map is kept, drawn with GL_LINEAR
+*       filtering, as the smaller levels of neighbouring cells would blend
+*       into each other; the maps are small, so seldom drawn much smaller
+*       than they are. Windows are inset by half a texel on each side, so
+*       filtering never reaches into the neighbouring cells.
+*
+*	File Order and Structure:
+*
+*       - Place texture maps.
+*       - Atlas cells.
+*
+*	Modified:
+*
+*		Original
+*
+*	Functions Included:
+*
+*           //Place texture maps.
+*
+*       int AddToAtlas( const TextureLevels &levels, TextureWindow &window );
+*       void RemoveFromAtlas( int cell );
+*       GLuint AtlasTexture();
+*
+*           //Atlas cells.
+*
+*       static int AllocateCell( int cell, int cols, int rows );
+*       static int NewCells( int parent, int cols, int rows );
+*
+******************************************************************************/
+
+/**************************** Library Includes *******************************/
+#include <cstdlib>
+#include <GL/freeglut.h>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "Planet.h"
+#include "globals.h"
+
+/******************************* Name Space **********************************/
+
+using namespace std;
+
+/******************************** Type Def ***********************************/
+
+//A rectangle of the atlas, either split in two or a single cell.
+struct AtlasCell
+{
+    int X, Y;           //corner of the cell in texels
+    int Cols, Rows;     //size of the cell in texels
+    int Parent;         //cell it was split from, -1 for the whole atlas
+    int Child;          //first of the two halves it is split into, or -1
+    bool Used;          //holds a texture map
+};
+
+/******************************* Constants **********************************/
+
+//Texels on each side of the atlas (4 bytes a texel, 16 MB).
+static const int AtlasSize = 2048;
+
+//Largest side of a texture map placed in the atlas.
+static const int AtlasLargest = 1024;
+
+/********************************* Globals ***********************************/
+
+//The atlas texture object, 0 until first used.
+static GLuint Atlas = 0;
+
+//Set if OpenGL can not make a texture as large as the atlas.
+static bool AtlasUnavailable = false;
+
+//Every cell, the whole atlas first. Halves are stored side by side.
+static vector<AtlasCell> Cells;
+
+//First halves of pairs of cells no longer used, to be reused.
+static vector<int> FreeCells;
+
+/*************************** Function Prototypes *****************************/
+
+static int AllocateCell( int cell, int cols, int rows );
+static int NewCells( int parent, int cols, int rows );
+
+
+
+/******************************************************************************
+* Author: Savoy Schuler and Daniel Hodgin
+*
+* Function: AddToAtlas
+*
+* Description:
+*
+*   This function copies the largest level of a texture map into a free cell
+*   of the atlas, creating the atlas the first time. Returns the cell and
+*   the window of the atlas holding the map, or -1 if the map is too large
+*   or no cell is free.
+*
+* Parameters:
+*
+*   levels  - the texture map's levels, built by BuildMipmaps or the packer
+*
+*   window  - returned window of the atlas holding the texture map
+*
+******************************************************************************/
+int AddToAtlas( const TextureLevels &levels, TextureWindow &window )
+{
+    if ( AtlasUnavailable || levels.Cols > AtlasLargest ||
+            levels.Rows > AtlasLargest )
+        return -1;
+
+    //Create the atlas, empty, the first time.
+    if ( Atlas == 0 )
+    {
+        GLint maxSize;
+        glGetIntegerv( GL_MAX_TEXTURE_SIZE, &maxSize );
+
+        if ( maxSize < AtlasSize )
+        {
+            AtlasUnavailable = true;
+            return -1;
+        }
+
+        glGenTextures( 1, &Atlas );
+        BindTexture( Atlas );
+
+        glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE );
+        glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE );
+        glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR );
+        glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR );
+        glTexImage2D( GL_TEXTURE_2D, 0, GL_RGB, AtlasSize, AtlasSize, 0, GL_RGB,
+                      GL_UNSIGNED_BYTE, NULL );
+
+        AtlasCell whole = { 0, 0, AtlasSize, AtlasSize, -1, -1, false };
+        Cells.push_back( whole );
+    }
+
+    int cell = AllocateCell( 0, levels.Cols, levels.Rows );
+    if ( cell < 0 )
+        return -1;
+
+    const AtlasCell &place = Cells[cell];
+
+    //Copy the largest level in, rows padded to 4 bytes.
+    BindTexture( Atlas );
+    glPixelStorei( GL_UNPACK_ALIGNMENT, 4 );
+    glTexSubImage2D( GL_TEXTURE_2D, 0, place.X, place.Y, place.Cols, place.Rows,
+                     GL_RGB, GL_UNSIGNED_BYTE, levels.Level[0] );
+
+    //Map texture coordinates 0 and 1 to the centers of the edge texels.
+    window.Scale[0] = ( place.Cols - 1.0 ) / AtlasSize;
+    window.Scale[1] = ( place.Rows - 1.0 ) / AtlasSize;
+    window.Offset[0] = ( place.X + 0.5 ) / AtlasSize;
+    window.Offset[1] = ( place.Y + 0.5 ) / AtlasSize;
+
+    return cell;
+}
+
+
+
+/******************************************************************************
+* Author: Savoy Schuler and Daniel Hodgin
+*
+* Function: RemoveFromAtlas
+*
+* Description:
+*
+*   This function frees a cell of the atlas. Halves that are both free are
+*   joined back into the cell they were split from, all the way up.
+*
+* Parameters:
+*
+*   cell    - cell returned by AddToAtlas
+*
+******************************************************************************/
+void RemoveFromAtlas( int cell )
+{
+    Cells[cell].Used = false;
+
+    int parent = Cells[cell].Parent;
+
+    while ( parent >= 0 )
+    {
+        int first = Cells[parent].Child;
+        const AtlasCell &a = Cells[first];
+        const AtlasCell &b = Cells[first + 1];
+
+        if ( a.Used || b.Used || a.Child >= 0 || b.Child >= 0 )
+            return;
+
+        FreeCells.push_back( first );
+        Cells[parent].Child = -1;
+        parent = Cells[parent].Parent;
+    }
+}
+
+
+
+/******************************************************************************
+* Author: Savoy Schuler and Daniel Hodgin
+*
+* Function: AtlasTexture
+*
+* Description:
+*
+*   Returns the atlas texture object, 0 if it has not been created.
+*
+* Parameters:
+*
+*		void	- No input parameters needed.
+*
+******************************************************************************/
+GLuint AtlasTexture()
+{
+    return Atlas;
+}
+
+
+
+/******************************************************************************
+* Author: Savoy Schuler and Daniel Hodgin
+*
+* Function: AllocateCell
+*
+* Description:
+*
+*   This function finds a free cell of exactly the size asked for within a
+*   cell, splitting free cells that are larger. Returns the cell, now used,
+*   or -1 if there is no room.
+*
+* Parameters:
+*
+*   cell    - cell to look in
+*
+*   cols    - columns wanted, a power of two
+*
+*   rows    - rows wanted, a power of two
+*
+******************************************************************************/
+static int AllocateCell( int cell, int cols, int rows )
+{
+    if ( Cells[cell].Used || Cells[cell].Cols < cols || Cells[cell].Rows < rows )
+        return -1;
+
+    //Look in each half of a split cell.
+    if ( Cells[cell].Child >= 0 )
+    {
+        int first = Cells[cell].Child;
+        int found = AllocateCell( first, cols, rows );
+
+        return found >= 0 ? found : AllocateCell( first + 1, cols, rows );
+    }
+
+    if ( Cells[cell].Cols == cols && Cells[cell].Rows == rows )
+    {
+        Cells[cell].Used = true;
+        return cell;
+    }
+
+    //Too big: split it and use its first half.
+    int first = NewCells( cell, cols, rows );
+
+    return AllocateCell( first, cols, rows );
+}
+
+
+
+/******************************************************************************
+* Author: Savoy Schuler and Daniel Hodgin
+*
+* Function: NewCells
+*
+* Description:
+*
+*   This function splits a free cell in half, across the side with more
+*   room to spare for the size wanted. Returns the first half.
+*
+* Parameters:
+*
+*   parent  - cell to split
+*
+*   cols    - columns wanted
+*
+*   rows    - rows wanted
+*
+******************************************************************************/
+static int NewCells( int parent, int cols, int rows )
+{
+    int first;
+
+    if ( !FreeCells.empty() )
+    {
+        first = FreeCells.back();
+        FreeCells.pop_back();
+    }
+    else
+    {
+        first = Cells.size();
+        Cells.resize( Cells.size() + 2 );
+    }
+
+    AtlasCell a = Cells[parent];
+    a.Parent = parent;
+    a.Child = -1;
+    a.Used = false;
+
+    AtlasCell b = a;
+
+    if ( a.Cols / cols >= a.Rows / rows )
+    {
+        a.Cols = b.Cols = a.Cols / 2;
+        b.X += a.Cols;
+    }
+    else
+    {
+        a.Rows = b.Rows = a.Rows / 2;
+        b.Y += a.Rows;
+    }
+
+    Cells[first] = a;
+    Cells[first + 1] = b;
+    Cells[parent].Child = first;
+
+    return first;
+}
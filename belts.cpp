@@ -0,0 +1,524 @@
+/******************************************************************************
+*	File: belts.cpp
+*
+*	Authors: Savoy Schuler and Daniel Hodgin
+*
+*	Date: 11-17-16
+*
+*	Description:
+*
+*		This file contains the belts: swarms of small bodies, like the
+*       asteroid belt and the Kuiper belt, circling the sun in thousands. A
+*       belt is one row of the body table, read from the catalog with the
+*       number of its members and the width of the band they fill. Its
+*       members are far too many to be bodies of their own, each with a draw
+*       call, material and texture, so they are made up when the catalog is
+*       read and kept in a table of their own, one array per field like the
+*       body table, with the members of each belt together.
+*
+*       Each member circles the sun at its own distance and speed (by
+*       Kepler's third law, from the Earth's year), tilted a little out of the
+*       plane of the orbits. The simulation thread advances every member's
+*       orbit phase with the bodies' and publishes them in its snapshots.
+*
+*       Each frame DrawBelt fills a buffer with one BeltInstance per member in
+*       view: its place, its size, and a tint for its brightness. Members are
+*       sorted into levels of detail by their size on screen, and the shader
+*       renderer draws all members of a level with one instanced call of the
+*       sphere mesh, lit with the belt's material (see shaders.cpp). Members
+*       are at least MemberPixelRadius in size on screen, so a distant belt
+*       still shows. Members under ImpostorPixels in size are drawn first, all
+*       as impostors in one call. Belts are drawn this way whenever OpenGL can
+*       run the shaders, with or without -shaders. Without them, or without
+*       instanced arrays, every member is drawn as a point instead, all in one
+*       call; which way is picked once per belt, before any of it is drawn.
+*
+*	File Order and Structure:
+*
+*       - Build belts.
+*       - Update belts.
+*       - Draw belts.
+*
+*	Modified:
+*
+*		Original
+*
+*	Functions Included:
+*
+*           //Build belts.
+*
+*       void AddBelt( int belt, int members, float width );
+*       static float NextRandom( unsigned &seed );
+*
+*           //Update belts.
+*
+*       void UpdateBelts( BodyPhases &phases, float hours );
+*       static void UpdateMemberPhases( ... );
+*
+*           //Draw belts.
+*
+*       void DrawBelt( int belt );
+*       static int PlaceMembers( const BeltRange &range );
+*       static void DrawMemberPoints( int belt, int count );
+*
+******************************************************************************/
+
+/**************************** Library Includes *******************************/
+#define GL_GLEXT_PROTOTYPES
+#include <cstddef>
+#include <cstdlib>
+#include <cmath>
+#include <GL/freeglut.h>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+#include "Planet.h"
+#include "globals.h"
+
+/******************************* Name Space **********************************/
+
+using namespace std;
+
+/******************************** Type Def ***********************************/
+
+//Every belt member, one row per member and one array per field.
+struct MemberTable
+{
+    vector<float> Distance;     //orbit radius as drawn
+    vector<float> HeightCos;    //greatest height above the plane of the
+    vector<float> HeightSin;    //orbits, times the cosine and sine of where
+                                //in its orbit the member rises through it
+    vector<float> Radius;       //radius as drawn
+    vector<float> Tint;         //brightness relative to the belt's color
+    vector<float> OrbitRate;    //orbit turns per Earth hour
+};
+
+//Members of one belt in the member table.
+struct BeltRange
+{
+    int First;      //first member
+    int Count;      //number of members
+};
+
+/******************************* Constants **********************************/
+
+//The Earth's year in hours and its distance from the sun in millions of km,
+//which every member's period is worked out from.
+static const float EarthYear = 365.0 * 24.0;
+static const float EarthDistance = 150.0;
+
+//Tilt of the most tilted member's orbit, in radians.
+static const float MaxInclination = 0.17;
+
+//Smallest member's radius, as a fraction of the belt's largest.
+static const float SmallestMember = 0.05;
+
+//Smallest radius, in pixels, members are drawn with.
+static const float MemberPixelRadius = 0.75;
+
+//Level given to members outside the view.
+static const unsigned char MemberCulled = 255;
+
+/********************************* Globals ***********************************/
+
+//Every belt member.
+static MemberTable Members;
+
+//Members of each belt, keyed by the row of the belt in the body table.
+static map<int, BeltRange> BeltRanges;
+
+//Members in view this frame, in the order found, then sorted by level.
+static vector<BeltInstance> FoundMembers;
+static vector<unsigned char> FoundLevels;
+static vector<BeltInstance> Instances;
+
+//First member of the impostors, then of each level, in Instances, and
+//one past the last.
+static vector<int> LevelFirst;
+
+//Buffer object the instances are uploaded to, 0 until first drawn.
+static GLuint InstanceBuffer = 0;
+
+/*************************** Function Prototypes *****************************/
+
+static float NextRandom( unsigned &seed );
+static void UpdateMemberPhases( int count, float hours,
+                                const float *__restrict orbitRate,
+                                float *__restrict prevOrbit,
+                                float *__restrict orbit );
+static int PlaceMembers( const BeltRange &range );
+static void DrawMemberPoints( int belt, int count );
+
+
+
+/******************************************************************************
+* Author: Savoy Schuler and Daniel Hodgin
+*
+* Function: AddBelt
+*
+* Description:
+*
+*   This function makes up the members of a belt already in the body table.
+*   They are spread across the band from the belt's distance outward by
+*   width, thickest in the middle, at random places in their orbits. Their
+*   radii run from SmallestMember of the belt's radius up to all of it,
+*   mostly small. The same belt always gets the same members. This must be
+*   called before the simulation starts.
+*
+* Parameters:
+*
+*   belt    - row of the belt in the body table
+*
+*   members - number of members to make
+*
+*   width   - width of the band, in millions of km
+*
+******************************************************************************/
+void AddBelt( int belt, int members, float width )
+{
+    BeltRange range;
+    range.First = Members.Distance.size();
+    range.Count = members;
+
+    unsigned seed = 2166136261u ^ ( belt * 16777619u );
+    float largest = Bodies.Radius[belt] * SizeScale;
+
+    for ( int i = 0; i < members; i++ )
+    {
+        //Distance from the sun, in millions of km and as drawn (as
+        //GetOrbitRadius).
+        float across = ( NextRandom( seed ) + NextRandom( seed ) ) / 2.0;
+        float distance = Bodies.Distance[belt] + width * across;
+        float drawn = distance * DistScale + 69600 * SizeScale;
+
+        //Tilt of the orbit, and where it rises through the plane.
+        float height = drawn * sin( MaxInclination * NextRandom( seed ) );
+        float node = 2.0 * PI * NextRandom( seed );
+
+        float size = NextRandom( seed );
+        size = size * size * size * size;
+
+        Members.Distance.push_back( drawn );
+        Members.HeightCos.push_back( height * cos( node ) );
+        Members.HeightSin.push_back( height * sin( node ) );
+        Members.Radius.push_back( largest * ( SmallestMember +
+                                              ( 1.0 - SmallestMember ) * size ) );
+        Members.Tint.push_back( 0.6 + 0.4 * NextRandom( seed ) );
+        Members.OrbitRate.push_back( 1.0 / ( EarthYear *
+                                             pow( distance / EarthDistance, 1.5 ) ) );
+
+        float phase = NextRandom( seed );
+        Bodies.Phases.PrevMember.push_back( phase );
+        Bodies.Phases.Member.push_back( phase );
+    }
+
+    BeltRanges[belt] = range;
+}
+
+
+
+/******************************************************************************
+* Author: Savoy Schuler and Daniel Hodgin
+*
+* Function: NextRandom
+*
+* Description:
+*
+*   Returns the next of a repeatable series of random numbers from 0 up to
+*   1, advancing the seed (xorshift).
+*
+* Parameters:
+*
+*   seed    - state of the series, changed
+*
+******************************************************************************/
+static float NextRandom( unsigned &seed )
+{
+    seed ^= seed << 13;
+    seed ^= seed >> 17;
+    seed ^= seed << 5;
+
+    return ( seed >> 8 ) / 16777216.0;
+}
+
+
+
+/******************************************************************************
+* Author: Savoy Schuler and Daniel Hodgin
+*
+* Function: UpdateBelts
+*
+* Description:
+*
+*   This function advances the orbit phase of every belt member by one
+*   animation time step, wrapping the phase being left as UpdateBodies does.
+*   It is called by UpdateBodies on the simulation thread.
+*
+* Parameters:
+*
+*   phases  - phases to advance, one per member in the member table
+*
+*   hours   - animation time step in Earth hours
+*
+******************************************************************************/
+void UpdateBelts( BodyPhases &phases, float hours )
+{
+    if ( phases.Member.empty() )
+        return;
+
+    UpdateMemberPhases( phases.Member.size(), hours, &Members.OrbitRate[0],
+                        &phases.PrevMember[0], &phases.Member[0] );
+}
+
+
+
+/******************************************************************************
+* Author: Savoy Schuler and Daniel Hodgin
+*
+* Function: UpdateMemberPhases
+*
+* Description:
+*
+*   This is the loop behind UpdateBelts. The arrays are passed separately
+*   and marked as not overlapping so the loop can be vectorized.
+*
+* Parameters:
+*
+*   count       - number of members
+*
+*   hours       - animation time step in Earth hours
+*
+*   orbitRate   - the member table's orbit rates
+*
+*   prevOrbit, orbit    - phases to advance
+*
+******************************************************************************/
+static void UpdateMemberPhases( int count, float hours,
+                                const float *__restrict orbitRate,
+                                float *__restrict prevOrbit,
+                                float *__restrict orbit )
+{
+    for ( int i = 0; i < count; i++ )
+    {
+        prevOrbit[i] = orbit[i] - ( int ) orbit[i];
+        orbit[i] = prevOrbit[i] + hours * orbitRate[i];
+    }
+}
+
+
+
+/******************************************************************************
+* Author: Savoy Schuler and Daniel Hodgin
+*
+* Function: DrawBelt
+*
+* Description:
+*
+*   This function draws the members of a belt that are in view. They are
+*   placed and sorted into levels of detail, uploaded to the instance buffer
+*   in one piece, and the impostors drawn with one call, then each run of
+*   levels drawn at the same resolution with one instanced call. If the
+*   shader renderer can not draw them, they are all drawn as points
+*   instead.
+*
+* Parameters:
+*
+*   belt    - row of the belt in the body table
+*
+******************************************************************************/
+void DrawBelt( int belt )
+{
+    map<int, BeltRange>::iterator found = BeltRanges.find( belt );
+    if ( found == BeltRanges.end() )
+        return;
+
+    int count = PlaceMembers( found->second );
+    if ( count == 0 )
+        return;
+
+    FrameStats.MembersDrawn += count;
+
+    //Upload every member in view at once.
+    if ( InstanceBuffer == 0 )
+        glGenBuffers( 1, &InstanceBuffer );
+
+    glBindBuffer( GL_ARRAY_BUFFER, InstanceBuffer );
+    glBufferData( GL_ARRAY_BUFFER, count * sizeof( BeltInstance ),
+                  &Instances[0], GL_STREAM_DRAW );
+    glBindBuffer( GL_ARRAY_BUFFER, 0 );
+
+    //Without the shader renderer every member is a point.
+    if ( !MembersShaded( belt ) )
+    {
+        DrawMemberPoints( belt, count );
+        return;
+    }
+
+    //Draw the members small enough for impostors together.
+    int impostors = LevelFirst[1] - LevelFirst[0];
+
+    if ( impostors > 0 )
+    {
+        DrawShadedImpostors( belt, InstanceBuffer, LevelFirst[0], impostors );
+        FrameStats.BeltDraws++;
+    }
+
+    //Draw the members of each resolution together.
+    int levels = LevelFirst.size() - 2;
+
+    for ( int level = 0; level < levels; )
+    {
+        int resolution = LodResolution( level );
+        int last = level + 1;
+
+        while ( last < levels && LodResolution( last ) == resolution )
+            last++;
+
+        int first = LevelFirst[level + 1];
+        int members = LevelFirst[last + 1] - first;
+
+        if ( members > 0 )
+        {
+            DrawShadedMembers( belt, InstanceBuffer, first, members,
+                               resolution );
+            FrameStats.BeltDraws++;
+        }
+
+        level = last;
+    }
+}
+
+
+
+/******************************************************************************
+* Author: Savoy Schuler and Daniel Hodgin
+*
+* Function: PlaceMembers
+*
+* Description:
+*
+*   This function finds where each member of a belt is in this frame,
+*   FrameBlend of the way from the previous simulation step, skips those
+*   outside the view and picks a level of detail for the rest. Members too
+*   small on screen are grown to MemberPixelRadius. The members in view are
+*   then sorted into Instances, impostors first and the rest by level, with
+*   LevelFirst marking where each starts. Returns the number of members in
+*   view.
+*
+* Parameters:
+*
+*   range   - members of the belt
+*
+******************************************************************************/
+static int PlaceMembers( const BeltRange &range )
+{
+    FoundMembers.resize( range.Count );
+    FoundLevels.resize( range.Count );
+    LevelFirst.assign( LodLevelCount() + 2, 0 );
+
+    const BodyPhases &phases = Bodies.Phases;
+    int count = 0;
+
+    for ( int i = 0; i < range.Count; i++ )
+    {
+        int member = range.First + i;
+        BeltInstance &instance = FoundMembers[i];
+
+        float previous = phases.PrevMember[member];
+        float phase = previous + ( phases.Member[member] - previous ) * FrameBlend;
+        float angle = 2.0 * PI * phase;
+        float c = cos( angle ), s = sin( angle );
+
+        instance.Position[0] = Members.Distance[member] * c;
+        instance.Position[1] = Members.Distance[member] * s;
+        instance.Position[2] = Members.HeightCos[member] * s -
+                               Members.HeightSin[member] * c;
+        instance.Radius = Members.Radius[member];
+
+        if ( !SphereInView( instance.Position, instance.Radius ) )
+        {
+            FoundLevels[i] = MemberCulled;
+            FrameStats.MembersCulled++;
+            continue;
+        }
+
+        //Grow members too small to show.
+        float pixelRadius = ProjectedRadius( instance.Position, instance.Radius );
+        if ( pixelRadius < MemberPixelRadius )
+        {
+            instance.Radius *= MemberPixelRadius / pixelRadius;
+            pixelRadius = MemberPixelRadius;
+        }
+
+        float tint = Members.Tint[member];
+        instance.Tint[0] = instance.Tint[1] = instance.Tint[2] = tint;
+        instance.Tint[3] = 1.0;
+
+        //Impostors sort before the lowest level.
+        int level = 0;
+        if ( !ImpostorSized( pixelRadius ) )
+            level = LodLevel( pixelRadius ) + 1;
+
+        FoundLevels[i] = level;
+        LevelFirst[level + 1]++;
+        count++;
+    }
+
+    //Sort the members in view, impostors first, then by level.
+    for ( unsigned level = 1; level < LevelFirst.size(); level++ )
+        LevelFirst[level] += LevelFirst[level - 1];
+
+    vector<int> next( LevelFirst.begin(), LevelFirst.end() - 1 );
+    Instances.resize( count );
+
+    for ( int i = 0; i < range.Count; i++ )
+        if ( FoundLevels[i] != MemberCulled )
+            Instances[next[FoundLevels[i]]++] = FoundMembers[i];
+
+    return count;
+}
+
+
+
+/******************************************************************************
+* Author: Savoy Schuler and Daniel Hodgin
+*
+* Function: DrawMemberPoints
+*
+* Description:
+*
+*   This function draws the members in the instance buffer as points in the
+*   belt's color, with one call, for when the shader renderer can not draw
+*   them as spheres. Points are not lit or textured.
+*
+* Parameters:
+*
+*   belt    - row of the belt in the body table
+*
+*   count   - number of members in the instance buffer
+*
+******************************************************************************/
+static void DrawMemberPoints( int belt, int count )
+{
+    //Members are placed in solar system coordinates.
+    LoadViewMatrix();
+
+    SetCapability( GL_LIGHTING, false );
+    SetCapability( GL_TEXTURE_2D, false );
+    SetColor( Bodies.R[belt], Bodies.G[belt], Bodies.B[belt] );
+
+    glBindBuffer( GL_ARRAY_BUFFER, InstanceBuffer );
+    glEnableClientState( GL_VERTEX_ARRAY );
+    glVertexPointer( 3, GL_FLOAT, sizeof( BeltInstance ),
+                     ( GLvoid * ) offsetof( BeltInstance, Position ) );
+
+    glDrawArrays( GL_POINTS, 0, count );
+    FrameStats.BeltDraws++;
+
+    glDisableClientState( GL_VERTEX_ARRAY );
+    glBindBuffer( GL_ARRAY_BUFFER, 0 );
+
+    SetCapability( GL_TEXTURE_2D, textureToggle );
+    SetCapability( GL_LIGHTING, light );
+}
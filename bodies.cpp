@@ -0,0 +1,379 @@
+/******************************************************************************
+*	File: bodies.cpp
+*
+*	Authors: Savoy Schuler and Daniel Hodgin
+*
+*	Date: 11-17-16
+*
+*	Description:
+*
+*		This file contains the body table. Every celestial object read from
+*       the catalog (the space backdrop, the sun, the planets, the moon and
+*       Saturn's rings) is one row of the table, and each field is kept in its
+*       own contiguous array so that passes over all bodies touch only the
+*       fields they need. Bodies are referred to by their row number. The
+*       Planet class is a thin view of one row, kept for compatibility.
+*
+*       A body's place in its orbit and about its axis are kept as phases: the
+*       fraction of a full turn it has made, so no period needs to be looked
+*       up or divided by while drawing. Phases are advanced for all bodies at
+*       once by UpdatePhases, a single loop with no calls or branches over
+*       arrays that do not overlap, which the compiler vectorizes (at -O3).
+*
+*       The table is filled before the simulation starts and its size and
+*       periods do not change afterwards, so the simulation thread can read
+*       the rates while the GLUT thread draws.
+*
+*	File Order and Structure:
+*
+*       - Build the table.
+*       - Update phases.
+*       - Blended phases.
+*
+*	Modified:
+*
+*		Original
+*
+*	Functions Included:
+*
+*           //Build the table.
+*
+*       int AddBody( string name, int hours, int days, int radius,
+*                    int distance, int nrows, int ncols, byte* image,
+*                    GLfloat r, GLfloat g, GLfloat b, unsigned flags );
+*       void ReserveBodies( int count );
+*       int BodyCount();
+*
+*           //Update phases.
+*
+*       void UpdateBodies( BodyPhases &phases, float hours );
+*       static void UpdatePhases( ... );
+*       void ResetBodies( BodyPhases &phases );
+*
+*           //Blended phases.
+*
+*       float OrbitPhase( int body );
+*       float SpinPhase( int body );
+*
+******************************************************************************/
+
+/**************************** Library Includes *******************************/
+#include <cstdlib>
+#include <GL/freeglut.h>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "Planet.h"
+#include "globals.h"
+
+/******************************* Name Space **********************************/
+
+using namespace std;
+
+/********************************* Globals ***********************************/
+
+//Every celestial object, one row per body.
+BodyTable Bodies;
+
+/*************************** Function Prototypes *****************************/
+
+static void UpdatePhases( int count, float hours, float dayHours,
+                          const float *__restrict orbitRate,
+                          const float *__restrict spinRate,
+                          const unsigned *__restrict flags,
+                          float *__restrict prevOrbit, float *__restrict orbit,
+                          float *__restrict prevSpin, float *__restrict spin );
+
+
+
+/******************************************************************************
+* Author: Savoy Schuler and Daniel Hodgin
+*
+* Function: AddBody
+*
+* Description:
+*
+*   This function adds a body to the end of the table and returns its row.
+*   The periods, radius and distance are whole numbers, as they always were
+*   for planet objects. The orbit and spin rates are found once here, as
+*   turns per Earth hour; bodies without a period do not move. The body has
+*   no parent until it is set in the table.
+*
+* Parameters:
+*
+*		name	- body name
+*		hours	- body's hours in a day
+*		days	- body's days in a year
+*		radius	- body's raduis
+*		distance- body's distance from the suns surface
+*		nrows 	- number of rows in body's texture .bmp image
+*		ncols	- number of columns in body's texture .bmp image
+*		image	- pointer to location in memory of body's stored texture map
+*					read in from .bmp image
+*		r		- body's red value (used for color when no texture map)
+*		g		- body's green value (used for color when no texture map)
+*		b		- body's blue value (used for color when no texture map)
+*		flags	- BodyFlags describing the body
+*
+******************************************************************************/
+int AddBody( string name, int hours, int days, int radius, int distance,
+             int nrows, int ncols, byte* image, GLfloat r, GLfloat g,
+             GLfloat b, unsigned flags )
+{
+    Bodies.Name.push_back( name );
+    Bodies.HoursPerDay.push_back( hours );
+    Bodies.DaysPerYear.push_back( days );
+    Bodies.Radius.push_back( radius );
+    Bodies.Distance.push_back( distance );
+    Bodies.OrbitRate.push_back( days > 0 ? 1.0 / ( 24.0 * days ) : 0.0 );
+    Bodies.SpinRate.push_back( hours > 0 ? 1.0 / hours : 0.0 );
+    Bodies.Flags.push_back( flags );
+    Bodies.Parent.push_back( -1 );
+    Bodies.Rows.push_back( nrows );
+    Bodies.Cols.push_back( ncols );
+    Bodies.Image.push_back( image );
+    Bodies.Texture.push_back( 0 );
+    Bodies.Window.push_back( WholeTexture );
+    Bodies.Lod.push_back( 0 );
+    Bodies.R.push_back( r );
+    Bodies.G.push_back( g );
+    Bodies.B.push_back( b );
+
+    Bodies.Phases.PrevOrbit.push_back( 0.0 );
+    Bodies.Phases.Orbit.push_back( 0.0 );
+    Bodies.Phases.PrevSpin.push_back( 0.0 );
+    Bodies.Phases.Spin.push_back( 0.0 );
+
+    return Bodies.Name.size() - 1;
+}
+
+
+
+/******************************************************************************
+* Author: Savoy Schuler and Daniel Hodgin
+*
+* Function: ReserveBodies
+*
+* Description:
+*
+*   This function allocates room in every field of the table for the given
+*   number of bodies at once, so adding that many bodies does not reallocate.
+*
+* Parameters:
+*
+*   count   - number of bodies to make room for
+*
+******************************************************************************/
+void ReserveBodies( int count )
+{
+    Bodies.Name.reserve( count );
+    Bodies.HoursPerDay.reserve( count );
+    Bodies.DaysPerYear.reserve( count );
+    Bodies.Radius.reserve( count );
+    Bodies.Distance.reserve( count );
+    Bodies.OrbitRate.reserve( count );
+    Bodies.SpinRate.reserve( count );
+    Bodies.Flags.reserve( count );
+    Bodies.Parent.reserve( count );
+    Bodies.Rows.reserve( count );
+    Bodies.Cols.reserve( count );
+    Bodies.Image.reserve( count );
+    Bodies.Texture.reserve( count );
+    Bodies.Window.reserve( count );
+    Bodies.Lod.reserve( count );
+    Bodies.R.reserve( count );
+    Bodies.G.reserve( count );
+    Bodies.B.reserve( count );
+
+    Bodies.Phases.PrevOrbit.reserve( count );
+    Bodies.Phases.Orbit.reserve( count );
+    Bodies.Phases.PrevSpin.reserve( count );
+    Bodies.Phases.Spin.reserve( count );
+}
+
+
+
+/******************************************************************************
+* Author: Savoy Schuler and Daniel Hodgin
+*
+* Function: BodyCount
+*
+* Description:
+*
+*   Returns the number of bodies in the table.
+*
+* Parameters:
+*
+*		void	- No input parameters needed.
+*
+******************************************************************************/
+int BodyCount()
+{
+    return Bodies.Name.size();
+}
+
+
+
+/******************************************************************************
+* Author: Savoy Schuler and Daniel Hodgin
+*
+* Function: UpdateBodies
+*
+* Description:
+*
+*   This function advances the phases of every body by one animation time
+*   step. Bodies move around their orbits by the whole step. Planets spin by
+*   what is left of the step after whole Earth days, and other bodies (the
+*   Sun) by the whole step. The phase being left is wrapped to one turn and
+*   the new one is not, so frames blended between the two never cross a wrap.
+*   Phases are never negative, so truncating wraps them. Belt members are
+*   advanced too.
+*
+* Parameters:
+*
+*   phases  - phases to advance, one per body in the table
+*
+*   hours   - animation time step in Earth hours
+*
+******************************************************************************/
+void UpdateBodies( BodyPhases &phases, float hours )
+{
+    if ( phases.Orbit.empty() )
+        return;
+
+    UpdatePhases( phases.Orbit.size(), hours,
+                  hours - ( int ) ( hours / 24.0 ) * 24,
+                  &Bodies.OrbitRate[0], &Bodies.SpinRate[0], &Bodies.Flags[0],
+                  &phases.PrevOrbit[0], &phases.Orbit[0],
+                  &phases.PrevSpin[0], &phases.Spin[0] );
+
+    //Belt members move with the bodies (see belts.cpp).
+    UpdateBelts( phases, hours );
+}
+
+
+
+/******************************************************************************
+* Author: Savoy Schuler and Daniel Hodgin
+*
+* Function: UpdatePhases
+*
+* Description:
+*
+*   This is the loop behind UpdateBodies. The arrays are passed separately
+*   and marked as not overlapping so the loop can be vectorized.
+*
+* Parameters:
+*
+*   count       - number of bodies
+*
+*   hours       - animation time step in Earth hours
+*
+*   dayHours    - what is left of the time step after whole Earth days
+*
+*   orbitRate, spinRate, flags  - the body table's fields
+*
+*   prevOrbit, orbit, prevSpin, spin    - phases to advance
+*
+******************************************************************************/
+static void UpdatePhases( int count, float hours, float dayHours,
+                          const float *__restrict orbitRate,
+                          const float *__restrict spinRate,
+                          const unsigned *__restrict flags,
+                          float *__restrict prevOrbit, float *__restrict orbit,
+                          float *__restrict prevSpin, float *__restrict spin )
+{
+    for ( int i = 0; i < count; i++ )
+    {
+        float spinHours = ( flags[i] & BodyPlanet ) ? dayHours : hours;
+
+        prevOrbit[i] = orbit[i] - ( int ) orbit[i];
+        orbit[i] = prevOrbit[i] + hours * orbitRate[i];
+
+        prevSpin[i] = spin[i] - ( int ) spin[i];
+        spin[i] = prevSpin[i] + spinHours * spinRate[i];
+    }
+}
+
+
+
+/******************************************************************************
+* Author: Savoy Schuler and Daniel Hodgin
+*
+* Function: ResetBodies
+*
+* Description:
+*
+*   This function moves the planets and moons back to the start of their
+*   orbits and rotations. Other bodies are left where they are.
+*
+* Parameters:
+*
+*   phases  - phases to reset, one per body in the table
+*
+******************************************************************************/
+void ResetBodies( BodyPhases &phases )
+{
+    int count = phases.Orbit.size();
+
+    for ( int i = 0; i < count; i++ )
+    {
+        if ( Bodies.Flags[i] & ( BodyPlanet | BodyMoon ) )
+        {
+            phases.PrevOrbit[i] = phases.Orbit[i] = 0.0;
+            phases.PrevSpin[i] = phases.Spin[i] = 0.0;
+        }
+    }
+}
+
+
+
+/******************************************************************************
+* Author: Savoy Schuler and Daniel Hodgin
+*
+* Function: OrbitPhase
+*
+* Description:
+*
+*   Returns the fraction of its orbit a body has made in the frame being
+*   drawn, FrameBlend of the way from the previous simulation step to the
+*   current one.
+*
+* Parameters:
+*
+*   body    - row of the body in the table
+*
+******************************************************************************/
+float OrbitPhase( int body )
+{
+    float previous = Bodies.Phases.PrevOrbit[body];
+    float phase = previous + ( Bodies.Phases.Orbit[body] - previous ) * FrameBlend;
+
+    return phase - ( int ) phase;
+}
+
+
+
+/******************************************************************************
+* Author: Savoy Schuler and Daniel Hodgin
+*
+* Function: SpinPhase
+*
+* Description:
+*
+*   Returns the fraction of a turn about its axis a body has made in the
+*   frame being drawn, FrameBlend of the way from the previous simulation
+*   step to the current one.
+*
+* Parameters:
+*
+*   body    - row of the body in the table
+*
+******************************************************************************/
+float SpinPhase( int body )
+{
+    float previous = Bodies.Phases.PrevSpin[body];
+    float phase = previous + ( Bodies.Phases.Spin[body] - previous ) * FrameBlend;
+
+    return phase - ( int ) phase;
+}
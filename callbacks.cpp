@@ -36,7 +36,7 @@
 *			//Cycle functions
 *
 *		void Animate( void );
-*		void SetCelestialBodies();
+*		bool DrawFrame( void );
 *
 *			//Key press functions and handling
 *
@@ -86,10 +86,6 @@ using namespace std;
 
 /********************************* Globals ***********************************/
 
-//Globals for animate style.
-GLenum spinMode = GL_TRUE;
-GLenum singleStep = GL_TRUE;
-
 //Binary globals for mode toggling.
 bool light = true;
 bool shade = false;
@@ -97,14 +93,12 @@ bool wire = false;
 bool paths = true;
 bool planetNames = true;
 bool textureToggle = true;
+bool showStats = false;
 
 //Global Earth times used for Earth moon animation.
 float HourOfDay = 0.0;
 float DayOfYear = 0.0;
 
-//Global time step for animation (in Earth hours).
-float AnimateIncrement = 0.5;
-
 //Globals for camera control.
 float Xpan = 1.6;
 float Ypan = 9.0;
@@ -115,20 +109,10 @@ float Zrot = 64.0;
 int Resolution = 100;
 
 //Globals for mouse control.
+int ScreenWidth = 0;
 int ScreenHeight = 0;
 bool MouseClicked = false;
 
-//Global pointers to planet objects.
-Planet *Mercury;
-Planet *Venus;
-Planet *Earth;
-Planet *Mars;
-Planet *Jupiter;
-Planet *Saturn;
-Planet *Uranus;
-Planet *Neptune;
-Planet *Sun;
-Planet *Space;
 
 
 
@@ -149,12 +133,20 @@ Planet *Space;
 ******************************************************************************/
 void OpenGLInit( void )
 {
-    glEnable( GL_LIGHTING );
-    glEnable( GL_TEXTURE_2D );
-    glEnable( GL_DEPTH_TEST );
+    //A new context starts with OpenGL's defaults, not what was cached.
+    ForgetGLState();
+
+    SetCapability( GL_LIGHTING, true );
+    SetCapability( GL_TEXTURE_2D, true );
+    SetCapability( GL_DEPTH_TEST, true );
     glShadeModel( GL_SMOOTH );
     glClearColor( 0.0, 0.0, 0.0, 0.0 );		//Keep space dark.
     glClearDepth( 1.0 );
+
+    //Start the shader renderer if OpenGL can run it. Belts are drawn with
+    //it whenever it starts, the other bodies only if it was asked for.
+    bool started = StartShaders();
+    UseShaders = UseShaders && started;
 }
 
 
@@ -173,7 +165,8 @@ void OpenGLInit( void )
 *
 * Modifications:
 *
-*   Added screen height update for use with mouse callbacks.
+*   Added screen height update for use with mouse callbacks. Screen width is
+*   saved as well for finding sizes on screen.
 *
 * Parameters:
 *
@@ -196,13 +189,14 @@ void ResizeWindow( int w, int h )
     aspectRatio = ( float ) w / ( float ) h;
 
     //Update screen height global used for mouse location and mouse events.
+    ScreenWidth = w;
     ScreenHeight = h;
 
     //Set up the projection view matrix.
     glMatrixMode( GL_PROJECTION );
     glLoadIdentity();
-    gluPerspective( 60.0, aspectRatio, 1.0, 600.0 );
-    gluLookAt (0,0,2,0,0,0,0,1,0);
+    gluPerspective( FieldOfView, aspectRatio, NearClip, FarClip );
+    gluLookAt (0,0,EyeDistance,0,0,0,0,1,0);
 
     //Select the Model View matrix.
     glMatrixMode( GL_MODELVIEW );
@@ -217,8 +211,10 @@ void ResizeWindow( int w, int h )
 *
 * Description:
 *
-*	This is the main animation loop of the program. It handles calling functions
-*	for creating (only on the first pass) and drawing all celestial objects.
+*	This is the main animation loop of the program. It handles starting the
+*	simulation (only on the first pass) and drawing the frame. The simulation
+*	runs on its own thread; each pass draws the newest snapshot it has
+*	published, and the frame scheduler decides when the next pass is drawn.
 *
 * Parameters:
 *
@@ -227,53 +223,30 @@ void ResizeWindow( int w, int h )
 ******************************************************************************/
 void Animate( void )
 {
-    //Will want to create planet objects the first iteration only.
+    //Will want to start the simulation the first iteration only.
     static bool firstTime = true;
 
-    /*If this is the first pass, call set up function to create all celestial
-    objects.*/
+    /*If this is the first pass, start the simulation. The catalog was read
+    in main.*/
     if(firstTime == true)
     {
-        SetCelestialBodies();
-        SetRingsandMoon();
+        StartSimulation();
         firstTime = false;
     }
 
-    //Clear the redering window.
-    glClear( GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT );
-
-    /*Redraw all celestial objects at updated coordinates each iteration of the
-    main animation loop.*/
-    DrawSpace(Space);
-    DrawSun(Sun);
-    DrawPlanet(Mercury);
-    DrawPlanet(Venus);
-    DrawPlanet(Earth);
-    DrawPlanet(Mars);
-    DrawPlanet(Jupiter);
-    DrawPlanet(Saturn);
-    DrawPlanet(Uranus);
-    DrawPlanet(Neptune);
-
-    //Clear matrix, handle camera movements.
-    glLoadIdentity();
-    glTranslatef ( Xpan, Ypan, Zpan );
-    HandleRotate();
+    //Take the newest simulation snapshot and draw it.
+    TakeSnapshot();
+    DrawFrame();
 
-    //Flush the pipeline, and swap the buffers.
-    glFlush();
+    //Swap the buffers.
     glutSwapBuffers();
 
-    /*If single step animation mode enabled, stop animation loop after each
-    iteration.*/
-    if ( singleStep )
-    {
-        spinMode = GL_FALSE;
-    }
+    //Print frame statistics if they are toggled on.
+    ReportFrameStats();
 
-    /*Always ensure a redraw for mode toggling and etc. they may not be updated
-    otherwise.*/
-    glutPostRedisplay();
+    /*Ask for the next frame if animating. When paused, input callbacks ask for
+    a redraw for mode toggling and etc.*/
+    ScheduleNextFrame();
 }
 
 
@@ -281,97 +254,77 @@ void Animate( void )
 /******************************************************************************
 * Author: Savoy Schuler and Daniel Hodgin
 *
-* Function: SetCelestialBodies
+* Function: DrawFrame
 *
 * Description:
 *
-*	This function creates planet objects for each of the 8 planets, the sun, and
-*	the space backdrop and sets the fields for each. Each planet object is
-*	addressed by its corresponding global pointer declared at the top of this
-*	file.
-*
-*	The planet object has the following fields in order:
-*
-*		name	- planet name
-*		hours	- planet's hours in a day
-*		days	- planet's days in a year
-*		radius	- planet's raduis
-*		row 	- number of rows in planet's texture .bmp image
-*		cols	- number of columns in planet's texture .bmp image
-*		image	- pointer to location in memory of planet's stored texture map
-*					read in from .bmp image
-*		r		- planet's red value (used for color when no texture map)
-*		g		- planet's green value (used for color when no texture map)
-*		b		- planet's blue value (used for color when no texture map)
+*	This function draws one frame of the phases in the body table, into the
+*	window or, when headless, the framebuffer object (see headless.cpp). It
+*	uploads texture maps as the asset loader finishes them and draws all
+*	celestial objects. Objects outside the view are not drawn. Returns true
+*	if any texture map or tile was uploaded for the frame.
 *
 * Parameters:
 *
 *		void	- No input parameters needed.
 *
 ******************************************************************************/
-void SetCelestialBodies()
+bool DrawFrame( void )
 {
-    /*Variables needed for storing a pointer to and dimensions of a planet's
-    texture map. */
-    int nrows, ncols;
-    byte* image;
-    char * filename;
-
-    /*Set up each planet*/
-
-
-    //Convert a texture map's string name into a character array.
-    //Load a planet's texure map into memory.
-    //Construct a planet object pointed to by a global pointer (planet's name).
-
-    filename = StringToChar("mercury.bmp");
-    LoadBmpFile( filename, nrows, ncols, image );
-    Mercury = new Planet( "Mercury", 1416, 88, 2439, 58, nrows, ncols, image, 0.5, 0.25, 0.0 );
-
+    //Upload texture maps decoded since the last frame. Bodies still waiting
+    //for theirs are drawn in their own color.
+    bool uploaded = UploadAssets();
 
-    filename = StringToChar("venus.bmp");
-    LoadBmpFile( filename, nrows, ncols, image );
-    Venus = new Planet( "Venus", 5832, 225, 6052, 108, nrows, ncols, image, 0.7, 0.4, 0.0 );
+    //Start a new frame: save the camera, place the bodies, upload them for
+    //the shader renderer and clear the frame counters.
+    UpdateCamera();
+    UpdateTransforms();
+    UploadFrameData();
+    ResetFrameStats();
 
+    //Make the label font the first time names are shown.
+    if (planetNames == true)
+        LoadLabelFont();
 
-    filename = StringToChar("earth.bmp");
-    LoadBmpFile( filename, nrows, ncols, image );
-    Earth = new Planet( "Earth", 24, 365,  6378, 150, nrows, ncols, image, 0.0, 0.45, 0.1  );
-
-
-    filename = StringToChar("mars.bmp");
-    LoadBmpFile( filename, nrows, ncols, image );
-    Mars = new Planet( "Mars", 24.6, 687, 3394, 228, nrows, ncols, image, 0.75, 0.0, 0.0  );
-
-
-    filename = StringToChar("jupiter.bmp");
-    LoadBmpFile( filename, nrows, ncols, image );
-    Jupiter = new Planet( "Jupiter", 9.8, 4332, 71398/2.0, 779, nrows, ncols, image, 0.75, 0.75, 0.0  );
-
-
-    filename = StringToChar("saturn.bmp");
-    LoadBmpFile( filename, nrows, ncols, image );
-    Saturn = new Planet( "Saturn", 10.2, 10761, 60270/2.0, 1424, nrows, ncols, image, 1.0, 0.75, 0.0  );
-
+    //Clear the redering window.
+    glClear( GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT );
 
-    filename = StringToChar("uranus.bmp");
-    LoadBmpFile( filename, nrows, ncols, image );
-    Uranus = new Planet( "Uranus", 15.5, 30682, 25550, 2867, nrows, ncols, image, 0.0, 0.5, 0.5  );
+    /*Redraw all celestial objects at updated coordinates each iteration of the
+    main animation loop. The light at the sun is set first so planets are lit
+    even when the sun is outside the view. Belts' members are drawn all
+    together.*/
+    for (int i = 0; i < BodyCount(); i++)
+        if (Bodies.Flags[i] & BodyBackdrop)
+            DrawSpace(i);
 
+    SetLightModel();
 
-    filename = StringToChar("neptune.bmp");
-    LoadBmpFile( filename, nrows, ncols, image );
-    Neptune = new Planet( "Neptune", 15.8, 60195.0, 24750, 4492, nrows, ncols, image, 0.0, 1.0, 1.0   );
+    //Draw every orbital path at once if orbits are on.
+    if (paths == true)
+        DrawOrbits();
 
+    for (int i = 0; i < BodyCount(); i++)
+    {
+        if (Bodies.Flags[i] & BodyStar)
+            DrawSun(i);
+        else if (Bodies.Flags[i] & BodyPlanet)
+            DrawPlanet(i);
+        else if (Bodies.Flags[i] & BodyMoon)
+            DrawMoon(i);
+        else if (Bodies.Flags[i] & BodyRings)
+            DrawRings(i);
+        else if (Bodies.Flags[i] & BodyBelt)
+            DrawBelt(i);
+    }
 
-    filename = StringToChar("sun.bmp");
-    LoadBmpFile( filename, nrows, ncols, image );
-    Sun = new Planet( "Sun", 25, 0, 696000.0/10.0 * SizeScale, 0, nrows, ncols, image, 1.0, 1.0, 0.0  );
+    //Draw the names queued while drawing the bodies, with fixed function.
+    StopShading();
+    DrawLabels();
 
+    //Flush the pipeline.
+    glFlush();
 
-    filename = StringToChar("space.bmp");
-    LoadBmpFile( filename, nrows, ncols, image );
-    Space = new Planet( "Space", 0, 0, 100, 0, nrows, ncols, image, 1.0, 0.5, 0.0  );
+    return uploaded;
 }
 
 
@@ -384,6 +337,7 @@ void SetCelestialBodies()
 * Description:
 *
 *	This is the keyboard callback function used for handeling keyboard events.
+*	Every key asks for a redraw so changes show while the animation is paused.
 *
 *							   Key Assignments:
 *					(complete list available in readme.txt)
@@ -412,6 +366,7 @@ void SetCelestialBodies()
 *		9             - Reset planets
 *		0             - Toggle orbital paths
 *		p             - Toggle planet names
+*		i             - Toggle frame statistics
 *		+ (=)         - Increase Resolution
 *		-             - Decrease Resolution
 *
@@ -458,19 +413,19 @@ void KeyPressFunc( unsigned char Key, int x, int y )
     case '5':
         if (textureToggle == false)
         {
-            glEnable( GL_TEXTURE_2D );
+            SetCapability( GL_TEXTURE_2D, true );
             textureToggle = true;
         }
         else
         {
-            glDisable( GL_TEXTURE_2D );
+            SetCapability( GL_TEXTURE_2D, false );
             textureToggle = false;
         }
         break;
 
     //Toggle light source on or off.
     case '6':
-        ( light = !light ) ? glEnable( GL_LIGHTING ) : glDisable( GL_LIGHTING );
+        SetCapability( GL_LIGHTING, light = !light );
         break;
 
     //Reset camera to original position.
@@ -498,7 +453,13 @@ void KeyPressFunc( unsigned char Key, int x, int y )
         planetNames = !planetNames;
         break;
 
-    //Increase resolution (number of slices and stacks) of planets, sun, and moon.
+    //Toggle printing of frame statistics to the console.
+    case 'i':
+        showStats = !showStats;
+        break;
+
+    /*Increase resolution (most slices and stacks used by planets, sun, and
+    moon).*/
     case '=':
         if (Resolution <= 9)
             Resolution += 1;
@@ -506,7 +467,8 @@ void KeyPressFunc( unsigned char Key, int x, int y )
             Resolution += 5;
         break;
 
-    //Decrease resolution (number of slices and stacks) of planets, sun, and moon.
+    /*Decrease resolution (most slices and stacks used by planets, sun, and
+    moon).*/
     case '-':
         if (Resolution >= 15)
             Resolution -= 5;
@@ -561,6 +523,9 @@ void KeyPressFunc( unsigned char Key, int x, int y )
         exit( 1 );
 
     }
+
+    //Show the change.
+    glutPostRedisplay();
 }
 
 
@@ -816,7 +781,8 @@ void MoveToTopDownView()
 * Description:
 *
 *	This function is used to reset the position of the planets. The moon's
-	position is dependent on Earth's and will be reset implicitly.
+	position is dependent on Earth's and will be reset implicitly. The reset
+*	is carried out by the simulation thread.
 *
 * Parameters:
 *
@@ -825,29 +791,7 @@ void MoveToTopDownView()
 ******************************************************************************/
 void ResetPlanets()
 {
-    Mercury->setHourOfDay(0.0);
-    Mercury->setDayOfYear(0.0);
-
-    Venus->setHourOfDay(0.0);
-    Venus->setDayOfYear(0.0);
-
-    Earth->setHourOfDay(0.0);
-    Earth->setDayOfYear(0.0);
-
-    Mars->setHourOfDay(0.0);
-    Mars->setDayOfYear(0.0);
-
-    Jupiter->setHourOfDay(0.0);
-    Jupiter->setDayOfYear(0.0);
-
-    Saturn->setHourOfDay(0.0);
-    Saturn->setDayOfYear(0.0);
-
-    Uranus->setHourOfDay(0.0);
-    Uranus->setDayOfYear(0.0);
-
-    Neptune->setHourOfDay(0.0);
-    Neptune->setDayOfYear(0.0);
+    SendSimulationCommand(CommandReset);
 }
 
 
@@ -862,7 +806,7 @@ void ResetPlanets()
 *	This function is used speed up animation by adjusting the animation time
 *	step (the amount of time passed between frames). Presently, each press will
 *	double the time step. A reasonable bound is set to avoid approaching
-*	infinitely.
+*	infinitely. The change is carried out by the simulation thread.
 *
 * Parameters:
 *
@@ -871,13 +815,7 @@ void ResetPlanets()
 ******************************************************************************/
 void SpeedUp( void )
 {
-    //Bound the animation speed to avoid implicitly setting it to infinity.
-    if (AnimateIncrement < 4380.0)
-    {
-
-        //Double the animation time step.
-        AnimateIncrement *= 2.0;
-    }
+    SendSimulationCommand(CommandSpeedUp);
 }
 
 
@@ -893,7 +831,8 @@ void SpeedUp( void )
 *	step (the amount of time passed between frames). Presently, each press will
 *	halve the time step. A bound is set to avoid reducing the time step to zero
 *	from which it cannot be brought back up due to the multiplicative nature
-*	of the SpeedUp() function.
+*	of the SpeedUp() function. The change is carried out by the simulation
+*	thread.
 *
 * Parameters:
 *
@@ -902,13 +841,7 @@ void SpeedUp( void )
 ******************************************************************************/
 void SpeedDown( void )
 {
-    //Bound the animation speed to avoid accidentally setting it to zero.
-    if (AnimateIncrement > 0.0125)
-    {
-
-        //Halve the animation time step.
-        AnimateIncrement /= 2.0;
-    }
+    SendSimulationCommand(CommandSpeedDown);
 }
 
 
@@ -921,7 +854,9 @@ void SpeedDown( void )
 * Description:
 *
 *	This function is used to start or stop the animation loop. Essentially,
-*	allows the user to pause animation.
+*	allows the user to pause animation. If single step mode is enabled, it is
+*	ended and the animation continues. The change is carried out by the
+*	simulation thread.
 *
 * Parameters:
 *
@@ -930,23 +865,7 @@ void SpeedDown( void )
 ******************************************************************************/
 void StartStopAnimation( void )
 {
-
-    /*If single step mode is enabled, it must first be disabled before allowing
-    the animation loop to proceed. */
-
-    if ( singleStep )
-    {
-        //End single step mode.
-        singleStep = GL_FALSE;
-
-        //Enable animation to continue.
-        spinMode = GL_TRUE;
-    }
-    else
-    {
-        //Toggle continuous run of the animation loop on or off.
-        spinMode = !spinMode;
-    }
+    SendSimulationCommand(CommandStartStop);
 }
 
 
@@ -959,7 +878,8 @@ void StartStopAnimation( void )
 * Description:
 *
 *	This function allows the user to stop continuous animation and rather
-*	advance the animation loop by one iteration at a time.
+*	advance the animation loop by one iteration at a time. The step is taken
+*	by the simulation thread.
 *
 * Parameters:
 *
@@ -968,11 +888,7 @@ void StartStopAnimation( void )
 ******************************************************************************/
 void StepAnimation( void )
 {
-    //Enable single stepping through animation.
-    singleStep = GL_TRUE;
-
-    //Enable planets spinning.
-    spinMode = GL_TRUE;
+    SendSimulationCommand(CommandStep);
 }
 
 
@@ -1030,6 +946,9 @@ void SpecialKeyFunc( int Key, int x, int y )
         Zrot = Zrot + 3;
         break;
     }
+
+    //Show the change.
+    glutPostRedisplay();
 }
 
 
@@ -1139,6 +1058,10 @@ void MouseDragFunc(int x, int y)
     {
         Xrot = 0;
     }
+
+    //Show the change.
+    glutPostRedisplay();
+
     //If MouseClicked is true save x and y else set the dummy values.
     if(MouseClicked)
     {
@@ -1210,6 +1133,7 @@ void CreateMenus()
     glutAddMenuEntry(	"9             - Reset planets", value++ );
     glutAddMenuEntry(	"0             - Toggle orbital paths", value++ );
     glutAddMenuEntry(	"p             - Toggle planet names", value++ );
+    glutAddMenuEntry(	"i              - Toggle frame statistics", value++ );
     glutAddMenuEntry(	"+ (=)        - Increase Resolution", value++ );
     glutAddMenuEntry(	"-             - Decrease Resolution", value++ );
 
@@ -1352,6 +1276,9 @@ void SubMenuHandlerControls ( int item )
         cout << "invalid main menu item " << item << endl;
         break;
     }
+
+    //Show the change.
+    glutPostRedisplay();
 }
 
 
@@ -1410,19 +1337,19 @@ void SubMenuHandlerOptions ( int item )
     case 7:
         if (textureToggle == false)
         {
-            glEnable( GL_TEXTURE_2D );
+            SetCapability( GL_TEXTURE_2D, true );
             textureToggle = true;
         }
         else
         {
-            glDisable( GL_TEXTURE_2D );
+            SetCapability( GL_TEXTURE_2D, false );
             textureToggle = false;
         }
         break;
 
     //Toggle lighting.
     case 8:
-        ( light = !light ) ? glEnable( GL_LIGHTING ) : glDisable( GL_LIGHTING );
+        SetCapability( GL_LIGHTING, light = !light );
 
         break;
 
@@ -1451,8 +1378,13 @@ void SubMenuHandlerOptions ( int item )
         planetNames = !planetNames;
         break;
 
-    //Increase resolution of planet, moon, and sun.
+    //Toggle frame statistics.
     case 14:
+        showStats = !showStats;
+        break;
+
+    //Increase resolution of planet, moon, and sun.
+    case 15:
         if (Resolution <= 9)
             Resolution += 1;
         else if (Resolution <= 145)
@@ -1460,7 +1392,7 @@ void SubMenuHandlerOptions ( int item )
         break;
 
     //Decrease resolution of planet, moon, and sun.
-    case 15:
+    case 16:
         if (Resolution >= 15)
             Resolution -= 5;
         else if (Resolution >= 4)
@@ -1472,4 +1404,7 @@ void SubMenuHandlerOptions ( int item )
         cout << "invalid main menu item " << item << endl;
         break;
     }
+
+    //Show the change.
+    glutPostRedisplay();
 }
@@ -0,0 +1,466 @@
+/******************************************************************************
+*	File: camera.cpp
+*
+*	Authors: Savoy Schuler and Daniel Hodgin
+*
+*	Date: 11-17-16
+*
+*	Description:
+*
+*		This file contains the CPU side copy of the camera. Once per frame the
+*       view rotation and translation set by the user controls are stored so
+*       that the position of an object relative to the eye, its size on
+*       screen, and whether it is in view can be found without asking OpenGL.
+*       The view matrix is built from them here too, once per frame, and
+*       loaded with glLoadMatrixf wherever the view is needed, instead of
+*       rotating and translating through OpenGL's matrix stack each time.
+*
+*	File Order and Structure:
+*
+*       - Update camera.
+*       - View matrix.
+*       - Eye space helpers.
+*
+*	Modified:
+*
+*		Original
+*
+*	Functions Included:
+*
+*           //Update camera.
+*
+*       void UpdateCamera();
+*
+*           //View matrix.
+*
+*       const GLfloat* GetViewMatrix();
+*       void LoadViewMatrix();
+*       void LoadViewRotation();
+*       void GetProjectionMatrix( GLfloat matrix[16] );
+*
+*           //Eye space helpers.
+*
+*       void EyePosition( const float world[3], float eye[3] );
+*       void CameraPosition( float world[3] );
+*       float ProjectedRadius( const float world[3], float radius );
+*       float PixelsPerUnit( float distance );
+*       bool SphereInView( const float world[3], float radius );
+*       bool WindowPosition( const float world[3], float window[3] );
+*
+******************************************************************************/
+
+/**************************** Library Includes *******************************/
+#include <cstdlib>
+#include <cmath>
+#include <GL/freeglut.h>
+#include <iostream>
+#include <string>
+#include "Planet.h"
+#include "globals.h"
+
+/********************************* Globals ***********************************/
+
+//View rotation (row major) and translation saved by UpdateCamera.
+static float ViewRotation[3][3];
+static float ViewPan[3];
+
+//View matrix, column major: the rotation after the pan.
+static GLfloat ViewMatrix[16];
+
+//Pixels per unit of size at unit distance for the current window.
+static float PixelScale = 1.0;
+
+//Tangent of half the vertical field of view, and width over height.
+static float TanHalfHeight = 1.0;
+static float AspectRatio = 1.0;
+
+/*Sine and cosine of the half angles of the view, vertical and horizontal,
+used for the side planes of the view frustum.*/
+static float SinHalfHeight, CosHalfHeight;
+static float SinHalfWidth, CosHalfWidth;
+
+
+
+/******************************************************************************
+* Author: Savoy Schuler and Daniel Hodgin
+*
+* Function: UpdateCamera
+*
+* Description:
+*
+*   This function saves the current view for the frame. The rotation is the
+*   product of the x, y, and z rotations by the user's angles, in that order,
+*   and the translation is the user's pan. The view matrix rotates after
+*   panning. This should be called once at the start of each frame after the
+*   camera globals have been updated.
+*
+* Parameters:
+*
+*		void	- No input parameters needed.
+*
+******************************************************************************/
+void UpdateCamera()
+{
+    float cx = cos( Xrot * PI / 180 ), sx = sin( Xrot * PI / 180 );
+    float cy = cos( Yrot * PI / 180 ), sy = sin( Yrot * PI / 180 );
+    float cz = cos( Zrot * PI / 180 ), sz = sin( Zrot * PI / 180 );
+
+    //Rx * Ry * Rz.
+    ViewRotation[0][0] = cy * cz;
+    ViewRotation[0][1] = -cy * sz;
+    ViewRotation[0][2] = sy;
+    ViewRotation[1][0] = sx * sy * cz + cx * sz;
+    ViewRotation[1][1] = -sx * sy * sz + cx * cz;
+    ViewRotation[1][2] = -sx * cy;
+    ViewRotation[2][0] = -cx * sy * cz + sx * sz;
+    ViewRotation[2][1] = cx * sy * sz + sx * cz;
+    ViewRotation[2][2] = cx * cy;
+
+    ViewPan[0] = Xpan;
+    ViewPan[1] = Ypan;
+    ViewPan[2] = Zpan;
+
+    for ( int i = 0; i < 3; i++ )
+    {
+        for ( int j = 0; j < 3; j++ )
+            ViewMatrix[4 * j + i] = ViewRotation[i][j];
+
+        ViewMatrix[12 + i] = ViewRotation[i][0] * ViewPan[0] +
+                             ViewRotation[i][1] * ViewPan[1] +
+                             ViewRotation[i][2] * ViewPan[2];
+        ViewMatrix[4 * i + 3] = 0.0;
+    }
+
+    ViewMatrix[15] = 1.0;
+
+    //Half the window height covers tan(fov/2) at unit distance.
+    TanHalfHeight = tan( FieldOfView * PI / 360.0 );
+    PixelScale = ( ScreenHeight / 2.0 ) / TanHalfHeight;
+
+    //Half angles of the view for the frustum's side planes.
+    AspectRatio = ScreenHeight > 0 ? ( float ) ScreenWidth / ScreenHeight : 1.0;
+    float halfHeight = atan( TanHalfHeight );
+    float halfWidth = atan( TanHalfHeight * AspectRatio );
+
+    SinHalfHeight = sin( halfHeight );
+    CosHalfHeight = cos( halfHeight );
+    SinHalfWidth = sin( halfWidth );
+    CosHalfWidth = cos( halfWidth );
+}
+
+
+
+/******************************************************************************
+* Author: Savoy Schuler and Daniel Hodgin
+*
+* Function: GetViewMatrix
+*
+* Description:
+*
+*   Returns the view matrix saved for the frame, 16 floats in column major
+*   order. It takes solar system coordinates to those OpenGL is given before
+*   the projection's step back from the origin.
+*
+* Parameters:
+*
+*		void	- No input parameters needed.
+*
+******************************************************************************/
+const GLfloat* GetViewMatrix()
+{
+    return ViewMatrix;
+}
+
+
+
+/******************************************************************************
+* Author: Savoy Schuler and Daniel Hodgin
+*
+* Function: LoadViewMatrix
+*
+* Description:
+*
+*   This function loads the view matrix into the modelview matrix, for
+*   drawing things placed in solar system coordinates.
+*
+* Parameters:
+*
+*		void	- No input parameters needed.
+*
+******************************************************************************/
+void LoadViewMatrix()
+{
+    glLoadMatrixf( ViewMatrix );
+}
+
+
+
+/******************************************************************************
+* Author: Savoy Schuler and Daniel Hodgin
+*
+* Function: LoadViewRotation
+*
+* Description:
+*
+*   This function loads only the view's rotation into the modelview matrix,
+*   centered on the eye: the projection's step back from the origin is
+*   undone, so things drawn around the origin surround the eye.
+*
+* Parameters:
+*
+*		void	- No input parameters needed.
+*
+******************************************************************************/
+void LoadViewRotation()
+{
+    GLfloat rotation[16];
+
+    for ( int i = 0; i < 12; i++ )
+        rotation[i] = ViewMatrix[i];
+
+    rotation[12] = rotation[13] = 0.0;
+    rotation[14] = EyeDistance;
+    rotation[15] = 1.0;
+
+    glLoadMatrixf( rotation );
+}
+
+
+
+/******************************************************************************
+* Author: Savoy Schuler and Daniel Hodgin
+*
+* Function: GetProjectionMatrix
+*
+* Description:
+*
+*   This function returns the projection matrix set up in ResizeWindow, the
+*   perspective projection after the step back from the origin, worked out
+*   for the frame instead of read back from OpenGL.
+*
+* Parameters:
+*
+*   matrix  - set to the projection matrix, column major
+*
+******************************************************************************/
+void GetProjectionMatrix( GLfloat matrix[16] )
+{
+    float f = 1.0 / TanHalfHeight;
+    float depth = NearClip - FarClip;
+
+    for ( int i = 0; i < 16; i++ )
+        matrix[i] = 0.0;
+
+    //As gluPerspective.
+    matrix[0] = f / AspectRatio;
+    matrix[5] = f;
+    matrix[10] = ( FarClip + NearClip ) / depth;
+    matrix[11] = -1.0;
+
+    //Then gluLookAt's step back along z.
+    matrix[14] = 2.0 * FarClip * NearClip / depth - matrix[10] * EyeDistance;
+    matrix[15] = EyeDistance;
+}
+
+
+
+/******************************************************************************
+* Author: Savoy Schuler and Daniel Hodgin
+*
+* Function: EyePosition
+*
+* Description:
+*
+*   This function finds where a point in the solar system sits relative to
+*   the eye. The view pan and rotation are applied, followed by the step back
+*   from the origin made by gluLookAt in ResizeWindow.
+*
+* Parameters:
+*
+*   world   - point in solar system coordinates
+*
+*   eye     - returned point in eye coordinates
+*
+******************************************************************************/
+void EyePosition( const float world[3], float eye[3] )
+{
+    float p[3] = { world[0] + ViewPan[0], world[1] + ViewPan[1],
+                   world[2] + ViewPan[2]
+                 };
+
+    for ( int i = 0; i < 3; i++ )
+        eye[i] = ViewRotation[i][0] * p[0] + ViewRotation[i][1] * p[1] +
+                 ViewRotation[i][2] * p[2];
+
+    eye[2] -= EyeDistance;
+}
+
+
+
+/******************************************************************************
+* Author: Savoy Schuler and Daniel Hodgin
+*
+* Function: CameraPosition
+*
+* Description:
+*
+*   This function finds where the eye sits in the solar system, undoing
+*   what EyePosition does to a point.
+*
+* Parameters:
+*
+*   world   - returned eye position in solar system coordinates
+*
+******************************************************************************/
+void CameraPosition( float world[3] )
+{
+    //The rotation is orthonormal, so its transpose undoes it.
+    for ( int i = 0; i < 3; i++ )
+        world[i] = ViewRotation[2][i] * EyeDistance - ViewPan[i];
+}
+
+
+
+/******************************************************************************
+* Author: Savoy Schuler and Daniel Hodgin
+*
+* Function: ProjectedRadius
+*
+* Description:
+*
+*   This function returns the approximate radius, in pixels, that a sphere
+*   covers on screen. A sphere the eye is inside of is given a very large
+*   radius.
+*
+* Parameters:
+*
+*   world   - center of the sphere in solar system coordinates
+*
+*   radius  - radius of the sphere
+*
+******************************************************************************/
+float ProjectedRadius( const float world[3], float radius )
+{
+    float eye[3];
+    EyePosition( world, eye );
+
+    float distance = sqrt( eye[0] * eye[0] + eye[1] * eye[1] +
+                           eye[2] * eye[2] );
+
+    if ( distance <= radius )
+        return 1.0e6;
+
+    return radius * PixelScale / distance;
+}
+
+
+
+/******************************************************************************
+* Author: Savoy Schuler and Daniel Hodgin
+*
+* Function: PixelsPerUnit
+*
+* Description:
+*
+*   This function returns the number of pixels one unit of size covers on
+*   screen at a distance from the eye.
+*
+* Parameters:
+*
+*   distance    - distance from the eye
+*
+******************************************************************************/
+float PixelsPerUnit( float distance )
+{
+    return PixelScale / distance;
+}
+
+
+
+/******************************************************************************
+* Author: Savoy Schuler and Daniel Hodgin
+*
+* Function: SphereInView
+*
+* Description:
+*
+*   This function tests a bounding sphere against the view frustum set up in
+*   ResizeWindow. The sphere is moved into eye coordinates, where the eye
+*   looks down -z, and its signed distance to each of the six planes is
+*   checked. Returns false only if the sphere is entirely outside one plane.
+*
+* Parameters:
+*
+*   world   - center of the sphere in solar system coordinates
+*
+*   radius  - radius of the sphere
+*
+******************************************************************************/
+bool SphereInView( const float world[3], float radius )
+{
+    float eye[3];
+    EyePosition( world, eye );
+
+    //Near and far planes.
+    if ( eye[2] + NearClip > radius || -eye[2] - FarClip > radius )
+        return false;
+
+    //Top and bottom planes.
+    if ( eye[1] * CosHalfHeight + eye[2] * SinHalfHeight > radius ||
+            -eye[1] * CosHalfHeight + eye[2] * SinHalfHeight > radius )
+        return false;
+
+    //Left and right planes.
+    if ( eye[0] * CosHalfWidth + eye[2] * SinHalfWidth > radius ||
+            -eye[0] * CosHalfWidth + eye[2] * SinHalfWidth > radius )
+        return false;
+
+    return true;
+}
+
+
+
+/******************************************************************************
+* Author: Savoy Schuler and Daniel Hodgin
+*
+* Function: WindowPosition
+*
+* Description:
+*
+*   This function finds where a point lands in the window, as glRasterPos
+*   would with the projection set up in ResizeWindow: x and y in pixels from
+*   the lower left corner, and the depth from 0 at the near plane to 1 at
+*   the far plane. Returns false, as glRasterPos would mark the position
+*   invalid, if the point is outside the view.
+*
+* Parameters:
+*
+*   world   - point in solar system coordinates
+*
+*   window  - returned x, y and depth in the window
+*
+******************************************************************************/
+bool WindowPosition( const float world[3], float window[3] )
+{
+    float eye[3];
+    EyePosition( world, eye );
+
+    float distance = -eye[2];
+    if ( distance < NearClip || distance > FarClip )
+        return false;
+
+    //Normalized device coordinates, -1 to 1 across the view.
+    float x = eye[0] / ( distance * TanHalfHeight * AspectRatio );
+    float y = eye[1] / ( distance * TanHalfHeight );
+    float z = ( FarClip + NearClip - 2.0 * FarClip * NearClip / distance ) /
+              ( FarClip - NearClip );
+
+    if ( x < -1.0 || x > 1.0 || y < -1.0 || y > 1.0 )
+        return false;
+
+    window[0] = ( x + 1.0 ) * ScreenWidth / 2.0;
+    window[1] = ( y + 1.0 ) * ScreenHeight / 2.0;
+    window[2] = ( z + 1.0 ) / 2.0;
+
+    return true;
+}
@@ -0,0 +1,429 @@
+/******************************************************************************
+*	File: catalog.cpp
+*
+*	Authors: Savoy Schuler and Daniel Hodgin
+*
+*	Date: 11-17-16
+*
+*	Description:
+*
+*		This file contains the body catalog loader. The celestial bodies are
+*       no longer built into the program; they are read at startup from a
+*       text catalog (bodies.csv by default) with one body per line, so bodies
+*       can be added or changed without rebuilding. The format is described at
+*       the top of bodies.csv.
+*
+*       The catalog is read into memory in one piece and parsed in place.
+*       Lines are counted first so the body table is allocated once for every
+*       row. Names must be unique. Parents are looked up by name once all rows
+*       are read, so a body may be listed before the body it circles: planets
+*       and belts circle a star, and moons and rings a planet, any number to
+*       a planet. Only the backdrop and stars circle nothing. Texture maps are
+*       only registered here; the asset loader reads them once they are
+*       needed (see assets.cpp). A belt's line has two more fields, the number
+*       of its members and the width of its band, and its members are made up
+*       as it is read (see belts.cpp).
+*
+*	File Order and Structure:
+*
+*       - Load catalog.
+*       - Parse helpers.
+*
+*	Modified:
+*
+*		Original
+*
+*	Functions Included:
+*
+*           //Load catalog.
+*
+*       bool LoadCatalog( const char *filename );
+*
+*           //Parse helpers.
+*
+*       static int SplitFields( char *line, char *fields[], int maxFields );
+*       static unsigned KindFlags( const char *kind );
+*       static bool ParseNumber( const char *text, double &value );
+*
+******************************************************************************/
+
+/**************************** Library Includes *******************************/
+#include <climits>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <GL/freeglut.h>
+#include <iostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "Planet.h"
+#include "globals.h"
+
+/******************************* Name Space **********************************/
+
+using namespace std;
+
+/******************************* Constants **********************************/
+
+//Number of fields on each line of the catalog, and on a belt's line.
+static const int CatalogFields = 11;
+static const int BeltFields = 13;
+
+/********************************* Globals ***********************************/
+
+//Catalog read at startup, set by the -catalog command line option.
+string CatalogFile = "bodies.csv";
+
+/*************************** Function Prototypes *****************************/
+
+static int SplitFields( char *line, char *fields[], int maxFields );
+static unsigned KindFlags( const char *kind );
+static bool ParseNumber( const char *text, double &value );
+
+
+
+/******************************************************************************
+* Author: Savoy Schuler and Daniel Hodgin
+*
+* Function: LoadCatalog
+*
+* Description:
+*
+*   This function reads a catalog of bodies into the body table. Each line
+*   holds name, kind, parent, hours, days, radius, distance, texture, r, g and
+*   b, separated by commas, and a belt's also members and width. Blank lines
+*   and lines starting with # are skipped.
+*   Each body's texture map is registered with the asset loader, and each
+*   body's parent found. No OpenGL calls are made, so the catalog may be
+*   read before the window is created.
+*
+*   Returns false, after printing why, if the catalog can not be read, a
+*   line can not be understood, a number is not one, a belt has a negative
+*   or fractional number of members or a negative width, a name is used
+*   twice or a body circles a body it can not, or none when it must circle
+*   one.
+*
+* Parameters:
+*
+*   filename    - catalog to read
+*
+******************************************************************************/
+bool LoadCatalog( const char *filename )
+{
+    //Read the whole catalog into memory.
+    FILE *infile = fopen( filename, "rb" );
+    if ( !infile )
+    {
+        fprintf( stderr, "LoadCatalog(): unable to open file: %s\n", filename );
+        return false;
+    }
+
+    fseek( infile, 0, SEEK_END );
+    long size = ftell( infile );
+    fseek( infile, 0, SEEK_SET );
+
+    vector<char> text( size + 1 );
+    size = fread( &text[0], 1, size, infile );
+    text[size] = '\0';
+    fclose( infile );
+
+    //Count lines to size the body table once.
+    int lines = 1;
+    for ( long i = 0; i < size; i++ )
+        if ( text[i] == '\n' )
+            lines++;
+
+    ReserveBodies( BodyCount() + lines );
+
+    unordered_map<string, int> rows( lines );
+    vector<pair<int, string> > parents;
+
+    //Parse each line in place.
+    char *line = &text[0];
+    for ( int lineNumber = 1; line != NULL; lineNumber++ )
+    {
+        char *next = strchr( line, '\n' );
+        if ( next != NULL )
+            *next++ = '\0';
+
+        char *fields[BeltFields];
+        int count = SplitFields( line, fields, BeltFields );
+
+        //Skip blank lines and comments.
+        if ( count == 0 || ( count == 1 && fields[0][0] == '\0' ) ||
+                fields[0][0] == '#' )
+        {
+            line = next;
+            continue;
+        }
+
+        unsigned flags = KindFlags( fields[1] );
+
+        int expected = ( flags & BodyBelt ) ? BeltFields : CatalogFields;
+
+        if ( count != expected || flags == 0 )
+        {
+            fprintf( stderr, "LoadCatalog(): bad line %d in %s\n", lineNumber,
+                     filename );
+            return false;
+        }
+
+        if ( rows.count( fields[0] ) )
+        {
+            fprintf( stderr, "LoadCatalog(): %s is named twice, on line %d in "
+                     "%s\n", fields[0], lineNumber, filename );
+            return false;
+        }
+
+        //Every field but name, kind, parent and texture is a number.
+        double numbers[BeltFields] = { 0.0 };
+
+        for ( int i = 3; i < count; i++ )
+        {
+            if ( i == 7 || ParseNumber( fields[i], numbers[i] ) )
+                continue;
+
+            fprintf( stderr, "LoadCatalog(): \"%s\" is not a number, on line "
+                     "%d in %s\n", fields[i], lineNumber, filename );
+            return false;
+        }
+
+        //A belt has a whole number of members, in a band of some width.
+        if ( ( flags & BodyBelt ) && ( numbers[11] < 0.0 ||
+                numbers[11] > INT_MAX || numbers[11] != floor( numbers[11] ) ||
+                numbers[12] < 0.0 ) )
+        {
+            fprintf( stderr, "LoadCatalog(): %s has %s members and width %s, "
+                     "on line %d in %s\n", fields[0], fields[11], fields[12],
+                     lineNumber, filename );
+            return false;
+        }
+
+        //Add the body to the body table, without its texture map for now.
+        int body = AddBody( fields[0], numbers[3], numbers[4], numbers[5],
+                            numbers[6], 0, 0, NULL, numbers[8], numbers[9],
+                            numbers[10], flags );
+
+        //The backdrop's texture map is drawn as a skybox.
+        if ( strcmp( fields[7], "-" ) != 0 )
+        {
+            if ( flags & BodyBackdrop )
+                RegisterSkybox( fields[7], body );
+            else
+                RegisterTexture( fields[7], body );
+        }
+
+        //Make up a belt's members.
+        if ( flags & BodyBelt )
+            AddBelt( body, ( int ) numbers[11], numbers[12] );
+
+        rows[fields[0]] = body;
+
+        //Only the backdrop and stars circle nothing.
+        if ( strcmp( fields[2], "-" ) != 0 )
+            parents.push_back( make_pair( body, string( fields[2] ) ) );
+        else if ( !( flags & ( BodyBackdrop | BodyStar ) ) )
+        {
+            fprintf( stderr, "LoadCatalog(): %s circles no body, on line %d "
+                     "in %s\n", fields[0], lineNumber, filename );
+            return false;
+        }
+
+        line = next;
+    }
+
+    //Look up parents now that every body is known.
+    for ( unsigned i = 0; i < parents.size(); i++ )
+    {
+        int body = parents[i].first;
+        unordered_map<string, int>::iterator parent = rows.find( parents[i].second );
+
+        if ( parent == rows.end() )
+        {
+            fprintf( stderr, "LoadCatalog(): %s circles unknown body %s\n",
+                     Bodies.Name[body].c_str(), parents[i].second.c_str() );
+            return false;
+        }
+
+        //Planets and belts circle a star, moons and rings a planet.
+        unsigned flags = Bodies.Flags[body];
+        unsigned parentFlags = Bodies.Flags[parent->second];
+
+        bool aroundStar = ( flags & ( BodyPlanet | BodyBelt ) ) &&
+                          ( parentFlags & BodyStar );
+        bool aroundPlanet = ( flags & ( BodyMoon | BodyRings ) ) &&
+                            ( parentFlags & BodyPlanet );
+
+        if ( !aroundStar && !aroundPlanet )
+        {
+            fprintf( stderr, "LoadCatalog(): %s can not circle %s\n",
+                     Bodies.Name[body].c_str(), parents[i].second.c_str() );
+            return false;
+        }
+
+        Bodies.Parent[body] = parent->second;
+    }
+
+    return true;
+}
+
+
+
+/******************************************************************************
+* Author: Savoy Schuler and Daniel Hodgin
+*
+* Function: SplitFields
+*
+* Description:
+*
+*   This function splits a line at its commas, in place. Spaces, tabs and
+*   carriage returns around each field are removed. Returns the number of
+*   fields found; fields past maxFields are counted but not stored.
+*
+* Parameters:
+*
+*   line        - line to split, which is modified
+*
+*   fields      - returned start of each field
+*
+*   maxFields   - number of entries in fields
+*
+******************************************************************************/
+static int SplitFields( char *line, char *fields[], int maxFields )
+{
+    int count = 0;
+
+    while ( true )
+    {
+        //Skip leading white space.
+        while ( *line == ' ' || *line == '\t' )
+            line++;
+
+        char *start = line;
+
+        //Find the end of the field.
+        while ( *line != ',' && *line != '\0' )
+            line++;
+
+        bool last = ( *line == '\0' );
+        char *end = line;
+
+        //Trim trailing white space.
+        while ( end > start && ( end[-1] == ' ' || end[-1] == '\t' ||
+                                 end[-1] == '\r' ) )
+            end--;
+
+        *end = '\0';
+
+        if ( count < maxFields )
+            fields[count] = start;
+        count++;
+
+        if ( last )
+            return count;
+
+        line++;
+    }
+}
+
+
+
+/******************************************************************************
+* Author: Savoy Schuler and Daniel Hodgin
+*
+* Function: KindFlags
+*
+* Description:
+*
+*   Returns the BodyFlags for a kind of body named in the catalog, or 0 if
+*   the kind is not known.
+*
+* Parameters:
+*
+*   kind    - backdrop, star, planet, moon, rings or belt
+*
+******************************************************************************/
+static unsigned KindFlags( const char *kind )
+{
+    if ( strcmp( kind, "backdrop" ) == 0 )
+        return BodyBackdrop;
+    if ( strcmp( kind, "star" ) == 0 )
+        return BodyStar;
+    if ( strcmp( kind, "planet" ) == 0 )
+        return BodyPlanet;
+    if ( strcmp( kind, "moon" ) == 0 )
+        return BodyMoon;
+    if ( strcmp( kind, "rings" ) == 0 )
+        return BodyRings;
+    if ( strcmp( kind, "belt" ) == 0 )
+        return BodyBelt;
+
+    return 0;
+}
+
+
+
+/******************************************************************************
+* Author: Savoy Schuler and Daniel Hodgin
+*
+* Function: ParseNumber
+*
+* Description:
+*
+*   This function reads a number in the catalog. Plain decimals, which is
+*   all the catalog normally holds, are read directly since strtod is slow
+*   enough to dominate loading large catalogs. Anything else (exponents,
+*   hex) is left to strtod. Returns false if the text is not a number.
+*
+* Parameters:
+*
+*   text    - number to read
+*
+*   value   - returned value of the number
+*
+******************************************************************************/
+static bool ParseNumber( const char *text, double &value )
+{
+    const char *c = text;
+    bool negative = false;
+    bool digits = false;
+    value = 0.0;
+
+    if ( *c == '-' || *c == '+' )
+        negative = ( *c++ == '-' );
+
+    //Whole part.
+    while ( *c >= '0' && *c <= '9' )
+    {
+        value = value * 10.0 + ( *c++ - '0' );
+        digits = true;
+    }
+
+    //Fraction.
+    if ( *c == '.' )
+    {
+        double scale = 0.1;
+
+        for ( c++; *c >= '0' && *c <= '9'; c++, scale *= 0.1 )
+        {
+            value += ( *c - '0' ) * scale;
+            digits = true;
+        }
+    }
+
+    //Not a plain decimal.
+    if ( *c != '\0' || !digits )
+    {
+        char *end;
+        value = strtod( text, &end );
+
+        return end != text && *end == '\0' && isfinite( value );
+    }
+
+    if ( negative )
+        value = -value;
+
+    return true;
+}
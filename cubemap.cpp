@@ -0,0 +1,432 @@
+/******************************************************************************
+*	File: cubemap.cpp
+*
+*	Authors: Savoy Schuler and Daniel Hodgin
+*
+*	Date: 11-17-16
+*
+*	Description:
+*
+*		This file turns the backdrop's equirectangular image into the six
+*       faces of a cube map (see skybox.cpp), and saves and reads back the
+*       faces made. It does not use OpenGL, so the asset loader's workers
+*       can run it off the GLUT thread and the packer (see packer.cpp) can
+*       build the faces into the texture pack.
+*
+*       Turning the image into a cube map takes a moment, so the six faces
+*       are saved next to the image, in a .cube file of the same name, and
+*       read back from there the next time. The .cube file remembers the size
+*       and time of the image it was made from and is made again if the image
+*       changes.
+*
+*       Each face texel looks up the image at its direction just as the
+*       sphere's texture coordinates did, so the stars are where they were.
+*
+*	File Order and Structure:
+*
+*       - Make cube maps.
+*       - Cube map cache.
+*
+*	Modified:
+*
+*		Original - Split from skybox.cpp.
+*
+*	Functions Included:
+*
+*           //Make cube maps.
+*
+*       int CubeFaceSize( int cols, int maxSize );
+*       byte* BuildCubeMap( const byte* image, int cols, int rows, int size );
+*       static void FaceDirection( int face, float s, float t,
+*                                  float direction[3] );
+*       static void SampleImage( const byte* image, int cols, int rows,
+*                                float s, float t, byte* texel );
+*
+*           //Cube map cache.
+*
+*       string CubeCacheName( const string &filename );
+*       byte* ReadCubeCache( const string &filename, int maxSize, int &size );
+*       void WriteCubeCache( const string &filename, const byte* faces,
+*                            int size );
+*
+******************************************************************************/
+
+/**************************** Library Includes *******************************/
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <stdint.h>
+#include <string>
+#include <sys/stat.h>
+#include "Planet.h"
+#include "globals.h"
+
+/******************************* Name Space **********************************/
+
+using namespace std;
+
+/******************************** Type Def ***********************************/
+
+//Start of a .cube file. The six faces follow, +x, -x, +y, -y, +z, -z, each
+//Size x Size RGB texels in rows from t = 0.
+struct CubeHeader
+{
+    char Magic[4];          //CubeMagic
+    uint32_t Version;       //CubeVersion
+    uint32_t Size;          //texels on each side of a face
+    uint32_t Reserved;      //zero
+    int64_t SourceBytes;    //size of the image it was made from
+    int64_t SourceTime;     //modification time of that image
+};
+
+/******************************* Constants **********************************/
+
+//First bytes of every .cube file.
+static const char CubeMagic[4] = { 'S', 'S', 'C', 'B' };
+
+//Bumped whenever the layout or the conversion changes.
+static const uint32_t CubeVersion = 1;
+
+/*************************** Function Prototypes *****************************/
+
+static void FaceDirection( int face, float s, float t, float direction[3] );
+static void SampleImage( const byte* image, int cols, int rows, float s,
+                         float t, byte* texel );
+
+
+
+/******************************************************************************
+* Author: Savoy Schuler and Daniel Hodgin
+*
+* Function: CubeFaceSize
+*
+* Description:
+*
+*   Returns the texels on each side of the faces made from an image: a
+*   quarter of the way around the image, rounded up to a power of two, so
+*   the faces are at least as fine as the image.
+*
+* Parameters:
+*
+*   cols        - columns in the image
+*
+*   maxSize     - largest face size allowed
+*
+******************************************************************************/
+int CubeFaceSize( int cols, int maxSize )
+{
+    int size = 1;
+    while ( size < cols / 4 && size < maxSize )
+        size *= 2;
+
+    return size;
+}
+
+
+
+/******************************************************************************
+* Author: Savoy Schuler and Daniel Hodgin
+*
+* Function: BuildCubeMap
+*
+* Description:
+*
+*   This function turns an equirectangular image into the six faces of a
+*   cube map, in the order of the cube map face targets. Each texel takes
+*   the image's color in its direction. The faces are returned in a new
+*   array, which the caller deletes.
+*
+* Parameters:
+*
+*   image       - RGB image, rows padded to 4 bytes
+*
+*   cols, rows  - size of the image
+*
+*   size        - texels on each side of a face
+*
+******************************************************************************/
+byte* BuildCubeMap( const byte* image, int cols, int rows, int size )
+{
+    byte* faces = new byte[6 * 3 * ( size_t ) size * size];
+    byte* texel = faces;
+
+    for ( int face = 0; face < 6; face++ )
+    {
+        for ( int j = 0; j < size; j++ )
+        {
+            for ( int i = 0; i < size; i++ )
+            {
+                float direction[3];
+                FaceDirection( face, ( i + 0.5 ) / size, ( j + 0.5 ) / size,
+                               direction );
+
+                /*Texture coordinates the sphere had in this direction: s
+                runs back around the z axis from +y, t down from the +z pole.*/
+                float length = sqrt( direction[0] * direction[0] +
+                                     direction[1] * direction[1] +
+                                     direction[2] * direction[2] );
+                float theta = atan2( direction[0], direction[1] );
+                float rho = acos( direction[2] / length );
+
+                SampleImage( image, cols, rows, -theta / ( 2.0 * PI ),
+                             1.0 - rho / PI, texel );
+                texel += 3;
+            }
+        }
+    }
+
+    return faces;
+}
+
+
+
+/******************************************************************************
+* Author: Savoy Schuler and Daniel Hodgin
+*
+* Function: FaceDirection
+*
+* Description:
+*
+*   This function finds the direction a cube map texel is looked up from,
+*   as OpenGL chooses faces and face coordinates.
+*
+* Parameters:
+*
+*   face        - 0 to 5, for +x, -x, +y, -y, +z and -z
+*
+*   s, t        - coordinates on the face, 0 to 1
+*
+*   direction   - set to the direction, not of unit length
+*
+******************************************************************************/
+static void FaceDirection( int face, float s, float t, float direction[3] )
+{
+    float sc = 2.0 * s - 1.0;
+    float tc = 2.0 * t - 1.0;
+
+    switch ( face )
+    {
+        case 0: direction[0] = 1.0;  direction[1] = -tc;  direction[2] = -sc;
+            break;
+        case 1: direction[0] = -1.0; direction[1] = -tc;  direction[2] = sc;
+            break;
+        case 2: direction[0] = sc;   direction[1] = 1.0;  direction[2] = tc;
+            break;
+        case 3: direction[0] = sc;   direction[1] = -1.0; direction[2] = -tc;
+            break;
+        case 4: direction[0] = sc;   direction[1] = -tc;  direction[2] = 1.0;
+            break;
+        default: direction[0] = -sc; direction[1] = -tc;  direction[2] = -1.0;
+            break;
+    }
+}
+
+
+
+/******************************************************************************
+* Author: Savoy Schuler and Daniel Hodgin
+*
+* Function: SampleImage
+*
+* Description:
+*
+*   This function looks up an image at texture coordinates with linear
+*   filtering, as OpenGL would: wrapping around in s and clamped in t.
+*
+* Parameters:
+*
+*   image       - RGB image, rows padded to 4 bytes
+*
+*   cols, rows  - size of the image
+*
+*   s, t        - texture coordinates
+*
+*   texel       - set to the RGB color found
+*
+******************************************************************************/
+static void SampleImage( const byte* image, int cols, int rows, float s,
+                         float t, byte* texel )
+{
+    int rowBytes = ( 3 * cols + 3 ) & ~3;
+
+    //Texel centers are at half texels.
+    float x = ( s - floor( s ) ) * cols - 0.5;
+    float y = t * rows - 0.5;
+
+    if ( y < 0.0 )
+        y = 0.0;
+    if ( y > rows - 1 )
+        y = rows - 1;
+
+    int x0 = ( int ) floor( x );
+    int y0 = ( int ) y;
+    float fx = x - x0;
+    float fy = y - y0;
+
+    int x1 = ( x0 + 1 ) % cols;
+    int y1 = y0 + 1 < rows ? y0 + 1 : y0;
+    x0 = ( x0 + cols ) % cols;
+
+    const byte* row0 = image + y0 * rowBytes;
+    const byte* row1 = image + y1 * rowBytes;
+
+    for ( int c = 0; c < 3; c++ )
+    {
+        float bottom = row0[3 * x0 + c] * ( 1.0 - fx ) + row0[3 * x1 + c] * fx;
+        float top = row1[3 * x0 + c] * ( 1.0 - fx ) + row1[3 * x1 + c] * fx;
+
+        texel[c] = ( byte ) ( bottom * ( 1.0 - fy ) + top * fy + 0.5 );
+    }
+}
+
+
+
+/******************************************************************************
+* Author: Savoy Schuler and Daniel Hodgin
+*
+* Function: CubeCacheName
+*
+* Description:
+*
+*   Returns the name of an image's .cube file: the image's name with its
+*   extension replaced.
+*
+* Parameters:
+*
+*   filename    - .bmp texture map
+*
+******************************************************************************/
+string CubeCacheName( const string &filename )
+{
+    size_t dot = filename.rfind( '.' );
+    size_t slash = filename.rfind( '/' );
+
+    if ( dot == string::npos || ( slash != string::npos && dot < slash ) )
+        return filename + ".cube";
+
+    return filename.substr( 0, dot ) + ".cube";
+}
+
+
+
+/******************************************************************************
+* Author: Savoy Schuler and Daniel Hodgin
+*
+* Function: ReadCubeCache
+*
+* Description:
+*
+*   This function reads the faces saved for an image, in a new array the
+*   caller deletes. Returns NULL if there is no .cube file, or it is not
+*   whole, was made from another version of the image, or has faces larger
+*   than OpenGL allows. If the image itself is gone the .cube file is used
+*   as it is.
+*
+* Parameters:
+*
+*   filename    - .bmp texture map
+*
+*   maxSize     - largest face size allowed
+*
+*   size        - set to the texels on each side of a face
+*
+******************************************************************************/
+byte* ReadCubeCache( const string &filename, int maxSize, int &size )
+{
+    FILE *file = fopen( CubeCacheName( filename ).c_str(), "rb" );
+    if ( file == NULL )
+        return NULL;
+
+    CubeHeader header;
+    struct stat source;
+
+    bool valid = fread( &header, sizeof( header ), 1, file ) == 1 &&
+                 memcmp( header.Magic, CubeMagic, 4 ) == 0 &&
+                 header.Version == CubeVersion &&
+                 header.Size > 0 && header.Size <= ( uint32_t ) maxSize;
+
+    if ( valid && stat( filename.c_str(), &source ) == 0 )
+        valid = header.SourceBytes == ( int64_t ) source.st_size &&
+                header.SourceTime == ( int64_t ) source.st_mtime;
+
+    if ( !valid )
+    {
+        fclose( file );
+        return NULL;
+    }
+
+    size = header.Size;
+    size_t bytes = 6 * 3 * ( size_t ) size * size;
+    byte* faces = new byte[bytes];
+
+    if ( fread( faces, 1, bytes, file ) != bytes )
+    {
+        delete [] faces;
+        faces = NULL;
+    }
+
+    fclose( file );
+    return faces;
+}
+
+
+
+/******************************************************************************
+* Author: Savoy Schuler and Daniel Hodgin
+*
+* Function: WriteCubeCache
+*
+* Description:
+*
+*   This function saves the faces made from an image to its .cube file. The
+*   file is written under a temporary name and renamed when whole, so an
+*   interrupted write leaves no broken .cube file behind. Failing to write
+*   it only costs making the faces again next time.
+*
+* Parameters:
+*
+*   filename    - .bmp texture map the faces were made from
+*
+*   faces       - the six faces
+*
+*   size        - texels on each side of a face
+*
+******************************************************************************/
+void WriteCubeCache( const string &filename, const byte* faces, int size )
+{
+    struct stat source;
+    if ( stat( filename.c_str(), &source ) != 0 )
+        return;
+
+    CubeHeader header;
+    memset( &header, 0, sizeof( header ) );
+    memcpy( header.Magic, CubeMagic, 4 );
+    header.Version = CubeVersion;
+    header.Size = size;
+    header.SourceBytes = source.st_size;
+    header.SourceTime = source.st_mtime;
+
+    string name = CubeCacheName( filename );
+    string temporary = name + ".tmp";
+
+    FILE *file = fopen( temporary.c_str(), "wb" );
+    if ( file == NULL )
+    {
+        fprintf( stderr, "WriteCubeCache(): unable to write %s\n",
+                 temporary.c_str() );
+        return;
+    }
+
+    size_t bytes = 6 * 3 * ( size_t ) size * size;
+    bool written = fwrite( &header, sizeof( header ), 1, file ) == 1 &&
+                   fwrite( faces, 1, bytes, file ) == bytes;
+
+    if ( fclose( file ) != 0 || !written ||
+            rename( temporary.c_str(), name.c_str() ) != 0 )
+    {
+        fprintf( stderr, "WriteCubeCache(): unable to write %s\n",
+                 name.c_str() );
+        remove( temporary.c_str() );
+    }
+}
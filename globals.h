@@ -16,28 +16,170 @@
 
 /***************************** File Includes *********************************/
 
+#include <vector>
 #include "Planet.h"
 
 /******************************** Type Def ***********************************/
 
 typedef unsigned char byte;
 
+//Most mipmap levels of one texture map (enough for 32768 x 32768).
+const int MaxTextureLevels = 16;
+
+//A texture map's mipmap levels, largest first, each RGB rows padded to 4
+//bytes (see mipmaps.cpp).
+struct TextureLevels
+{
+    int Cols;                           //columns in the largest level
+    int Rows;                           //rows in the largest level
+    int Levels;                         //number of levels
+    const byte* Level[MaxTextureLevels];    //start of each level
+};
+
+//Part of a texture object holding a texture map, as the scale and offset
+//taking texture coordinates of the map there (see atlas.cpp).
+struct TextureWindow
+{
+    GLfloat Scale[2];       //s and t scale
+    GLfloat Offset[2];      //s and t offset
+};
+
+//Window of a texture map filling its own texture object.
+const TextureWindow WholeTexture = { { 1.0, 1.0 }, { 0.0, 0.0 } };
+
+//Material properties of a body, and its color when lighting is off.
+struct Material
+{
+    GLfloat Color[4];       //object color
+    GLfloat Ambient[4];     //ambient reflection
+    GLfloat Diffuse[4];     //diffuse reflection
+    GLfloat Specular[4];    //specular reflection
+    GLfloat Emission[4];    //light given off
+    GLfloat Shininess;      //specular exponent
+};
+
+//One belt member as drawn this frame, read by instanced drawing as
+//per-instance vertex data (see belts.cpp).
+struct BeltInstance
+{
+    GLfloat Position[3];    //center in solar system coordinates
+    GLfloat Radius;         //radius as drawn
+    GLfloat Tint[4];        //brightness the belt's material is scaled by
+};
+
+//Counters gathered while drawing a frame (see stats.cpp).
+struct FrameStatistics
+{
+    int Triangles;      //triangles drawn in sphere and ring meshes
+    int BodiesDrawn;    //bodies inside the view frustum
+    int BodiesCulled;   //bodies skipped by frustum culling
+    int OrbitsDrawn;    //orbital paths inside the view frustum
+    int OrbitsCulled;   //orbital paths skipped by frustum culling
+    int StateCalls;     //OpenGL state changes made (see glstate.cpp)
+    int StateCallsElided;   //state changes dropped as changing nothing
+    int LabelsDrawn;    //body names drawn (see labels.cpp)
+    int LabelsHidden;   //body names dropped for overlapping others
+    int BodiesShaded;   //bodies drawn by the shader renderer (see shaders.cpp)
+    int MembersDrawn;   //belt members drawn (see belts.cpp)
+    int MembersCulled;  //belt members outside the view frustum
+    int BeltDraws;      //draw calls made for belt members
+    int Impostors;      //bodies and members drawn as impostors
+};
+
+//Flags describing a body in the body table (see bodies.cpp).
+enum BodyFlags
+{
+    BodyBackdrop = 1,   //the sphere of stars around everything
+    BodyStar = 2,       //the sun, which lights the others
+    BodyPlanet = 4,     //orbits the sun
+    BodyMoon = 8,       //circles a planet
+    BodyRings = 16,     //rings around a planet
+    BodyBelt = 128      //swarm of small bodies around the sun (see belts.cpp)
+};
+
+//Orbit and spin phases of every body, as fractions of a turn.
+struct BodyPhases
+{
+    vector<float> PrevOrbit;    //orbit phase before the last step
+    vector<float> Orbit;        //orbit phase
+    vector<float> PrevSpin;     //spin phase before the last step
+    vector<float> Spin;         //spin phase
+    vector<float> PrevMember;   //orbit phase of each belt member before the
+                                //last step
+    vector<float> Member;       //orbit phase of each belt member
+};
+
+//Every celestial object, one row per body and one array per field.
+struct BodyTable
+{
+    vector<string> Name;        //body name
+    vector<float> HoursPerDay;  //body's hours in a day
+    vector<float> DaysPerYear;  //body's days in a year
+    vector<float> Radius;       //body's radius
+    vector<float> Distance;     //distance from the suns surface
+    vector<float> OrbitRate;    //orbit turns per Earth hour
+    vector<float> SpinRate;     //spin turns per hour
+    vector<unsigned> Flags;     //BodyFlags
+    vector<int> Parent;         //row of the body it circles, -1 for none
+    vector<int> Rows;           //rows in body's texture .bmp image
+    vector<int> Cols;           //columns in body's texture .bmp image
+    vector<byte*> Image;        //body's texture map read in from .bmp image
+    vector<GLuint> Texture;     //OpenGL texture object holding the texture map
+    vector<TextureWindow> Window;   //part of Texture holding the texture map
+    vector<int> Lod;            //level of detail the body was last drawn with
+    vector<GLfloat> R;          //red value (used for color when no texture map)
+    vector<GLfloat> G;          //green value
+    vector<GLfloat> B;          //blue value
+    BodyPhases Phases;          //phases drawn, copied from the simulation
+};
+
+//Commands sent from input to the simulation thread (see simulation.cpp).
+enum SimulationCommand
+{
+    CommandStartStop,   //start or stop the animation
+    CommandStep,        //step the animation once and pause
+    CommandSpeedUp,     //double the animation time step
+    CommandSpeedDown,   //halve the animation time step
+    CommandReset        //move the planets back to their starting positions
+};
+
 
 /******************************* Constants **********************************/
 
 //These three variables control the animation's state and speed.
 const float DistScale = 1.0/37.5;
 const float SizeScale = 1.0/15945.0;
+const float MoonDistScale = 1.0/1260.0;     //moon distances, from thousands of km
 const float PI = 3.14159265358979323846264;
 
+//Perspective projection set up in ResizeWindow.
+const float FieldOfView = 60.0;
+const float NearClip = 1.0;
+const float FarClip = 600.0;
+const float EyeDistance = 2.0;
+
+//Width of the orbital paths.
+const float OrbitWidth = 0.05;
+
+//Ambient, diffuse, and specular colors of the light at the sun.
+const GLfloat LightAmbient[4] = { 0.2, 0.2, 0.2, 1.0 };
+const GLfloat LightDiffuse[4] = { 1.0, 1.0, 1.0, 1.0 };
+const GLfloat LightSpecular[4] = { 1.0, 1.0, 1.0, 1.0 };
+
+//Label font (see font.cpp): the printable characters it holds, each one's
+//size in pixels, and its rows below the line the text sits on.
+const int FontFirstGlyph = 32;
+const int FontGlyphCount = 95;
+const int FontGlyphWidth = 9;
+const int FontGlyphHeight = 16;
+const int FontDescent = 4;
+
 
 /*************************** Global Variables *****************************/
 
 /* Externs defined in callbacks.cpp: */
 //Mode booleans
-extern GLenum spinMode;
-extern GLenum singleStep;
-extern bool light, shade, wire, paths, planetNames, textureToggle;
+extern bool light, shade, wire, paths, planetNames, textureToggle, showStats;
 
 //Planet variables
 extern float HourOfDay;
@@ -45,9 +187,6 @@ extern float DayOfYear;
 extern float MercuryHour;
 extern float MercuryDay;
 
-// Time step for animation (hours)
-extern float AnimateIncrement;
-
 //Camera controls
 extern float Xpan;
 extern float Ypan;
@@ -55,12 +194,48 @@ extern float Zpan;
 extern float Xrot;
 extern float Yrot;
 extern float Zrot;
+extern int ScreenWidth;
 extern int ScreenHeight;
 extern bool MouseClicked;
 
 //Resolution toggling
 extern int Resolution;
 
+/* Externs defined in bodies.cpp: */
+extern BodyTable Bodies;
+
+/* Externs defined in catalog.cpp: */
+extern string CatalogFile;
+
+/* Externs defined in pack.cpp: */
+extern string PackFile;
+
+/* Externs defined in assets.cpp: */
+extern size_t TextureBudget;
+
+/* Externs defined in stats.cpp: */
+extern FrameStatistics FrameStats;
+
+/* Externs defined in scheduler.cpp: */
+extern float FrameBlend;
+extern int FrameRateCap;
+
+/* Externs defined in shaders.cpp: */
+extern bool UseShaders;
+
+/* Externs defined in lod.cpp: */
+extern float ImpostorPixels;
+
+/* Externs defined in font.cpp: */
+extern const unsigned short FontGlyphs[FontGlyphCount][FontGlyphHeight];
+
+/* Externs defined in headless.cpp: */
+extern int HeadlessFrames;
+extern int HeadlessWidth;
+extern int HeadlessHeight;
+extern float HeadlessStep;
+extern string HeadlessOutput;
+
 
 /*************************** Function Prototypes *****************************/
 
@@ -73,7 +248,7 @@ void ResizeWindow( int w, int h );
 
 //Cycle functions
 void Animate( void );
-void SetCelestialBodies();
+bool DrawFrame( void );
 
 //Key press functions and handling
 void KeyPressFunc( unsigned char Key, int x, int y );
@@ -108,39 +283,337 @@ void SubMenuHandlerOptions ( int item );
 
 //Main functions.
 
-//Create auxiliary planet objects Rings and Moon.
-void SetRingsandMoon();
-
 //Set light source.
 void SetLightModel();
 
 //Set object material properties.
-void SetSunMatProp(Planet *sun);
-void SetPlanetMatProps(Planet *plant);
-void SetMoonMatProps(Planet *Moon);
-void SetRingsMatProps(Planet *Rings);
+void GetMatProps(int body, Material &material);
+void SetMatProps(const Material &material);
+void GetSunMatProp(int sun, Material &material);
+void GetPlanetMatProps(int planet, Material &material);
+void GetMoonMatProps(int moon, Material &material);
+void GetRingsMatProps(int rings, Material &material);
 void SetOrbitMatProps();
 
 //Draw objects.
-void DrawSpace (Planet *space);
-void DrawSun (Planet *sun);
-void DrawPlanet(Planet *plant);
-void DrawMoon (int DayOfYear);
-void DrawRings (double planetRadius);
-void DrawOrbit(double planetDistance);
-void DrawTextString ( string str, double radius);
+void DrawSpace (int space);
+void DrawSun (int sun);
+void DrawPlanet(int planet);
+void DrawMoon (int moon);
+void DrawRings (int rings);
+void DrawBodySphere (int body, const float position[3], float radius);
+void DrawOrbits();
+void DrawTextString ( const string &str, const float position[3],
+                      double radius, bool below);
 
 
-//Set up texture map.
-int SetTexture( byte* image, int rows, int ncols );
-
 //Helper functions
 
-//Handle user view.
-void HandleRotate();
+//Find planet positions and sizes.
+float GetOrbitRadius(int planet);
+void GetPlanetPosition(int planet, float position[3]);
+float GetPlanetExtent(int planet);
+
+
+/* Located in textures.cpp in order: */
+
+//Create texture objects.
+int CreateTextureLevels( int body, const TextureLevels &levels );
+void DeleteTexture( int body, int cell );
+
+//Bind texture objects.
+void SetTexture( int body );
+void BindTexture( GLuint texture );
+void SetTextureWindow( const TextureWindow &window );
+bool BodyTextured( int body );
+
+
+
+/* Located in glstate.cpp in order: */
+
+//Cached state.
+void SetCapability( GLenum capability, bool enabled );
+void SetTextureMode( GLint mode );
+void SetMaterial( GLenum face, GLenum name, const GLfloat *value );
+void SetColor( GLfloat red, GLfloat green, GLfloat blue );
+void SetLight( GLenum name, const GLfloat *value );
+void ForgetGLState();
+void CountStateCall( bool issued );
+
+
+
+/* Located in labels.cpp in order: */
+
+//Font texture.
+void LoadLabelFont();
+
+//Queue and draw labels.
+void QueueLabel( const string &text, const float world[3] );
+void DrawLabels();
+
+
+
+/* Located in camera.cpp in order: */
+
+//Update camera.
+void UpdateCamera();
+
+//View matrix.
+const GLfloat* GetViewMatrix();
+void LoadViewMatrix();
+void LoadViewRotation();
+void GetProjectionMatrix( GLfloat matrix[16] );
+
+//Eye space helpers.
+void EyePosition( const float world[3], float eye[3] );
+void CameraPosition( float world[3] );
+float ProjectedRadius( const float world[3], float radius );
+float PixelsPerUnit( float distance );
+bool SphereInView( const float world[3], float radius );
+bool WindowPosition( const float world[3], float window[3] );
+
+
+
+/* Located in transforms.cpp in order: */
+
+//Update transforms.
+void UpdateTransforms();
+
+//Use transforms.
+void LoadTransform( int body );
+const GLfloat* TransformMatrix( int body );
+void TransformPosition( int body, float position[3] );
+float TransformAngle( int body );
+
+
+
+/* Located in shaders.cpp in order: */
+
+//Start the shader renderer.
+bool StartShaders();
+
+//Frame data.
+void UploadFrameData();
+
+//Draw bodies.
+bool DrawShadedSphere( int body, float radius, int resolution );
+bool DrawShadedRings( int rings, float inner, float outer, int slices );
+bool DrawShadedMembers( int belt, GLuint instances, int first, int count,
+                        int resolution );
+bool DrawShadedImpostor( int body, float radius );
+bool DrawShadedImpostors( int belt, GLuint instances, int first, int count );
+bool MembersShaded( int belt );
+void StopShading();
+
+
+
+/* Located in belts.cpp in order: */
+
+//Build belts.
+void AddBelt( int belt, int members, float width );
+
+//Update belts.
+void UpdateBelts( BodyPhases &phases, float hours );
+
+//Draw belts.
+void DrawBelt( int belt );
+
+
+
+/* Located in headless.cpp in order: */
+
+//Run headless.
+int RunHeadless();
+
+
+
+/* Located in lod.cpp in order: */
+
+//Select level of detail.
+int SelectLod( int body, const float position[3], float radius );
+int LodLevelCount();
+int LodLevel( float pixelRadius );
+int LodResolution( int level );
+
+//Impostors.
+bool ImpostorSized( float pixelRadius );
+
+
+
+/* Located in bodies.cpp in order: */
+
+//Build the table.
+int AddBody( string name, int hours, int days, int radius, int distance,
+             int nrows, int ncols, byte* image, GLfloat r, GLfloat g,
+             GLfloat b, unsigned flags );
+void ReserveBodies( int count );
+int BodyCount();
+
+//Update phases.
+void UpdateBodies( BodyPhases &phases, float hours );
+void ResetBodies( BodyPhases &phases );
+
+//Blended phases.
+float OrbitPhase( int body );
+float SpinPhase( int body );
+
+
+
+/* Located in catalog.cpp in order: */
+
+//Load catalog.
+bool LoadCatalog( const char *filename );
+
+
+
+/* Located in mipmaps.cpp in order: */
+
+//Build mipmaps.
+int NearestPower( int value );
+byte* BuildMipmaps( const byte* image, int cols, int rows,
+                    TextureLevels &levels );
+
+
+
+/* Located in atlas.cpp in order: */
+
+//Place texture maps.
+int AddToAtlas( const TextureLevels &levels, TextureWindow &window );
+void RemoveFromAtlas( int cell );
+GLuint AtlasTexture();
+
+
+
+/* Located in pack.cpp in order: */
+
+//Open the pack.
+bool OpenTexturePack( const char *filename );
+
+//Find texture maps.
+bool FindPackedTexture( const char *name, TextureLevels &levels );
+bool FindPackedTiles( const char *name, TextureLevels &levels );
+const byte* FindPackedCube( const char *name, int &size );
+
+//Read pages.
+void PrefetchPack( const byte* start, size_t bytes );
+bool PackResident( const byte* start, size_t bytes );
+
+
+
+/* Located in assets.cpp in order: */
+
+//Register and request textures.
+void RegisterTexture( const char *filename, int body );
+void RequestTexture( int body );
+void RequestSkybox( int body, bool packed );
+
+//Start/stop the workers.
+void StartAssetLoader();
+void StopAssetLoader();
+
+//Upload and evict textures.
+bool UploadAssets();
+bool AssetsPending();
+bool AssetsReady();
+bool TexturesLoading();
+void PrefetchAssets();
+int ResidentTextures();
+size_t ResidentTextureBytes();
+
+
+
+/* Located in skybox.cpp in order: */
+
+//Register and draw skyboxes.
+void RegisterSkybox( const char *filename, int body );
+void DrawSkybox( int body );
+
+//Load skyboxes.
+void LoadSkybox( int body );
+void UploadSkybox( int body );
+
+
+
+/* Located in cubemap.cpp in order: */
+
+//Make cube maps.
+int CubeFaceSize( int cols, int maxSize );
+byte* BuildCubeMap( const byte* image, int cols, int rows, int size );
+
+//Cube map cache.
+string CubeCacheName( const string &filename );
+byte* ReadCubeCache( const string &filename, int maxSize, int &size );
+void WriteCubeCache( const string &filename, const byte* faces, int size );
+
+
+
+/* Located in vtexture.cpp in order: */
+
+//Register virtual textures.
+bool RegisterVirtualTexture( const char *filename, int body );
+bool VirtualTextured( int body );
+
+//Draw virtual textures.
+bool DrawVirtualSphere( int body, const float position[3], float angle,
+                        float radius, int resolution );
+
+//Request and upload tiles.
+bool UploadTiles();
+bool TilesPending();
+bool TilesReady();
+void PrefetchTiles();
+int ResidentTiles();
+
+
+
+/* Located in scheduler.cpp in order: */
+
+//Take simulation snapshots.
+void TakeSnapshot();
+
+//Schedule frames.
+void ScheduleNextFrame();
+
+
+
+/* Located in simulation.cpp in order: */
+
+//Start/stop the thread.
+void StartSimulation();
+void StopSimulation();
+
+//Command queue.
+bool SendSimulationCommand( SimulationCommand command );
+
+//Snapshot handoff.
+bool ConsumeSnapshot();
+bool SimulationRunning();
+bool SimulationPending();
+double SnapshotAge();
+
+
+
+/* Located in stats.cpp in order: */
+
+//Frame statistics.
+void ResetFrameStats();
+void ReportFrameStats();
+
+
+
+/* Located in meshes.cpp in order: */
+
+//Draw sphere meshes.
+void DrawSphere( float radius, int resolution );
+void DrawUnitSphere( int resolution );
+void DrawUnitSpheres( int resolution, int count );
+
+//Draw orbit meshes.
+void DrawOrbitMeshes( const vector<int> &bodies );
+
+//Ring meshes.
+void DrawRingMesh( int rings, float inner, float outer, int slices );
 
-//Convert image string files names to character arrays).
-char* StringToChar (string str);
 
 
 /* Located in bmpRead.cpp in order: */
@@ -0,0 +1,424 @@
+/******************************************************************************
+*	File: glstate.cpp
+*
+*	Authors: Savoy Schuler and Daniel Hodgin
+*
+*	Date: 11-17-16
+*
+*	Description:
+*
+*		This file contains the OpenGL state cache. The draw functions set the
+*       same capabilities, texture mode, material and light every time they
+*       draw a body, most of them unchanged since the body before. Setting
+*       them through here keeps a copy of what OpenGL was last given and
+*       drops calls that would change nothing, which on software OpenGL saves
+*       real time. Calls issued and dropped are counted in FrameStats.
+*
+*       Texture binds and the texture matrix are cached the same way by
+*       BindTexture and SetTextureWindow (see textures.cpp).
+*
+*       All changes to the state cached here must go through this file, or
+*       the copy is wrong. ForgetGLState makes the next call of each kind be
+*       issued again, for after something else has changed OpenGL's state.
+*
+*	File Order and Structure:
+*
+*       - Cached state.
+*       - Compare values.
+*
+*	Modified:
+*
+*		Original
+*
+*	Functions Included:
+*
+*           //Cached state.
+*
+*       void SetCapability( GLenum capability, bool enabled );
+*       void SetTextureMode( GLint mode );
+*       void SetMaterial( GLenum face, GLenum name, const GLfloat *value );
+*       void SetColor( GLfloat red, GLfloat green, GLfloat blue );
+*       void SetLight( GLenum name, const GLfloat *value );
+*       void ForgetGLState();
+*       void CountStateCall( bool issued );
+*
+*           //Compare values.
+*
+*       static bool SameValue( const GLfloat *a, const GLfloat *b, int count );
+*
+******************************************************************************/
+
+/**************************** Library Includes *******************************/
+#include <cstdlib>
+#include <cstring>
+#include <GL/freeglut.h>
+#include <iostream>
+#include <string>
+#include "Planet.h"
+#include "globals.h"
+
+/******************************* Name Space **********************************/
+
+using namespace std;
+
+/******************************** Type Def ***********************************/
+
+//Last value given to OpenGL for one piece of state.
+struct CachedValue
+{
+    bool Known;             //set once a value has been given
+    GLfloat Value[4];       //the value given
+};
+
+/******************************* Constants **********************************/
+
+//Capabilities cached. Others are passed straight through.
+static const GLenum Capabilities[] =
+{
+    GL_LIGHTING, GL_LIGHT0, GL_TEXTURE_2D, GL_DEPTH_TEST, GL_CULL_FACE,
+    GL_NORMALIZE, GL_POLYGON_OFFSET_FILL, GL_ALPHA_TEST, GL_TEXTURE_CUBE_MAP,
+    GL_POINT_SPRITE, GL_PROGRAM_POINT_SIZE
+};
+
+static const int CapabilityCount = sizeof( Capabilities ) /
+                                   sizeof( Capabilities[0] );
+
+//Material properties cached, and the floats in each.
+static const GLenum MaterialNames[] =
+{
+    GL_AMBIENT, GL_DIFFUSE, GL_SPECULAR, GL_EMISSION, GL_SHININESS
+};
+
+static const int MaterialSizes[] = { 4, 4, 4, 4, 1 };
+
+static const int MaterialCount = sizeof( MaterialNames ) /
+                                 sizeof( MaterialNames[0] );
+
+//Light properties cached for GL_LIGHT0. The position is not: OpenGL
+//transforms it by the modelview matrix, so it is set again each frame.
+static const GLenum LightNames[] = { GL_AMBIENT, GL_DIFFUSE, GL_SPECULAR };
+
+static const int LightCount = sizeof( LightNames ) / sizeof( LightNames[0] );
+
+/********************************* Globals ***********************************/
+
+//State of each capability, Value[0] nonzero if enabled.
+static CachedValue CapabilityState[CapabilityCount];
+
+//GL_TEXTURE_ENV_MODE.
+static CachedValue TextureMode;
+
+//Material properties of the front and back faces.
+static CachedValue MaterialState[2][MaterialCount];
+
+//Current color.
+static CachedValue Color;
+
+//Properties of GL_LIGHT0.
+static CachedValue LightState[LightCount];
+
+/*************************** Function Prototypes *****************************/
+
+static bool SameValue( const GLfloat *a, const GLfloat *b, int count );
+
+
+
+/******************************************************************************
+* Author: Savoy Schuler and Daniel Hodgin
+*
+* Function: SetCapability
+*
+* Description:
+*
+*   This function enables or disables an OpenGL capability, unless it is
+*   already so.
+*
+* Parameters:
+*
+*   capability  - capability to change, as for glEnable
+*
+*   enabled     - true to enable it, false to disable it
+*
+******************************************************************************/
+void SetCapability( GLenum capability, bool enabled )
+{
+    GLfloat value = enabled ? 1.0 : 0.0;
+
+    for ( int i = 0; i < CapabilityCount; i++ )
+    {
+        if ( Capabilities[i] != capability )
+            continue;
+
+        CachedValue &state = CapabilityState[i];
+        if ( state.Known && state.Value[0] == value )
+        {
+            CountStateCall( false );
+            return;
+        }
+
+        state.Known = true;
+        state.Value[0] = value;
+        break;
+    }
+
+    enabled ? glEnable( capability ) : glDisable( capability );
+    CountStateCall( true );
+}
+
+
+
+/******************************************************************************
+* Author: Savoy Schuler and Daniel Hodgin
+*
+* Function: SetTextureMode
+*
+* Description:
+*
+*   This function sets how texture maps combine with the lit color
+*   (GL_TEXTURE_ENV_MODE), unless it is already set so.
+*
+* Parameters:
+*
+*   mode    - GL_MODULATE, GL_REPLACE or another texture environment mode
+*
+******************************************************************************/
+void SetTextureMode( GLint mode )
+{
+    if ( TextureMode.Known && TextureMode.Value[0] == mode )
+    {
+        CountStateCall( false );
+        return;
+    }
+
+    glTexEnvi( GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, mode );
+    TextureMode.Known = true;
+    TextureMode.Value[0] = mode;
+    CountStateCall( true );
+}
+
+
+
+/******************************************************************************
+* Author: Savoy Schuler and Daniel Hodgin
+*
+* Function: SetMaterial
+*
+* Description:
+*
+*   This function sets a material property, as glMaterialfv, unless each
+*   face it is set for already has that value. GL_SHININESS takes one float,
+*   the colors four.
+*
+* Parameters:
+*
+*   face    - GL_FRONT, GL_BACK or GL_FRONT_AND_BACK
+*
+*   name    - material property to set
+*
+*   value   - its new value
+*
+******************************************************************************/
+void SetMaterial( GLenum face, GLenum name, const GLfloat *value )
+{
+    int property = 0;
+    while ( property < MaterialCount && MaterialNames[property] != name )
+        property++;
+
+    if ( property == MaterialCount )
+    {
+        glMaterialfv( face, name, value );
+        CountStateCall( true );
+        return;
+    }
+
+    int size = MaterialSizes[property];
+    bool front = face != GL_BACK;
+    bool back = face != GL_FRONT;
+    CachedValue &frontState = MaterialState[0][property];
+    CachedValue &backState = MaterialState[1][property];
+
+    bool same = ( !front || ( frontState.Known &&
+                              SameValue( frontState.Value, value, size ) ) ) &&
+                ( !back || ( backState.Known &&
+                             SameValue( backState.Value, value, size ) ) );
+    if ( same )
+    {
+        CountStateCall( false );
+        return;
+    }
+
+    glMaterialfv( face, name, value );
+    CountStateCall( true );
+
+    if ( front )
+    {
+        frontState.Known = true;
+        memcpy( frontState.Value, value, size * sizeof( GLfloat ) );
+    }
+
+    if ( back )
+    {
+        backState.Known = true;
+        memcpy( backState.Value, value, size * sizeof( GLfloat ) );
+    }
+}
+
+
+
+/******************************************************************************
+* Author: Savoy Schuler and Daniel Hodgin
+*
+* Function: SetColor
+*
+* Description:
+*
+*   This function sets the current color, as glColor3f, unless it is
+*   already that color.
+*
+* Parameters:
+*
+*   red, green, blue    - the new color
+*
+******************************************************************************/
+void SetColor( GLfloat red, GLfloat green, GLfloat blue )
+{
+    GLfloat color[4] = { red, green, blue, 1.0 };
+
+    if ( Color.Known && SameValue( Color.Value, color, 4 ) )
+    {
+        CountStateCall( false );
+        return;
+    }
+
+    glColor3f( red, green, blue );
+    Color.Known = true;
+    memcpy( Color.Value, color, sizeof( color ) );
+    CountStateCall( true );
+}
+
+
+
+/******************************************************************************
+* Author: Savoy Schuler and Daniel Hodgin
+*
+* Function: SetLight
+*
+* Description:
+*
+*   This function sets a color of the light at the sun, GL_LIGHT0, as
+*   glLightfv, unless it already has that value. Other light properties are
+*   passed straight through.
+*
+* Parameters:
+*
+*   name    - light property to set
+*
+*   value   - its new value
+*
+******************************************************************************/
+void SetLight( GLenum name, const GLfloat *value )
+{
+    for ( int i = 0; i < LightCount; i++ )
+    {
+        if ( LightNames[i] != name )
+            continue;
+
+        CachedValue &state = LightState[i];
+        if ( state.Known && SameValue( state.Value, value, 4 ) )
+        {
+            CountStateCall( false );
+            return;
+        }
+
+        state.Known = true;
+        memcpy( state.Value, value, 4 * sizeof( GLfloat ) );
+        break;
+    }
+
+    glLightfv( GL_LIGHT0, name, value );
+    CountStateCall( true );
+}
+
+
+
+/******************************************************************************
+* Author: Savoy Schuler and Daniel Hodgin
+*
+* Function: ForgetGLState
+*
+* Description:
+*
+*   This function forgets all cached state, so the next call setting each
+*   piece of it is issued to OpenGL.
+*
+* Parameters:
+*
+*		void	- No input parameters needed.
+*
+******************************************************************************/
+void ForgetGLState()
+{
+    for ( int i = 0; i < CapabilityCount; i++ )
+        CapabilityState[i].Known = false;
+
+    for ( int i = 0; i < MaterialCount; i++ )
+        MaterialState[0][i].Known = MaterialState[1][i].Known = false;
+
+    for ( int i = 0; i < LightCount; i++ )
+        LightState[i].Known = false;
+
+    TextureMode.Known = false;
+    Color.Known = false;
+}
+
+
+
+/******************************************************************************
+* Author: Savoy Schuler and Daniel Hodgin
+*
+* Function: CountStateCall
+*
+* Description:
+*
+*   This function counts a state change in the frame statistics, either as
+*   issued to OpenGL or as dropped because it would have changed nothing.
+*
+* Parameters:
+*
+*   issued  - true if the call was made, false if it was dropped
+*
+******************************************************************************/
+void CountStateCall( bool issued )
+{
+    if ( issued )
+        FrameStats.StateCalls++;
+    else
+        FrameStats.StateCallsElided++;
+}
+
+
+
+/******************************************************************************
+* Author: Savoy Schuler and Daniel Hodgin
+*
+* Function: SameValue
+*
+* Description:
+*
+*   Returns true if two values have the same floats.
+*
+* Parameters:
+*
+*   a, b    - values to compare
+*
+*   count   - floats in each
+*
+******************************************************************************/
+static bool SameValue( const GLfloat *a, const GLfloat *b, int count )
+{
+    for ( int i = 0; i < count; i++ )
+        if ( a[i] != b[i] )
+            return false;
+
+    return true;
+}
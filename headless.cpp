@@ -0,0 +1,374 @@
+/******************************************************************************
+*	File: headless.cpp
+*
+*	Authors: Savoy Schuler and Daniel Hodgin
+*
+*	Date: 11-17-16
+*
+*	Description:
+*
+*		This file contains the headless mode, for making animation frames on
+*       machines with no display. Instead of opening a GLUT window, an OpenGL
+*       context is made with EGL on Mesa's surfaceless platform, needing no X
+*       server, and the frames are drawn into a framebuffer object of the size
+*       asked for. The same DrawFrame as the window draws each frame, then
+*       its pixels are read back and written to a numbered PPM file.
+*
+*       There is no simulation thread: frame n shows the bodies n time steps
+*       of HeadlessStep hours after the start, so the frames are the same on
+*       every run, however fast they are drawn. A frame is drawn again until
+*       every texture map it needs has been decoded and uploaded, so no frame
+*       shows bodies in their plain color. Tiles are waited for too, but only
+*       while they keep arriving.
+*
+*	File Order and Structure:
+*
+*       - Run headless.
+*       - Offscreen context.
+*       - Frames.
+*
+*	Modified:
+*
+*		Original
+*
+*	Functions Included:
+*
+*           //Run headless.
+*
+*       int RunHeadless();
+*
+*           //Offscreen context.
+*
+*       static bool CreateContext();
+*       static bool CreateFramebuffer();
+*
+*           //Frames.
+*
+*       static void RenderFrame();
+*       static bool WriteFrame( int frame );
+*
+******************************************************************************/
+
+/**************************** Library Includes *******************************/
+#define GL_GLEXT_PROTOTYPES
+#include <chrono>
+#include <cstdlib>
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#include <fstream>
+#include <GL/freeglut.h>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "Planet.h"
+#include "globals.h"
+
+/******************************* Name Space **********************************/
+
+using namespace std;
+
+/******************************* Constants **********************************/
+
+//Milliseconds between checks for texture maps still being decoded.
+static const int AssetPollTime = 10;
+
+//Checks to wait for tiles before drawing the frame again without them. A
+//tile may never arrive, when the frame needs more tiles than the cache
+//holds.
+static const int TilePolls = 50;
+
+/********************************* Globals ***********************************/
+
+//Number of frames to draw headless, set by the -headless option. 0 opens
+//the window instead.
+int HeadlessFrames = 0;
+
+//Size of the frames, in pixels, set by the -size option.
+int HeadlessWidth = 1000;
+int HeadlessHeight = 1000;
+
+//Animation time between frames, in Earth hours, set by the -step option.
+float HeadlessStep = 0.5;
+
+//Start of the frames' file names, set by the -output option.
+string HeadlessOutput = "frame";
+
+//Pixels of the frame read back, bottom row first.
+static vector<unsigned char> FramePixels;
+
+/*************************** Function Prototypes *****************************/
+
+static bool CreateContext();
+static bool CreateFramebuffer();
+static void RenderFrame();
+static bool WriteFrame( int frame );
+
+
+
+/******************************************************************************
+* Author: Savoy Schuler and Daniel Hodgin
+*
+* Function: RunHeadless
+*
+* Description:
+*
+*   This function draws HeadlessFrames frames with no window and writes each
+*   to HeadlessOutput followed by its number and ".ppm", then prints how long
+*   they took. The catalog must be read and the asset loader started before
+*   it is called. Returns the program's exit status: 0 if every frame was
+*   written, or 1 if no offscreen context could be made or a frame could not
+*   be written.
+*
+* Parameters:
+*
+*		void	- No input parameters needed.
+*
+******************************************************************************/
+int RunHeadless()
+{
+    if ( !CreateContext() || !CreateFramebuffer() )
+        return 1;
+
+    //Set up OpenGL as for the window.
+    OpenGLInit();
+    ResizeWindow( HeadlessWidth, HeadlessHeight );
+
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+
+    for ( int frame = 0; frame < HeadlessFrames; frame++ )
+    {
+        //Each frame after the first is one step later.
+        if ( frame > 0 )
+            UpdateBodies( Bodies.Phases, HeadlessStep );
+
+        RenderFrame();
+
+        if ( !WriteFrame( frame ) )
+            return 1;
+    }
+
+    chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+
+    cout << HeadlessFrames << " frames of " << HeadlessWidth << "x"
+         << HeadlessHeight << " in " << elapsed.count() << " s ("
+         << HeadlessFrames / elapsed.count() << " fps)" << endl;
+
+    return 0;
+}
+
+
+
+/******************************************************************************
+* Author: Savoy Schuler and Daniel Hodgin
+*
+* Function: CreateContext
+*
+* Description:
+*
+*   This function makes an OpenGL context with no window or surface and makes
+*   it current. Mesa's surfaceless platform is used when EGL has it, so no
+*   display is needed; otherwise EGL's default display is tried. Returns
+*   false, after saying why, if there is no such context.
+*
+* Parameters:
+*
+*		void	- No input parameters needed.
+*
+******************************************************************************/
+static bool CreateContext()
+{
+    EGLDisplay display = EGL_NO_DISPLAY;
+
+    //Platform displays are an extension of EGL before 1.5.
+    PFNEGLGETPLATFORMDISPLAYEXTPROC getPlatformDisplay =
+        ( PFNEGLGETPLATFORMDISPLAYEXTPROC )
+        eglGetProcAddress( "eglGetPlatformDisplayEXT" );
+
+    if ( getPlatformDisplay != NULL )
+        display = getPlatformDisplay( EGL_PLATFORM_SURFACELESS_MESA,
+                                      EGL_DEFAULT_DISPLAY, NULL );
+
+    if ( display == EGL_NO_DISPLAY )
+        display = eglGetDisplay( EGL_DEFAULT_DISPLAY );
+
+    if ( display == EGL_NO_DISPLAY || !eglInitialize( display, NULL, NULL ) )
+    {
+        cerr << "CreateContext(): no EGL display" << endl;
+        return false;
+    }
+
+    //Any configuration drawing with desktop OpenGL will do, as frames are
+    //drawn into a framebuffer object.
+    static const EGLint configAttributes[] =
+    {
+        EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+        EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+        EGL_NONE
+    };
+
+    EGLConfig config;
+    EGLint configs = 0;
+
+    if ( !eglBindAPI( EGL_OPENGL_API ) ||
+            !eglChooseConfig( display, configAttributes, &config, 1,
+                              &configs ) || configs == 0 )
+    {
+        cerr << "CreateContext(): EGL has no desktop OpenGL" << endl;
+        return false;
+    }
+
+    EGLContext context = eglCreateContext( display, config, EGL_NO_CONTEXT,
+                                           NULL );
+
+    if ( context == EGL_NO_CONTEXT ||
+            !eglMakeCurrent( display, EGL_NO_SURFACE, EGL_NO_SURFACE,
+                             context ) )
+    {
+        cerr << "CreateContext(): no OpenGL context without a surface" << endl;
+        return false;
+    }
+
+    return true;
+}
+
+
+
+/******************************************************************************
+* Author: Savoy Schuler and Daniel Hodgin
+*
+* Function: CreateFramebuffer
+*
+* Description:
+*
+*   This function makes a framebuffer object of HeadlessWidth by
+*   HeadlessHeight pixels, with a color and a depth buffer, and binds it for
+*   drawing and reading. It stays bound, as the window's framebuffer would.
+*   Returns false, after saying why, if OpenGL can not draw to it.
+*
+* Parameters:
+*
+*		void	- No input parameters needed.
+*
+******************************************************************************/
+static bool CreateFramebuffer()
+{
+    GLuint framebuffer, color, depth;
+
+    glGenFramebuffers( 1, &framebuffer );
+    glBindFramebuffer( GL_FRAMEBUFFER, framebuffer );
+
+    glGenRenderbuffers( 1, &color );
+    glBindRenderbuffer( GL_RENDERBUFFER, color );
+    glRenderbufferStorage( GL_RENDERBUFFER, GL_RGBA8, HeadlessWidth,
+                           HeadlessHeight );
+    glFramebufferRenderbuffer( GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0,
+                               GL_RENDERBUFFER, color );
+
+    glGenRenderbuffers( 1, &depth );
+    glBindRenderbuffer( GL_RENDERBUFFER, depth );
+    glRenderbufferStorage( GL_RENDERBUFFER, GL_DEPTH_COMPONENT24,
+                           HeadlessWidth, HeadlessHeight );
+    glFramebufferRenderbuffer( GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT,
+                               GL_RENDERBUFFER, depth );
+
+    glBindRenderbuffer( GL_RENDERBUFFER, 0 );
+
+    if ( glCheckFramebufferStatus( GL_FRAMEBUFFER ) !=
+            GL_FRAMEBUFFER_COMPLETE )
+    {
+        cerr << "CreateFramebuffer(): can not draw " << HeadlessWidth << "x"
+             << HeadlessHeight << " frames" << endl;
+        return false;
+    }
+
+    return true;
+}
+
+
+
+/******************************************************************************
+* Author: Savoy Schuler and Daniel Hodgin
+*
+* Function: RenderFrame
+*
+* Description:
+*
+*   This function draws the frame of the phases in the body table. While
+*   texture maps or tiles it asked for are still on their way, it waits for
+*   them and draws the frame again with them. Texture maps always arrive, so
+*   are waited for as long as they take. Tiles are waited for TilePolls
+*   checks, asking again for their pages on each, and the frame is kept
+*   once drawing it again uploads nothing: its tiles are then not coming,
+*   and coarser levels are drawn in their place.
+*
+* Parameters:
+*
+*		void	- No input parameters needed.
+*
+******************************************************************************/
+static void RenderFrame()
+{
+    DrawFrame();
+
+    while ( AssetsPending() )
+    {
+        for ( int polls = 0; !AssetsReady() &&
+                ( TexturesLoading() || polls < TilePolls ); polls++ )
+        {
+            this_thread::sleep_for( chrono::milliseconds( AssetPollTime ) );
+            PrefetchAssets();
+        }
+
+        if ( !DrawFrame() )
+            break;
+    }
+}
+
+
+
+/******************************************************************************
+* Author: Savoy Schuler and Daniel Hodgin
+*
+* Function: WriteFrame
+*
+* Description:
+*
+*   This function reads the frame back and writes it as a binary PPM file,
+*   named HeadlessOutput followed by the frame's number in four digits.
+*   Returns false, after saying why, if the file can not be written.
+*
+* Parameters:
+*
+*   frame   - number of the frame, from 0
+*
+******************************************************************************/
+static bool WriteFrame( int frame )
+{
+    int rowBytes = 3 * HeadlessWidth;
+    FramePixels.resize( rowBytes * HeadlessHeight );
+
+    glPixelStorei( GL_PACK_ALIGNMENT, 1 );
+    glReadPixels( 0, 0, HeadlessWidth, HeadlessHeight, GL_RGB,
+                  GL_UNSIGNED_BYTE, &FramePixels[0] );
+
+    ostringstream name;
+    name << HeadlessOutput << setw( 4 ) << setfill( '0' ) << frame << ".ppm";
+
+    ofstream file( name.str().c_str(), ios::binary );
+    file << "P6\n" << HeadlessWidth << " " << HeadlessHeight << "\n255\n";
+
+    //PPM files start at the top row.
+    for ( int row = HeadlessHeight - 1; row >= 0; row-- )
+        file.write( ( const char * ) &FramePixels[row * rowBytes], rowBytes );
+
+    if ( !file )
+    {
+        cerr << "WriteFrame(): can not write " << name.str() << endl;
+        return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,453 @@
+/******************************************************************************
+*	File: labels.cpp
+*
+*	Authors: Savoy Schuler and Daniel Hodgin
+*
+*	Date: 11-17-16
+*
+*	Description:
+*
+*		This file contains the body labels. Drawing a name one character at a
+*       time with glutBitmapCharacter costs a raster position and a bitmap
+*       per character, which gets slow with many names on software OpenGL.
+*       Instead, the draw functions queue each name with the point it is
+*       drawn at, and at the end of the frame DrawLabels draws every queued
+*       name from one vertex buffer with a single call.
+*
+*       The characters come from a font texture holding every printable
+*       character of the GLUT font, made once from a copy of its bitmaps
+*       (see font.cpp), so the names look exactly as before and need no
+*       GLUT: headless frames draw them too. Each character is a quad the
+*       size of a texture cell, placed on whole pixels and drawn without
+*       filtering, with the alpha test keeping only the character's own
+*       pixels.
+*
+*       Names that would overlap one already placed are left out, nearest
+*       bodies first. Placed names are kept in a grid over the window, so
+*       each name is only checked against names in the grid squares it
+*       covers.
+*
+*	File Order and Structure:
+*
+*       - Font texture.
+*       - Queue and draw labels.
+*       - Place labels.
+*
+*	Modified:
+*
+*		Original - Replaces glutBitmapCharacter in DrawTextString.
+*
+*       The font texture is made from the font table instead of drawing
+*       with GLUT.
+*
+*	Functions Included:
+*
+*           //Font texture.
+*
+*       void LoadLabelFont();
+*
+*           //Queue and draw labels.
+*
+*       void QueueLabel( const string &text, const float world[3] );
+*       void DrawLabels();
+*
+*           //Place labels.
+*
+*       static bool PlaceLabel( int label );
+*       static bool NearerLabel( const Label &a, const Label &b );
+*
+******************************************************************************/
+
+/**************************** Library Includes *******************************/
+#define GL_GLEXT_PROTOTYPES
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdlib>
+#include <GL/freeglut.h>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "Planet.h"
+#include "globals.h"
+
+/******************************* Name Space **********************************/
+
+using namespace std;
+
+/******************************** Type Def ***********************************/
+
+//A name queued for drawing.
+struct Label
+{
+    const string *Text;     //the name, which must last until drawn
+    int X, Y;               //pixel of its raster position
+    float Depth;            //window depth of its raster position
+    int Width;              //pixels across
+};
+
+//Interleaved vertex layout of the label quads.
+struct LabelVertex
+{
+    GLfloat Position[3];    //window x, y and depth
+    GLfloat TexCoord[2];    //font texture coordinates
+};
+
+/******************************* Constants **********************************/
+
+//Font texture: texels on each side, and the cell holding each character.
+static const int FontTextureSize = 256;
+static const int CellWidth = 16;
+static const int CellHeight = 32;
+static const int CellsAcross = FontTextureSize / CellWidth;
+
+//Height of the raster position above the bottom of a cell.
+static const int Baseline = 8;
+
+//Pixels on each side of a square of the placement grid.
+static const int GridSize = 64;
+
+/********************************* Globals ***********************************/
+
+//Font texture object, 0 until made.
+static GLuint FontTexture = 0;
+
+//Names queued for the frame.
+static vector<Label> Labels;
+
+//Names placed in each square of the grid, and the squares used.
+static vector< vector<int> > Grid;
+static vector<int> GridUsed;
+static int GridCols, GridRows;
+
+//Vertex buffer the label quads are drawn from, and the quads.
+static GLuint LabelBuffer = 0;
+static vector<LabelVertex> Vertices;
+
+/*************************** Function Prototypes *****************************/
+
+static bool PlaceLabel( int label );
+static bool NearerLabel( const Label &a, const Label &b );
+
+
+
+/******************************************************************************
+* Author: Savoy Schuler and Daniel Hodgin
+*
+* Function: LoadLabelFont
+*
+* Description:
+*
+*   This function makes the font texture, unless it is made already. Every
+*   printable character of the font table is set into its own cell, where
+*   glBitmap would have drawn it from a raster position Baseline pixels up
+*   the cell, and the texture uploaded. It needs no window, so may be called
+*   at any time with a context current.
+*
+* Parameters:
+*
+*		void	- No input parameters needed.
+*
+******************************************************************************/
+void LoadLabelFont()
+{
+    if ( FontTexture != 0 )
+        return;
+
+    //White on black, so white is opaque and black clear as intensity.
+    vector<GLubyte> texels( FontTextureSize * FontTextureSize, 0 );
+
+    for ( int i = 0; i < FontGlyphCount; i++ )
+    {
+        int x = i % CellsAcross * CellWidth;
+        int y = i / CellsAcross * CellHeight + Baseline - FontDescent;
+
+        for ( int row = 0; row < FontGlyphHeight; row++ )
+            for ( int col = 0; col < FontGlyphWidth; col++ )
+                if ( FontGlyphs[i][row] & ( 1 << ( FontGlyphWidth - 1 - col ) ) )
+                    texels[( y + row ) * FontTextureSize + x + col] = 255;
+    }
+
+    glGenTextures( 1, &FontTexture );
+    BindTexture( FontTexture );
+    glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE );
+    glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE );
+    glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST );
+    glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST );
+    glPixelStorei( GL_UNPACK_ALIGNMENT, 4 );
+    glTexImage2D( GL_TEXTURE_2D, 0, GL_INTENSITY8, FontTextureSize,
+                  FontTextureSize, 0, GL_LUMINANCE, GL_UNSIGNED_BYTE,
+                  &texels[0] );
+}
+
+
+
+/******************************************************************************
+* Author: Savoy Schuler and Daniel Hodgin
+*
+* Function: QueueLabel
+*
+* Description:
+*
+*   This function queues a name to be drawn by DrawLabels, starting at the
+*   point glRasterPos would be given. Names whose point is outside the view
+*   are skipped, as glRasterPos would skip them.
+*
+* Parameters:
+*
+*   text    - the name, kept by reference until drawn
+*
+*   world   - raster position in solar system coordinates
+*
+******************************************************************************/
+void QueueLabel( const string &text, const float world[3] )
+{
+    float window[3];
+    if ( !WindowPosition( world, window ) )
+        return;
+
+    Label label;
+    label.Text = &text;
+    label.X = floor( window[0] );
+    label.Y = floor( window[1] );
+    label.Depth = window[2];
+    label.Width = 0;
+
+    for ( unsigned i = 0; i < text.length(); i++ )
+    {
+        int glyph = ( unsigned char ) text[i] - FontFirstGlyph;
+        if ( glyph >= 0 && glyph < FontGlyphCount )
+            label.Width += FontGlyphWidth;
+    }
+
+    Labels.push_back( label );
+}
+
+
+
+/******************************************************************************
+* Author: Savoy Schuler and Daniel Hodgin
+*
+* Function: DrawLabels
+*
+* Description:
+*
+*   This function draws the names queued this frame, nearest first, leaving
+*   out those overlapping a name already placed. The quads of every name
+*   drawn go into one vertex buffer drawn with a single call, depth tested at
+*   the depth of each name's raster position. The queue is then emptied.
+*
+* Parameters:
+*
+*		void	- No input parameters needed.
+*
+******************************************************************************/
+void DrawLabels()
+{
+    if ( FontTexture == 0 || Labels.empty() )
+    {
+        Labels.clear();
+        return;
+    }
+
+    sort( Labels.begin(), Labels.end(), NearerLabel );
+
+    //Empty the squares used last frame, while they are still in the grid,
+    //then size the grid to cover the window.
+    for ( unsigned i = 0; i < GridUsed.size(); i++ )
+        Grid[GridUsed[i]].clear();
+    GridUsed.clear();
+
+    GridCols = ScreenWidth / GridSize + 1;
+    GridRows = ScreenHeight / GridSize + 1;
+    Grid.resize( GridCols * GridRows );
+
+    Vertices.clear();
+
+    for ( unsigned i = 0; i < Labels.size(); i++ )
+    {
+        if ( !PlaceLabel( i ) )
+        {
+            FrameStats.LabelsHidden++;
+            continue;
+        }
+
+        FrameStats.LabelsDrawn++;
+
+        //One quad per character, its cell lined up with the raster position.
+        const Label &label = Labels[i];
+        int x = label.X;
+
+        for ( unsigned c = 0; c < label.Text->length(); c++ )
+        {
+            int glyph = ( unsigned char ) ( *label.Text )[c] - FontFirstGlyph;
+            if ( glyph < 0 || glyph >= FontGlyphCount )
+                continue;
+
+            float s0 = ( float ) ( glyph % CellsAcross * CellWidth ) /
+                       FontTextureSize;
+            float t0 = ( float ) ( glyph / CellsAcross * CellHeight ) /
+                       FontTextureSize;
+            float s1 = s0 + ( float ) CellWidth / FontTextureSize;
+            float t1 = t0 + ( float ) CellHeight / FontTextureSize;
+            float x0 = x, x1 = x + CellWidth;
+            float y0 = label.Y - Baseline, y1 = y0 + CellHeight;
+
+            LabelVertex quad[4] =
+            {
+                { { x0, y0, -label.Depth }, { s0, t0 } },
+                { { x1, y0, -label.Depth }, { s1, t0 } },
+                { { x1, y1, -label.Depth }, { s1, t1 } },
+                { { x0, y1, -label.Depth }, { s0, t1 } }
+            };
+
+            Vertices.insert( Vertices.end(), quad, quad + 4 );
+            x += FontGlyphWidth;
+        }
+    }
+
+    Labels.clear();
+
+    if ( Vertices.empty() )
+        return;
+
+    //Draw in window pixels, with depth z from 0 to -1 for depths 0 to 1.
+    glMatrixMode( GL_PROJECTION );
+    glPushMatrix();
+    glLoadIdentity();
+    glOrtho( 0.0, ScreenWidth, 0.0, ScreenHeight, 0.0, 1.0 );
+    glMatrixMode( GL_MODELVIEW );
+    glPushMatrix();
+    glLoadIdentity();
+
+    //Unlit white characters, keeping only their own pixels.
+    SetCapability( GL_LIGHTING, false );
+    SetCapability( GL_CULL_FACE, false );
+    SetCapability( GL_TEXTURE_2D, true );
+    SetCapability( GL_ALPHA_TEST, true );
+    glAlphaFunc( GL_GREATER, 0.5 );
+    if ( wire )
+        glPolygonMode( GL_FRONT_AND_BACK, GL_FILL );
+
+    SetColor( 1.0, 1.0, 1.0 );
+    SetTextureMode( GL_MODULATE );
+    BindTexture( FontTexture );
+    SetTextureWindow( WholeTexture );
+
+    if ( LabelBuffer == 0 )
+        glGenBuffers( 1, &LabelBuffer );
+
+    glBindBuffer( GL_ARRAY_BUFFER, LabelBuffer );
+    glBufferData( GL_ARRAY_BUFFER, Vertices.size() * sizeof( LabelVertex ),
+                  &Vertices[0], GL_STREAM_DRAW );
+
+    glEnableClientState( GL_VERTEX_ARRAY );
+    glEnableClientState( GL_TEXTURE_COORD_ARRAY );
+    glVertexPointer( 3, GL_FLOAT, sizeof( LabelVertex ),
+                     ( GLvoid * ) offsetof( LabelVertex, Position ) );
+    glTexCoordPointer( 2, GL_FLOAT, sizeof( LabelVertex ),
+                       ( GLvoid * ) offsetof( LabelVertex, TexCoord ) );
+
+    glDrawArrays( GL_QUADS, 0, Vertices.size() );
+
+    glDisableClientState( GL_VERTEX_ARRAY );
+    glDisableClientState( GL_TEXTURE_COORD_ARRAY );
+    glBindBuffer( GL_ARRAY_BUFFER, 0 );
+
+    //Restore the state the frame is drawn with.
+    if ( wire )
+        glPolygonMode( GL_FRONT_AND_BACK, GL_LINE );
+
+    SetCapability( GL_ALPHA_TEST, false );
+    SetCapability( GL_TEXTURE_2D, textureToggle );
+    SetCapability( GL_CULL_FACE, true );
+    SetCapability( GL_LIGHTING, light );
+
+    glPopMatrix();
+    glMatrixMode( GL_PROJECTION );
+    glPopMatrix();
+    glMatrixMode( GL_MODELVIEW );
+}
+
+
+
+/******************************************************************************
+* Author: Savoy Schuler and Daniel Hodgin
+*
+* Function: PlaceLabel
+*
+* Description:
+*
+*   This function places a name in the grid unless it overlaps a name placed
+*   already. A name covers the pixels glutBitmapCharacter would: its width,
+*   and the font's height starting just below the raster position. Returns
+*   true if the name was placed.
+*
+* Parameters:
+*
+*   label   - index of the name in Labels
+*
+******************************************************************************/
+static bool PlaceLabel( int label )
+{
+    const Label &a = Labels[label];
+    int bottom = a.Y - Baseline / 2;
+    int top = bottom + FontGlyphHeight;
+
+    //Grid squares the name covers, kept inside the grid.
+    int col0 = max( a.X / GridSize, 0 );
+    int col1 = min( ( a.X + a.Width ) / GridSize, GridCols - 1 );
+    int row0 = max( bottom / GridSize, 0 );
+    int row1 = min( top / GridSize, GridRows - 1 );
+
+    for ( int row = row0; row <= row1; row++ )
+        for ( int col = col0; col <= col1; col++ )
+        {
+            const vector<int> &square = Grid[row * GridCols + col];
+
+            for ( unsigned i = 0; i < square.size(); i++ )
+            {
+                const Label &b = Labels[square[i]];
+                int bBottom = b.Y - Baseline / 2;
+                int bTop = bBottom + FontGlyphHeight;
+
+                if ( a.X < b.X + b.Width && b.X < a.X + a.Width &&
+                        bottom < bTop && bBottom < top )
+                    return false;
+            }
+        }
+
+    for ( int row = row0; row <= row1; row++ )
+        for ( int col = col0; col <= col1; col++ )
+        {
+            vector<int> &square = Grid[row * GridCols + col];
+
+            if ( square.empty() )
+                GridUsed.push_back( row * GridCols + col );
+
+            square.push_back( label );
+        }
+
+    return true;
+}
+
+
+
+/******************************************************************************
+* Author: Savoy Schuler and Daniel Hodgin
+*
+* Function: NearerLabel
+*
+* Description:
+*
+*   Returns true if name a is nearer the eye than name b, for sorting.
+*
+* Parameters:
+*
+*   a, b    - names to compare
+*
+******************************************************************************/
+static bool NearerLabel( const Label &a, const Label &b )
+{
+    return a.Depth < b.Depth;
+}
@@ -0,0 +1,252 @@
+/******************************************************************************
+*	File: lod.cpp
+*
+*	Authors: Savoy Schuler and Daniel Hodgin
+*
+*	Date: 11-17-16
+*
+*	Description:
+*
+*		This file contains the level of detail selection for the spheres of the
+*       celestial bodies. Each body's resolution (slices and stacks) is chosen
+*       from the radius it covers on screen, so a distant planet is drawn with
+*       far fewer triangles than the Sun filling the window. The user's
+*       Resolution setting caps the resolution any body may use.
+*
+*       The silhouette of a sphere drawn with n slices misses the true circle
+*       by about r * PI^2 / (2 n^2) pixels for a radius of r pixels, so the
+*       resolution is picked to keep that error under LodPixelError.
+*
+*       To keep bodies from flickering between levels as they move, a body
+*       moves up a level as soon as it needs to, but only moves back down once
+*       it would still fit the lower level after growing by LodHysteresis.
+*
+*       Belt members are too many to keep a level each, so they are sorted
+*       into levels afresh every frame, without hysteresis, and each level is
+*       drawn in one call (see belts.cpp).
+*
+*       Below ImpostorPixels a sphere is too small on screen for its mesh to
+*       show, so the shader renderer draws it as an impostor instead, one
+*       point sprite shaded as the sphere (see shaders.cpp).
+*
+*	File Order and Structure:
+*
+*       - Select level of detail.
+*       - Levels of many bodies.
+*       - Impostors.
+*
+*	Modified:
+*
+*		Original
+*
+*	Functions Included:
+*
+*           //Select level of detail.
+*
+*       static int LevelForRadius( float pixelRadius );
+*       int SelectLod( int body, const float position[3], float radius );
+*
+*           //Levels of many bodies.
+*
+*       int LodLevelCount();
+*       int LodLevel( float pixelRadius );
+*       int LodResolution( int level );
+*
+*           //Impostors.
+*
+*       bool ImpostorSized( float pixelRadius );
+*
+******************************************************************************/
+
+/**************************** Library Includes *******************************/
+#include <cstdlib>
+#include <cmath>
+#include <GL/freeglut.h>
+#include <iostream>
+#include <string>
+#include "Planet.h"
+#include "globals.h"
+
+/******************************* Constants **********************************/
+
+//Resolutions bodies may be drawn at, from coarsest to finest.
+static const int LodLevels[] = { 4, 6, 8, 12, 16, 24, 32, 48, 64, 100, 150 };
+static const int LevelCount = sizeof( LodLevels ) / sizeof( LodLevels[0] );
+
+//Largest allowed gap, in pixels, between the silhouette and a true circle.
+static const float LodPixelError = 0.25;
+
+//Factor a body must grow by and still fit a lower level before dropping to it.
+static const float LodHysteresis = 1.3;
+
+/********************************* Globals ***********************************/
+
+//Radius on screen, in pixels, below which the shader renderer draws bodies
+//as impostors, set by the -impostor option. 0 never draws impostors.
+float ImpostorPixels = 8.0;
+
+
+
+/******************************************************************************
+* Author: Savoy Schuler and Daniel Hodgin
+*
+* Function: LevelForRadius
+*
+* Description:
+*
+*   This function returns the index of the coarsest level whose silhouette
+*   error is within LodPixelError for a sphere of the given radius in pixels.
+*
+* Parameters:
+*
+*   pixelRadius     - radius the sphere covers on screen
+*
+******************************************************************************/
+static int LevelForRadius( float pixelRadius )
+{
+    //Slices needed so that r * PI^2 / (2 n^2) <= LodPixelError.
+    float slices = PI * sqrt( pixelRadius / ( 2.0 * LodPixelError ) );
+
+    int level = 0;
+    while ( level < LevelCount - 1 && LodLevels[level] < slices )
+        level++;
+
+    return level;
+}
+
+
+
+/******************************************************************************
+* Author: Savoy Schuler and Daniel Hodgin
+*
+* Function: SelectLod
+*
+* Description:
+*
+*   This function picks the resolution for drawing a body this frame. The
+*   level is chosen from the body's size on screen with hysteresis against
+*   the level it used last frame, which is stored back in the body table. The
+*   result never exceeds the user's Resolution setting.
+*
+* Parameters:
+*
+*   body        - row of the body being drawn
+*
+*   position    - center of the body in solar system coordinates
+*
+*   radius      - radius of the body as drawn
+*
+******************************************************************************/
+int SelectLod( int body, const float position[3], float radius )
+{
+    float pixelRadius = ProjectedRadius( position, radius );
+    int level = Bodies.Lod[body];
+
+    //Move up as soon as more detail is needed.
+    int wanted = LevelForRadius( pixelRadius );
+    if ( wanted > level )
+        level = wanted;
+
+    //Only move down once the body is well within the lower level.
+    else if ( LevelForRadius( pixelRadius * LodHysteresis ) < level )
+        level = LevelForRadius( pixelRadius * LodHysteresis );
+
+    Bodies.Lod[body] = level;
+
+    //Never draw with more detail than the user's resolution setting.
+    if ( LodLevels[level] > Resolution )
+        return Resolution;
+
+    return LodLevels[level];
+}
+
+
+
+/******************************************************************************
+* Author: Savoy Schuler and Daniel Hodgin
+*
+* Function: LodLevelCount
+*
+* Description:
+*
+*   Returns the number of levels of detail, for sorting many bodies into.
+*
+* Parameters:
+*
+*		void	- No input parameters needed.
+*
+******************************************************************************/
+int LodLevelCount()
+{
+    return LevelCount;
+}
+
+
+
+/******************************************************************************
+* Author: Savoy Schuler and Daniel Hodgin
+*
+* Function: LodLevel
+*
+* Description:
+*
+*   This function returns the level of detail for a sphere of the given
+*   radius on screen, with no hysteresis, for bodies that keep no level of
+*   their own from frame to frame.
+*
+* Parameters:
+*
+*   pixelRadius     - radius the sphere covers on screen
+*
+******************************************************************************/
+int LodLevel( float pixelRadius )
+{
+    return LevelForRadius( pixelRadius );
+}
+
+
+
+/******************************************************************************
+* Author: Savoy Schuler and Daniel Hodgin
+*
+* Function: LodResolution
+*
+* Description:
+*
+*   Returns the resolution (slices and stacks) of a level of detail, never
+*   more than the user's Resolution setting.
+*
+* Parameters:
+*
+*   level   - level of detail, from LodLevel
+*
+******************************************************************************/
+int LodResolution( int level )
+{
+    if ( LodLevels[level] > Resolution )
+        return Resolution;
+
+    return LodLevels[level];
+}
+
+
+
+/******************************************************************************
+* Author: Savoy Schuler and Daniel Hodgin
+*
+* Function: ImpostorSized
+*
+* Description:
+*
+*   Returns whether a sphere of the given radius on screen is small enough
+*   to draw as an impostor. Wireframe always shows the mesh.
+*
+* Parameters:
+*
+*   pixelRadius     - radius the sphere covers on screen
+*
+******************************************************************************/
+bool ImpostorSized( float pixelRadius )
+{
+    return !wire && pixelRadius < ImpostorPixels;
+}
@@ -0,0 +1,634 @@
+/******************************************************************************
+*	File: meshes.cpp
+*
+*	Authors: Savoy Schuler and Daniel Hodgin
+*
+*	Date: 11-17-16
+*
+*	Description:
+*
+*		This file contains the mesh cache used for drawing the spheres of the
+*       celestial bodies. A unit sphere is tessellated once for each resolution
+*       that is asked for and stored in OpenGL vertex and index buffers with
+*       interleaved position, normal, and texture coordinates. Bodies of any
+*       size are drawn from the cached unit sphere by scaling the model view.
+*
+*       The spheres match the layout of gluSphere: slices are taken around the
+*       z axis, stacks run from the +z pole to the -z pole, and texture
+*       coordinates are assigned the same way so texture maps line up.
+*
+*       The orbital paths are cached here as well. Each path is a thin ring
+*       in the plane of its orbit, built once into a single vertex buffer
+*       holding every path, and all paths in view are drawn with one call.
+*       A path is built from the points OrbitPathPoint gives along the
+*       orbit, so orbits of other shapes only need to change that function;
+*       a tilted orbit can also be drawn by rotating the model view.
+*
+*       Rings are flat annuli built once for each body with rings, with
+*       texture coordinates laid out as gluCylinder's: s around the ring and
+*       t from the inner edge to the outer. A ring is only built again if its
+*       size or resolution changes.
+*
+*	File Order and Structure:
+*
+*       - Build sphere meshes.
+*       - Draw sphere meshes.
+*       - Build orbit meshes.
+*       - Draw orbit meshes.
+*       - Ring meshes.
+*
+*	Modified:
+*
+*		Original - Replaces gluNewQuadric/gluSphere in the draw functions.
+*
+*	Functions Included:
+*
+*           //Build sphere meshes.
+*
+*       static Mesh *GetSphereMesh( int resolution );
+*
+*           //Draw sphere meshes.
+*
+*       void DrawSphere( float radius, int resolution );
+*       void DrawUnitSphere( int resolution );
+*       void DrawUnitSpheres( int resolution, int count );
+*       static Mesh *BindSphereMesh( int resolution );
+*       static void UnbindSphereMesh();
+*
+*           //Build orbit meshes.
+*
+*       static void BuildOrbitMeshes();
+*       static void OrbitPathPoint( int body, float angle, float offset,
+*                                   GLfloat point[3] );
+*
+*           //Draw orbit meshes.
+*
+*       void DrawOrbitMeshes( const vector<int> &bodies );
+*
+*           //Ring meshes.
+*
+*       void DrawRingMesh( int rings, float inner, float outer, int slices );
+*
+******************************************************************************/
+
+/**************************** Library Includes *******************************/
+#define GL_GLEXT_PROTOTYPES
+#include <cstddef>
+#include <cstdlib>
+#include <cmath>
+#include <GL/freeglut.h>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+#include "Planet.h"
+#include "globals.h"
+
+/******************************* Name Space **********************************/
+
+using namespace std;
+
+/******************************** Type Def ***********************************/
+
+//Interleaved vertex layout stored in the vertex buffers.
+struct MeshVertex
+{
+    GLfloat Position[3];    //vertex position
+    GLfloat Normal[3];      //vertex normal
+    GLfloat TexCoord[2];    //texture coordinates
+};
+
+//Vertex and index buffers for one tessellation of the unit sphere.
+struct Mesh
+{
+    GLuint VertexBuffer;    //buffer object holding MeshVertex data
+    GLuint IndexBuffer;     //buffer object holding triangle indices
+    GLsizei IndexCount;     //number of indices to draw
+};
+
+//Vertex buffer holding the annulus of one body's rings.
+struct RingMesh
+{
+    GLuint VertexBuffer;    //buffer object holding MeshVertex data
+    float Inner;            //inner radius it was built with
+    float Outer;            //outer radius it was built with
+    int Slices;             //slices around the ring
+};
+
+/******************************* Constants **********************************/
+
+//Slices around each orbital path, as many as gluPartialDisk was given.
+static const int OrbitSlices = 50;
+
+//Vertices in each orbital path, drawn as a triangle strip.
+static const int OrbitVertices = 2 * ( OrbitSlices + 1 );
+
+/********************************* Globals ***********************************/
+
+//Cache of sphere meshes keyed by resolution (slices and stacks).
+static map<int, Mesh> SphereMeshes;
+
+//Buffer object holding every orbital path, 0 until first drawn.
+static GLuint OrbitBuffer = 0;
+
+//First vertex of each body's orbital path in OrbitBuffer, -1 for none.
+static vector<GLint> OrbitFirst;
+
+//Ring meshes keyed by the row of the rings in the body table.
+static map<int, RingMesh> RingMeshes;
+
+/*************************** Function Prototypes *****************************/
+
+static Mesh *BindSphereMesh( int resolution );
+static void UnbindSphereMesh();
+static void BuildOrbitMeshes();
+static void OrbitPathPoint( int body, float angle, float offset,
+                            GLfloat point[3] );
+
+
+
+/******************************************************************************
+* Author: Savoy Schuler and Daniel Hodgin
+*
+* Function: GetSphereMesh
+*
+* Description:
+*
+*   This function returns the cached unit sphere for a resolution, building
+*   it the first time that resolution is asked for. The sphere is built with
+*   resolution slices and resolution stacks and uploaded to vertex and index
+*   buffer objects so it never needs to be tessellated again.
+*
+* Parameters:
+*
+*   resolution  - number of slices and stacks in the sphere
+*
+******************************************************************************/
+static Mesh *GetSphereMesh( int resolution )
+{
+    //Use the cached mesh if this resolution has been built before.
+    map<int, Mesh>::iterator found = SphereMeshes.find( resolution );
+    if ( found != SphereMeshes.end() )
+        return &found->second;
+
+    int slices = resolution;
+    int stacks = resolution;
+    vector<MeshVertex> vertices( ( slices + 1 ) * ( stacks + 1 ) );
+    vector<GLuint> indices;
+    indices.reserve( slices * stacks * 6 );
+
+    /*Build the vertices one stack at a time, from the +z pole down. The seam
+    column is repeated so the texture wraps exactly once around the sphere.*/
+    for ( int j = 0; j <= stacks; j++ )
+    {
+        float rho = PI * j / stacks;
+
+        for ( int i = 0; i <= slices; i++ )
+        {
+            float theta = 2.0 * PI * i / slices;
+            MeshVertex &v = vertices[j * ( slices + 1 ) + i];
+
+            //Unit sphere, so the normal is the position.
+            v.Position[0] = v.Normal[0] = sin( rho ) * sin( theta );
+            v.Position[1] = v.Normal[1] = sin( rho ) * cos( theta );
+            v.Position[2] = v.Normal[2] = cos( rho );
+
+            //Same texture coordinates as gluSphere.
+            v.TexCoord[0] = 1.0 - ( float ) i / slices;
+            v.TexCoord[1] = 1.0 - ( float ) j / stacks;
+        }
+    }
+
+    //Two counter-clockwise (outward facing) triangles per slice and stack.
+    for ( int j = 0; j < stacks; j++ )
+    {
+        for ( int i = 0; i < slices; i++ )
+        {
+            GLuint top = j * ( slices + 1 ) + i;
+            GLuint bottom = top + slices + 1;
+
+            indices.push_back( bottom );
+            indices.push_back( top );
+            indices.push_back( top + 1 );
+
+            indices.push_back( bottom );
+            indices.push_back( top + 1 );
+            indices.push_back( bottom + 1 );
+        }
+    }
+
+    //Upload the vertices and indices to buffer objects.
+    Mesh mesh;
+    mesh.IndexCount = indices.size();
+
+    glGenBuffers( 1, &mesh.VertexBuffer );
+    glBindBuffer( GL_ARRAY_BUFFER, mesh.VertexBuffer );
+    glBufferData( GL_ARRAY_BUFFER, vertices.size() * sizeof( MeshVertex ),
+                  &vertices[0], GL_STATIC_DRAW );
+
+    glGenBuffers( 1, &mesh.IndexBuffer );
+    glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, mesh.IndexBuffer );
+    glBufferData( GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof( GLuint ),
+                  &indices[0], GL_STATIC_DRAW );
+
+    glBindBuffer( GL_ARRAY_BUFFER, 0 );
+    glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, 0 );
+
+    //Save the mesh in the cache.
+    return &( SphereMeshes[resolution] = mesh );
+}
+
+
+
+/******************************************************************************
+* Author: Savoy Schuler and Daniel Hodgin
+*
+* Function: DrawSphere
+*
+* Description:
+*
+*   This function draws a textured sphere centered at the current origin,
+*   taking the place of gluSphere. The cached unit sphere is scaled to the
+*   requested radius (normals are renormalized since GL_NORMALIZE is on).
+*
+* Parameters:
+*
+*   radius      - radius of the sphere
+*
+*   resolution  - number of slices and stacks in the sphere
+*
+******************************************************************************/
+void DrawSphere( float radius, int resolution )
+{
+    //Scale the unit sphere to the requested size.
+    glPushMatrix();
+    glScalef( radius, radius, radius );
+
+    DrawUnitSphere( resolution );
+
+    glPopMatrix();
+}
+
+
+
+/******************************************************************************
+* Author: Savoy Schuler and Daniel Hodgin
+*
+* Function: DrawUnitSphere
+*
+* Description:
+*
+*   This function draws the cached unit sphere with a single call, leaving
+*   the matrices alone, for the shader renderer to scale (see shaders.cpp).
+*
+* Parameters:
+*
+*   resolution  - number of slices and stacks in the sphere
+*
+******************************************************************************/
+void DrawUnitSphere( int resolution )
+{
+    Mesh *mesh = BindSphereMesh( resolution );
+
+    //Draw the sphere.
+    glDrawElements( GL_TRIANGLES, mesh->IndexCount, GL_UNSIGNED_INT, 0 );
+    FrameStats.Triangles += mesh->IndexCount / 3;
+
+    UnbindSphereMesh();
+}
+
+
+
+/******************************************************************************
+* Author: Savoy Schuler and Daniel Hodgin
+*
+* Function: DrawUnitSpheres
+*
+* Description:
+*
+*   This function draws many copies of the cached unit sphere with a single
+*   instanced call. Where each copy goes comes from per-instance vertex
+*   attributes the caller has set up, read by the shader renderer (see
+*   DrawShadedMembers).
+*
+* Parameters:
+*
+*   resolution  - number of slices and stacks in the sphere
+*
+*   count       - number of copies to draw
+*
+******************************************************************************/
+void DrawUnitSpheres( int resolution, int count )
+{
+    Mesh *mesh = BindSphereMesh( resolution );
+
+    //Draw every copy.
+    glDrawElementsInstanced( GL_TRIANGLES, mesh->IndexCount, GL_UNSIGNED_INT,
+                             0, count );
+    FrameStats.Triangles += count * ( mesh->IndexCount / 3 );
+
+    UnbindSphereMesh();
+}
+
+
+
+/******************************************************************************
+* Author: Savoy Schuler and Daniel Hodgin
+*
+* Function: BindSphereMesh
+*
+* Description:
+*
+*   This function binds the cached unit sphere for a resolution and points
+*   the vertex arrays into it. Returns the mesh, for its index count.
+*
+* Parameters:
+*
+*   resolution  - number of slices and stacks in the sphere
+*
+******************************************************************************/
+static Mesh *BindSphereMesh( int resolution )
+{
+    Mesh *mesh = GetSphereMesh( resolution );
+
+    //Point the vertex arrays into the interleaved vertex buffer.
+    glBindBuffer( GL_ARRAY_BUFFER, mesh->VertexBuffer );
+    glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, mesh->IndexBuffer );
+
+    glEnableClientState( GL_VERTEX_ARRAY );
+    glEnableClientState( GL_NORMAL_ARRAY );
+    glEnableClientState( GL_TEXTURE_COORD_ARRAY );
+
+    glVertexPointer( 3, GL_FLOAT, sizeof( MeshVertex ),
+                     ( GLvoid * ) offsetof( MeshVertex, Position ) );
+    glNormalPointer( GL_FLOAT, sizeof( MeshVertex ),
+                     ( GLvoid * ) offsetof( MeshVertex, Normal ) );
+    glTexCoordPointer( 2, GL_FLOAT, sizeof( MeshVertex ),
+                       ( GLvoid * ) offsetof( MeshVertex, TexCoord ) );
+
+    return mesh;
+}
+
+
+
+/******************************************************************************
+* Author: Savoy Schuler and Daniel Hodgin
+*
+* Function: UnbindSphereMesh
+*
+* Description:
+*
+*   This function restores the client state BindSphereMesh changed.
+*
+* Parameters:
+*
+*		void	- No input parameters needed.
+*
+******************************************************************************/
+static void UnbindSphereMesh()
+{
+    glDisableClientState( GL_VERTEX_ARRAY );
+    glDisableClientState( GL_NORMAL_ARRAY );
+    glDisableClientState( GL_TEXTURE_COORD_ARRAY );
+
+    glBindBuffer( GL_ARRAY_BUFFER, 0 );
+    glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, 0 );
+}
+
+
+
+/******************************************************************************
+* Author: Savoy Schuler and Daniel Hodgin
+*
+* Function: BuildOrbitMeshes
+*
+* Description:
+*
+*   This function builds the orbital path of every planet and uploads them
+*   all to one vertex buffer object. Each path is a triangle strip running
+*   around the orbit between its inner and outer edges, OrbitWidth apart.
+*
+* Parameters:
+*
+*		void	- No input parameters needed.
+*
+******************************************************************************/
+static void BuildOrbitMeshes()
+{
+    vector<GLfloat> vertices;
+
+    OrbitFirst.assign( BodyCount(), -1 );
+
+    for ( int body = 0; body < BodyCount(); body++ )
+    {
+        if ( !( Bodies.Flags[body] & BodyPlanet ) )
+            continue;
+
+        OrbitFirst[body] = vertices.size() / 3;
+
+        //The seam is repeated so the strip closes.
+        for ( int i = 0; i <= OrbitSlices; i++ )
+        {
+            float angle = 2.0 * PI * i / OrbitSlices;
+            GLfloat inner[3], outer[3];
+
+            OrbitPathPoint( body, angle, 0.0, inner );
+            OrbitPathPoint( body, angle, OrbitWidth, outer );
+
+            vertices.insert( vertices.end(), inner, inner + 3 );
+            vertices.insert( vertices.end(), outer, outer + 3 );
+        }
+    }
+
+    glGenBuffers( 1, &OrbitBuffer );
+    glBindBuffer( GL_ARRAY_BUFFER, OrbitBuffer );
+
+    if ( !vertices.empty() )
+        glBufferData( GL_ARRAY_BUFFER, vertices.size() * sizeof( GLfloat ),
+                      &vertices[0], GL_STATIC_DRAW );
+
+    glBindBuffer( GL_ARRAY_BUFFER, 0 );
+}
+
+
+
+/******************************************************************************
+* Author: Savoy Schuler and Daniel Hodgin
+*
+* Function: OrbitPathPoint
+*
+* Description:
+*
+*   This function finds a point of a body's orbital path, in the plane of
+*   its orbit centered on the sun. Orbits are circles, and angles are taken
+*   the same way as gluPartialDisk.
+*
+* Parameters:
+*
+*   body    - row of the body in the body table
+*
+*   angle   - angle around the orbit, in radians
+*
+*   offset  - distance outward from the orbit
+*
+*   point   - returned point
+*
+******************************************************************************/
+static void OrbitPathPoint( int body, float angle, float offset,
+                            GLfloat point[3] )
+{
+    float radius = GetOrbitRadius( body ) + offset;
+
+    point[0] = radius * sin( angle );
+    point[1] = radius * cos( angle );
+    point[2] = 0.0;
+}
+
+
+
+/******************************************************************************
+* Author: Savoy Schuler and Daniel Hodgin
+*
+* Function: DrawOrbitMeshes
+*
+* Description:
+*
+*   This function draws the orbital paths of bodies, centered at the current
+*   origin, with a single call. The paths are built the first time.
+*
+* Parameters:
+*
+*   bodies  - rows of the planets whose orbital paths to draw
+*
+******************************************************************************/
+void DrawOrbitMeshes( const vector<int> &bodies )
+{
+    if ( OrbitBuffer == 0 )
+        BuildOrbitMeshes();
+
+    vector<GLint> first;
+    vector<GLsizei> count;
+
+    for ( unsigned i = 0; i < bodies.size(); i++ )
+    {
+        if ( OrbitFirst[bodies[i]] < 0 )
+            continue;
+
+        first.push_back( OrbitFirst[bodies[i]] );
+        count.push_back( OrbitVertices );
+    }
+
+    if ( first.empty() )
+        return;
+
+    //Every path lies flat in the plane of its orbit.
+    glNormal3f( 0.0, 0.0, 1.0 );
+
+    glBindBuffer( GL_ARRAY_BUFFER, OrbitBuffer );
+    glEnableClientState( GL_VERTEX_ARRAY );
+    glVertexPointer( 3, GL_FLOAT, 0, 0 );
+
+    glMultiDrawArrays( GL_TRIANGLE_STRIP, &first[0], &count[0], first.size() );
+
+    glDisableClientState( GL_VERTEX_ARRAY );
+    glBindBuffer( GL_ARRAY_BUFFER, 0 );
+}
+
+
+
+/******************************************************************************
+* Author: Savoy Schuler and Daniel Hodgin
+*
+* Function: DrawRingMesh
+*
+* Description:
+*
+*   This function draws a body's rings as a flat annulus in the xy plane,
+*   centered at the current origin, taking the place of gluCylinder. The
+*   annulus is built into a vertex buffer the first time, and again only if
+*   its size or resolution has changed. It is one triangle strip of two
+*   triangles per slice, facing +z.
+*
+* Parameters:
+*
+*   rings   - row of the rings in the body table
+*
+*   inner   - inner radius of the rings
+*
+*   outer   - outer radius of the rings
+*
+*   slices  - slices around the rings
+*
+******************************************************************************/
+void DrawRingMesh( int rings, float inner, float outer, int slices )
+{
+    map<int, RingMesh>::iterator found = RingMeshes.find( rings );
+
+    if ( found == RingMeshes.end() || found->second.Inner != inner ||
+            found->second.Outer != outer || found->second.Slices != slices )
+    {
+        vector<MeshVertex> vertices( 2 * ( slices + 1 ) );
+
+        //Inner and outer edge at each slice, angles as gluCylinder's.
+        for ( int i = 0; i <= slices; i++ )
+        {
+            float theta = 2.0 * PI * i / slices;
+
+            for ( int edge = 0; edge < 2; edge++ )
+            {
+                MeshVertex &v = vertices[2 * i + edge];
+                float radius = edge ? outer : inner;
+
+                v.Position[0] = radius * sin( theta );
+                v.Position[1] = radius * cos( theta );
+                v.Position[2] = 0.0;
+                v.Normal[0] = v.Normal[1] = 0.0;
+                v.Normal[2] = 1.0;
+                v.TexCoord[0] = 1.0 - ( float ) i / slices;
+                v.TexCoord[1] = edge;
+            }
+        }
+
+        RingMesh mesh;
+        mesh.Inner = inner;
+        mesh.Outer = outer;
+        mesh.Slices = slices;
+
+        if ( found == RingMeshes.end() )
+            glGenBuffers( 1, &mesh.VertexBuffer );
+        else
+            mesh.VertexBuffer = found->second.VertexBuffer;
+
+        glBindBuffer( GL_ARRAY_BUFFER, mesh.VertexBuffer );
+        glBufferData( GL_ARRAY_BUFFER, vertices.size() * sizeof( MeshVertex ),
+                      &vertices[0], GL_STATIC_DRAW );
+
+        found = RingMeshes.insert( make_pair( rings, mesh ) ).first;
+        found->second = mesh;
+    }
+
+    //Point the vertex arrays into the interleaved vertex buffer.
+    glBindBuffer( GL_ARRAY_BUFFER, found->second.VertexBuffer );
+
+    glEnableClientState( GL_VERTEX_ARRAY );
+    glEnableClientState( GL_NORMAL_ARRAY );
+    glEnableClientState( GL_TEXTURE_COORD_ARRAY );
+
+    glVertexPointer( 3, GL_FLOAT, sizeof( MeshVertex ),
+                     ( GLvoid * ) offsetof( MeshVertex, Position ) );
+    glNormalPointer( GL_FLOAT, sizeof( MeshVertex ),
+                     ( GLvoid * ) offsetof( MeshVertex, Normal ) );
+    glTexCoordPointer( 2, GL_FLOAT, sizeof( MeshVertex ),
+                       ( GLvoid * ) offsetof( MeshVertex, TexCoord ) );
+
+    //Draw the rings.
+    glDrawArrays( GL_TRIANGLE_STRIP, 0, 2 * ( slices + 1 ) );
+    FrameStats.Triangles += 2 * slices;
+
+    //Restore client state.
+    glDisableClientState( GL_VERTEX_ARRAY );
+    glDisableClientState( GL_NORMAL_ARRAY );
+    glDisableClientState( GL_TEXTURE_COORD_ARRAY );
+
+    glBindBuffer( GL_ARRAY_BUFFER, 0 );
+}
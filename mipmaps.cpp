@@ -0,0 +1,564 @@
+/******************************************************************************
+*	File: mipmaps.cpp
+*
+*	Authors: Savoy Schuler and Daniel Hodgin
+*
+*	Date: 11-17-16
+*
+*	Description:
+*
+*		This file contains the mipmap builder, used in place of
+*       gluBuild2DMipmaps both by the asset loader's workers and by the packer.
+*       Like gluBuild2DMipmaps, it resizes a texture map to the nearest power
+*       of two on each side and then halves it down to 1 x 1, averaging each
+*       2 x 2 block with the same rounding, so the levels match what OpenGL was
+*       given before. Resizing averages the part of the old image each new
+*       pixel covers.
+*
+*       Large images are split into bands of rows built by several threads at
+*       once. Halving works on 4 pixels at a time with SSSE3 where the CPU has
+*       it (checked at run time), and the row sums of the resize are simple
+*       loops over arrays that do not overlap, which the compiler vectorizes
+*       (at -O3).
+*
+*	File Order and Structure:
+*
+*       - Build mipmaps.
+*       - Resize.
+*       - Halve.
+*       - Threads.
+*
+*	Modified:
+*
+*		Original
+*
+*	Functions Included:
+*
+*           //Build mipmaps.
+*
+*       int NearestPower( int value );
+*       byte* BuildMipmaps( const byte* image, int cols, int rows,
+*                           TextureLevels &levels );
+*
+*           //Resize.
+*
+*       static void ScaleImage( const byte* src, int cols, int rows,
+*                               byte* dst, int newCols, int newRows );
+*       static void ScaleRows( ... );
+*       static void AddRow( ... );
+*
+*           //Halve.
+*
+*       static void HalveImage( const byte* src, int cols, int rows,
+*                               byte* dst );
+*       static void HalveRow( ... );
+*       static void HalveRowSsse3( ... );
+*
+*           //Threads.
+*
+*       static void ParallelRows( int rows, long pixels,
+*                                 const function<void( int, int )> &work );
+*
+******************************************************************************/
+
+/**************************** Library Includes *******************************/
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <GL/freeglut.h>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "Planet.h"
+#include "globals.h"
+
+//SSSE3 halving, chosen at run time on x86 GCC/Clang builds.
+#if defined(__GNUC__) && ( defined(__x86_64__) || defined(__i386__) )
+#define MIP_SSSE3 1
+#include <tmmintrin.h>
+#endif
+
+/******************************* Name Space **********************************/
+
+using namespace std;
+
+/******************************* Constants **********************************/
+
+//Fewest pixels in an image before it is split between threads.
+static const long ParallelPixels = 1024 * 1024;
+
+/*************************** Function Prototypes *****************************/
+
+static void ScaleImage( const byte* src, int cols, int rows, byte* dst,
+                        int newCols, int newRows );
+static void ScaleRows( const byte* src, int cols, int rows, byte* dst,
+                       int newCols, int newRows, int first, int last );
+static void AddRow( const byte *__restrict src, float *__restrict sum,
+                    float weight, int count );
+static void HalveImage( const byte* src, int cols, int rows, byte* dst );
+static void HalveRow( const byte *__restrict top, const byte *__restrict bottom,
+                      byte *__restrict out, int halfCols );
+#ifdef MIP_SSSE3
+static void HalveRowSsse3( const byte* top, const byte* bottom, byte* out,
+                           int halfCols );
+#endif
+static void ParallelRows( int rows, long pixels,
+                          const function<void( int, int )> &work );
+
+/******************************* Inline Helpers ******************************/
+
+//Rows are padded to 4 bytes.
+static inline long RowBytes( int cols )
+{
+    return ( 3L * cols + 3 ) & ~3L;
+}
+
+
+
+/******************************************************************************
+* Author: Savoy Schuler and Daniel Hodgin
+*
+* Function: NearestPower
+*
+* Description:
+*
+*   Returns the power of two gluBuild2DMipmaps resizes a side of the given
+*   length to: the nearest one, rounding up from three quarters of the way.
+*
+* Parameters:
+*
+*   value   - length of a side, at least 1
+*
+******************************************************************************/
+int NearestPower( int value )
+{
+    int power = 1;
+
+    while ( value > 1 )
+    {
+        if ( value == 3 )
+            return power * 4;
+
+        value >>= 1;
+        power <<= 1;
+    }
+
+    return power;
+}
+
+
+
+/******************************************************************************
+* Author: Savoy Schuler and Daniel Hodgin
+*
+* Function: BuildMipmaps
+*
+* Description:
+*
+*   This function builds every mipmap level of a texture map, largest first
+*   down to 1 x 1, ready to be uploaded. An image whose sides are already
+*   powers of two is used as its own first level, otherwise it is resized.
+*   Returns the memory holding the levels built, which the caller frees with
+*   delete [] once they are uploaded; the image itself must be kept until
+*   then too.
+*
+* Parameters:
+*
+*   image       - texture map, RGB rows padded to 4 bytes
+*
+*   cols, rows  - size of the texture map
+*
+*   levels      - returned size and start of each level
+*
+******************************************************************************/
+byte* BuildMipmaps( const byte* image, int cols, int rows, TextureLevels &levels )
+{
+    int newCols = NearestPower( cols );
+    int newRows = NearestPower( rows );
+    bool resize = ( newCols != cols || newRows != rows );
+
+    //Lay out every level in one block of memory.
+    long offsets[MaxTextureLevels];
+    long total = 0;
+    int count = 0;
+
+    for ( int c = newCols, r = newRows; ; c = max( c / 2, 1 ), r = max( r / 2, 1 ) )
+    {
+        offsets[count++] = total;
+
+        if ( count > 1 || resize )
+            total += RowBytes( c ) * r;
+
+        if ( ( c == 1 && r == 1 ) || count == MaxTextureLevels )
+            break;
+    }
+
+    byte* memory = new byte[total > 0 ? total : 1];
+
+    levels.Cols = newCols;
+    levels.Rows = newRows;
+    levels.Levels = count;
+    levels.Level[0] = resize ? memory : image;
+
+    if ( resize )
+        ScaleImage( image, cols, rows, memory, newCols, newRows );
+
+    //Halve each level into the next.
+    for ( int level = 1, c = newCols, r = newRows; level < count; level++ )
+    {
+        levels.Level[level] = memory + offsets[level];
+        HalveImage( levels.Level[level - 1], c, r, memory + offsets[level] );
+
+        c = max( c / 2, 1 );
+        r = max( r / 2, 1 );
+    }
+
+    return memory;
+}
+
+
+
+/******************************************************************************
+* Author: Savoy Schuler and Daniel Hodgin
+*
+* Function: ScaleImage
+*
+* Description:
+*
+*   This function resizes an image. Each new pixel is the average of the
+*   part of the image it covers, each old pixel weighted by how much of it is
+*   covered. Large images are resized by several threads.
+*
+* Parameters:
+*
+*   src             - image to resize, RGB rows padded to 4 bytes
+*
+*   cols, rows      - size of the image
+*
+*   dst             - returned image, RGB rows padded to 4 bytes
+*
+*   newCols, newRows    - size to resize to
+*
+******************************************************************************/
+static void ScaleImage( const byte* src, int cols, int rows, byte* dst,
+                        int newCols, int newRows )
+{
+    ParallelRows( newRows, ( long ) cols * rows, [=]( int first, int last )
+    {
+        ScaleRows( src, cols, rows, dst, newCols, newRows, first, last );
+    } );
+}
+
+
+
+/******************************************************************************
+* Author: Savoy Schuler and Daniel Hodgin
+*
+* Function: ScaleRows
+*
+* Description:
+*
+*   This function resizes a band of rows of an image. For each new row the
+*   old rows it covers are added up, weighted, into a row of sums; each new
+*   pixel is then the weighted sum of the old columns it covers.
+*
+* Parameters:
+*
+*   src, cols, rows, dst, newCols, newRows  - as for ScaleImage
+*
+*   first, last - band of new rows to fill, last not included
+*
+******************************************************************************/
+static void ScaleRows( const byte* src, int cols, int rows, byte* dst,
+                       int newCols, int newRows, int first, int last )
+{
+    long srcRow = RowBytes( cols );
+    long dstRow = RowBytes( newCols );
+    double xScale = ( double ) cols / newCols;
+    double yScale = ( double ) rows / newRows;
+    vector<float> sum( 3 * cols + 3 );
+
+    for ( int y = first; y < last; y++ )
+    {
+        double top = y * yScale, bottom = top + yScale;
+
+        //Add up the old rows the new row covers.
+        fill( sum.begin(), sum.end(), 0.0f );
+
+        for ( int i = ( int ) top; i < bottom && i < rows; i++ )
+        {
+            double height = min( bottom, i + 1.0 ) - max( top, ( double ) i );
+            AddRow( src + i * srcRow, &sum[0], height / yScale, 3 * cols );
+        }
+
+        //Then the old columns each new pixel covers.
+        byte* out = dst + y * dstRow;
+
+        for ( int x = 0; x < newCols; x++ )
+        {
+            double left = x * xScale, right = left + xScale;
+            float pixel[3] = { 0.0f, 0.0f, 0.0f };
+
+            for ( int j = ( int ) left; j < right && j < cols; j++ )
+            {
+                float width = ( min( right, j + 1.0 ) - max( left, ( double ) j ) ) / xScale;
+
+                for ( int c = 0; c < 3; c++ )
+                    pixel[c] += width * sum[3 * j + c];
+            }
+
+            for ( int c = 0; c < 3; c++ )
+                out[3 * x + c] = ( byte ) min( pixel[c] + 0.5f, 255.0f );
+        }
+
+        //Clear the padding.
+        for ( long k = 3L * newCols; k < dstRow; k++ )
+            out[k] = 0;
+    }
+}
+
+
+
+/******************************************************************************
+* Author: Savoy Schuler and Daniel Hodgin
+*
+* Function: AddRow
+*
+* Description:
+*
+*   This function adds a weighted row of bytes to a row of sums. The arrays
+*   are marked as not overlapping so the loop can be vectorized.
+*
+* Parameters:
+*
+*   src     - row to add
+*
+*   sum     - row of sums
+*
+*   weight  - weight of the row
+*
+*   count   - number of bytes in the row
+*
+******************************************************************************/
+static void AddRow( const byte *__restrict src, float *__restrict sum,
+                    float weight, int count )
+{
+    for ( int i = 0; i < count; i++ )
+        sum[i] += weight * src[i];
+}
+
+
+
+/******************************************************************************
+* Author: Savoy Schuler and Daniel Hodgin
+*
+* Function: HalveImage
+*
+* Description:
+*
+*   This function builds the next mipmap level, half the size on each side
+*   longer than 1, by averaging each 2 x 2 block (or pair, once a side is 1)
+*   with the same rounding gluBuild2DMipmaps uses. Large levels are halved by
+*   several threads.
+*
+* Parameters:
+*
+*   src         - level to halve, RGB rows padded to 4 bytes
+*
+*   cols, rows  - size of the level, both powers of two
+*
+*   dst         - returned level, RGB rows padded to 4 bytes
+*
+******************************************************************************/
+static void HalveImage( const byte* src, int cols, int rows, byte* dst )
+{
+    int halfCols = cols > 1 ? cols / 2 : 1;
+    int halfRows = rows > 1 ? rows / 2 : 1;
+    long srcRow = RowBytes( cols );
+    long dstRow = RowBytes( halfCols );
+
+    //One row or column left: average pairs.
+    if ( rows == 1 || cols == 1 )
+    {
+        long step = ( rows == 1 ) ? 3 : srcRow;
+        int count = max( halfCols, halfRows );
+
+        memset( dst, 0, dstRow * halfRows );
+
+        for ( int i = 0; i < count; i++ )
+        {
+            const byte* pair = src + 2 * i * step;
+            byte* out = dst + ( rows == 1 ? 3 * i : i * dstRow );
+
+            for ( int c = 0; c < 3; c++ )
+                out[c] = ( pair[c] + pair[step + c] ) / 2;
+        }
+        return;
+    }
+
+#ifdef MIP_SSSE3
+    bool ssse3 = __builtin_cpu_supports( "ssse3" );
+#endif
+
+    ParallelRows( halfRows, ( long ) cols * rows, [=]( int first, int last )
+    {
+        for ( int y = first; y < last; y++ )
+        {
+            const byte* top = src + 2 * y * srcRow;
+            byte* out = dst + y * dstRow;
+
+#ifdef MIP_SSSE3
+            if ( ssse3 )
+                HalveRowSsse3( top, top + srcRow, out, halfCols );
+            else
+#endif
+                HalveRow( top, top + srcRow, out, halfCols );
+
+            for ( long k = 3L * halfCols; k < dstRow; k++ )
+                out[k] = 0;
+        }
+    } );
+}
+
+
+
+/******************************************************************************
+* Author: Savoy Schuler and Daniel Hodgin
+*
+* Function: HalveRow
+*
+* Description:
+*
+*   This function averages each 2 x 2 block of two rows into one pixel.
+*
+* Parameters:
+*
+*   top, bottom - rows to halve
+*
+*   out         - returned row
+*
+*   halfCols    - number of pixels in the returned row
+*
+******************************************************************************/
+static void HalveRow( const byte *__restrict top, const byte *__restrict bottom,
+                      byte *__restrict out, int halfCols )
+{
+    for ( int x = 0; x < 3 * halfCols; x += 3 )
+        for ( int c = 0; c < 3; c++ )
+            out[x + c] = ( top[2 * x + c] + top[2 * x + 3 + c] +
+                           bottom[2 * x + c] + bottom[2 * x + 3 + c] + 2 ) / 4;
+}
+
+
+
+#ifdef MIP_SSSE3
+/******************************************************************************
+* Author: Savoy Schuler and Daniel Hodgin
+*
+* Function: HalveRowSsse3
+*
+* Description:
+*
+*   HalveRow, 4 pixels at a time. Each 12 bytes of a row (4 pixels) are
+*   shuffled so the matching colors of each pair of pixels sit side by side,
+*   and added pairwise into 16 bit sums, which are added for the two rows,
+*   rounded and packed back into 6 bytes (2 pixels). Rows too short to load
+*   16 bytes past the last 4 pixels are finished by HalveRow.
+*
+* Parameters:
+*
+*   top, bottom - rows to halve
+*
+*   out         - returned row
+*
+*   halfCols    - number of pixels in the returned row
+*
+******************************************************************************/
+__attribute__(( target( "ssse3" ) ))
+static void HalveRowSsse3( const byte* top, const byte* bottom, byte* out,
+                           int halfCols )
+{
+    const __m128i pairs = _mm_setr_epi8( 0, 3, 1, 4, 2, 5, 6, 9, 7, 10, 8, 11,
+                                         -1, -1, -1, -1 );
+    const __m128i pack = _mm_setr_epi8( 0, 1, 2, 3, 4, 5, 8, 9, 10, 11, 12, 13,
+                                        -1, -1, -1, -1 );
+    const __m128i ones = _mm_set1_epi8( 1 );
+    const __m128i two = _mm_set1_epi16( 2 );
+    int x = 0;
+
+    //Stop while 16 bytes can still be read at the last 4 pixels.
+    for ( ; 6 * x + 28 <= 6 * halfCols; x += 4 )
+    {
+        const byte* t = top + 6 * x;
+        const byte* b = bottom + 6 * x;
+
+        __m128i low = _mm_add_epi16(
+            _mm_maddubs_epi16( _mm_shuffle_epi8( _mm_loadu_si128( ( const __m128i* ) t ), pairs ), ones ),
+            _mm_maddubs_epi16( _mm_shuffle_epi8( _mm_loadu_si128( ( const __m128i* ) b ), pairs ), ones ) );
+        __m128i high = _mm_add_epi16(
+            _mm_maddubs_epi16( _mm_shuffle_epi8( _mm_loadu_si128( ( const __m128i* ) ( t + 12 ) ), pairs ), ones ),
+            _mm_maddubs_epi16( _mm_shuffle_epi8( _mm_loadu_si128( ( const __m128i* ) ( b + 12 ) ), pairs ), ones ) );
+
+        low = _mm_srli_epi16( _mm_add_epi16( low, two ), 2 );
+        high = _mm_srli_epi16( _mm_add_epi16( high, two ), 2 );
+
+        __m128i pixels = _mm_shuffle_epi8( _mm_packus_epi16( low, high ), pack );
+
+        //Store 12 bytes.
+        _mm_storel_epi64( ( __m128i* ) ( out + 3 * x ), pixels );
+        int last = _mm_cvtsi128_si32( _mm_srli_si128( pixels, 8 ) );
+        memcpy( out + 3 * x + 8, &last, 4 );
+    }
+
+    HalveRow( top + 6 * x, bottom + 6 * x, out + 3 * x, halfCols - x );
+}
+#endif
+
+
+
+/******************************************************************************
+* Author: Savoy Schuler and Daniel Hodgin
+*
+* Function: ParallelRows
+*
+* Description:
+*
+*   This function splits rows into one band per core and runs work on each
+*   band at once, waiting for all of them to finish. Small images are done
+*   on the calling thread, where starting threads would cost more than it
+*   saves.
+*
+* Parameters:
+*
+*   rows    - number of rows
+*
+*   pixels  - size of the work, to decide whether to split it
+*
+*   work    - called with the first row of a band and the row after it
+*
+******************************************************************************/
+static void ParallelRows( int rows, long pixels,
+                          const function<void( int, int )> &work )
+{
+    int count = thread::hardware_concurrency();
+
+    if ( count > rows )
+        count = rows;
+
+    if ( pixels < ParallelPixels || count <= 1 )
+    {
+        work( 0, rows );
+        return;
+    }
+
+    vector<thread> bands;
+
+    for ( int i = 1; i < count; i++ )
+        bands.push_back( thread( work, rows * i / count, rows * ( i + 1 ) / count ) );
+
+    work( 0, rows / count );
+
+    for ( unsigned i = 0; i < bands.size(); i++ )
+        bands[i].join();
+}
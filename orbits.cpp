@@ -16,11 +16,9 @@
 *
 *	File Order and Structure:
 *
-*       - Create auxiliary planet objects Rings and Moon.
 *       - Set light source.
 *       - Set object material properties.
 *       - Draw objects.
-*       - Set up texture map.
 *       - Helper functions
 *
 *	Modified:
@@ -29,115 +27,100 @@
 *
 *	Functions Included:
 *
-*           //Create auxiliary planet objects Rings and Moon.
-*
-*       void SetRingsandMoon();
-*
 *           //Set light source.
 *
 *       void SetLightModel();
 *
 *           //Set object material properties.
 *
-*       void SetSunMatProp(Planet *sun);
-*       void SetPlanetMatProps(Planet *plant);
-*       void SetMoonMatProps(Planet *Moon);
-*       void SetRingsMatProps(Planet *Rings);
+*       void GetMatProps(int body, Material &material);
+*       void SetMatProps(const Material &material);
+*       void GetSunMatProp(int sun, Material &material);
+*       void GetPlanetMatProps(int planet, Material &material);
+*       void GetMoonMatProps(int moon, Material &material);
+*       void GetRingsMatProps(int rings, Material &material);
 *       void SetOrbitMatProps();
 *
 *           //Draw objects.
 *
-*       void DrawSpace(Planet *space);
-*       void DrawSun(Planet *sun);
-*       void DrawPlanet(Planet *plant);
-*       void DrawMoon(int DayOfYear);
-*       void DrawTextString( string str, double radius);
-*
-*           //Set up texture map.
+*       void DrawSpace(int space);
+*       void DrawSun(int sun);
+*       void DrawPlanet(int planet);
+*       void DrawMoon(int moon);
+*       void DrawRings(int rings);
+*       void DrawBodySphere(int body, const float position[3], float radius);
+*       void DrawOrbits();
+*       void DrawTextString( const string &str, const float position[3],
+*                            double radius, bool below);
 *
-*       int SetTexture( byte* image, int rows, int ncols );
+*           //Find planet positions and sizes.
 *
-*           //Handle user view.
+*       float GetOrbitRadius(int planet);
+*       void GetPlanetPosition(int planet, float position[3]);
+*       float GetPlanetExtent(int planet);
 *
-*       void HandleRotate();
+*           //Copy material colors.
 *
-*           //Convert image string files names to character arrays).
-*
-*       char* stringToChar (string str);
+*       static void SetMaterialColor(GLfloat property[4],
+*                                    const GLfloat color[4]);
 *
 ******************************************************************************/
 
 /**************************** Library Includes *******************************/
+#include <algorithm>
 #include <cstdlib>
+#include <cmath>
 #include <GL/freeglut.h>
 #include <iostream>
 #include <string>
+#include <vector>
 #include "Planet.h"
 #include "globals.h"
 
-/********************************* Globals ***********************************/
-
-//Global pointers to auxiliary planet objects.
+/*************************** Function Prototypes *****************************/
 
-Planet *Moon;
-Planet *Rings;
+static void SetMaterialColor(GLfloat property[4], const GLfloat color[4]);
 
 
 
 /******************************************************************************
 * Author: Daniel Hodgin and Savoy Schuler
 *
-* Function: setCelestialBodies
+* Function: SetLightModel
 *
 * Description:
 *
-*	This function creates planet objects for Saturn's rings and Earth's moon and
-*   sets the fields for each. Each planet object is addressed by its
-*   corresponding global pointer declared at the top of this file.
-*   SetRingsandMoon also handles calling functions for reading and storing each
-*   objects texure map.
-*
-*	The planet object has the following fields in order:
-*
-*		name	- planet name
-*		hours	- planet's hours in a day
-*		days	- planet's days in a year
-*		radius	- planet's raduis
-*		row 	- number of rows in planet's texture .bmp image
-*		cols	- number of columns in planet's texture .bmp image
-*		image	- pointer to location in memory of planet's stored texture map
-*					read in from .bmp image
-*		r		- planet's red value (used for color when no texture map)
-*		g		- planet's green value (used for color when no texture map)
-*		b		- planet's blue value (used for color when no texture map)
+*   Set the position and properties of the point light source. The position
+*   is set every frame, as OpenGL moves it with the view; the rest only
+*   reaches OpenGL when it changes (see glstate.cpp).
 *
 * Parameters:
 *
 *		void	- No input parameters needed.
 *
 ******************************************************************************/
-void SetRingsandMoon()
+void SetLightModel()
 {
+    //Place the light in the user's view.
+    LoadViewMatrix();
 
-    /*Variables needed for storing a pointer to and dimensions of a planet's
-    texture map. */
-    int nrows, ncols;
-    byte* image;
-    char * filename;
+    //Set value array for the light's position, at the sun.
+    GLfloat light_position[] = { 0.0, 0.0, 0.0, 1.0 };
 
-    /*Set up each planet*/
+    //Set the lighting properties.
+    glLightfv( GL_LIGHT0, GL_POSITION, light_position );
+    SetLight( GL_AMBIENT, LightAmbient );
+    SetLight( GL_DIFFUSE, LightDiffuse );
+    SetLight( GL_SPECULAR, LightSpecular );
 
-    //Convert a texture map's string name into a character array.
-    //Load a planet's texure map into memory.
-    //Construct a planet object pointed to by a global pointer (planet's name).
+    //Enable light.
+    SetCapability( GL_LIGHT0, true );
 
-    filename = StringToChar("moon.bmp");
-    LoadBmpFile( filename, nrows, ncols, image );
-    Moon = new Planet("Moon", 0, 0, 0, 0, nrows, ncols, image, 1.0, 1.0, 1.0 );
+    //Enable automatic normalization of normals.
+    SetCapability( GL_NORMALIZE, true );
 
-    filename = StringToChar("saturnrings.bmp");
-    LoadBmpFile( filename, nrows, ncols, image );
-    Rings = new Planet("Saturn Rings", 0, 0, 0, 0, nrows, ncols, image, 1.0, 0.75, 0.0 );
+    //Eliminate backfacing polygons (glCullFace starts as GL_BACK).
+    SetCapability( GL_CULL_FACE, true );
 }
 
 
@@ -145,50 +128,62 @@ void SetRingsandMoon()
 /******************************************************************************
 * Author: Daniel Hodgin and Savoy Schuler
 *
-* Function: SetLightModel
+* Function: GetMatProps
 *
 * Description:
 *
-*   Set the position and properties of the point light source.
+*   Function used for finding the material properties of any body drawn as
+*   a sphere or rings, by its kind.
 *
 * Parameters:
 *
-*		void	- No input parameters needed.
+*       body        - row of the body in the body table.
+*
+*       material    - set to the body's material properties.
 *
 ******************************************************************************/
-void SetLightModel()
+void GetMatProps(int body, Material &material)
 {
-    //Reset position.
-    glLoadIdentity();
-
-    //Handle rotion based on user view.
-    HandleRotate();
-
-    //Handle translation based on user view.
-    glTranslatef ( Xpan, Ypan, Zpan );
-
-    /*Set value arrays for ambient, diffuse, and specular light properties and
-    position.*/
-    GLfloat light_ambient[] = { 0.2, 0.2, 0.2, 1.0 };
-    GLfloat light_diffuse[] = { 1.0, 1.0, 1.0, 1.0 };
-    GLfloat light_specular[] = { 1.0, 1.0, 1.0, 1.0 };
-    GLfloat light_position[] = { 0.0, 0.0, 0.0, 1.0 };
-
-    //Set the lighting properties.
-    glLightfv( GL_LIGHT0, GL_POSITION, light_position );
-    glLightfv( GL_LIGHT0, GL_AMBIENT, light_ambient );
-    glLightfv( GL_LIGHT0, GL_DIFFUSE, light_diffuse );
-    glLightfv( GL_LIGHT0, GL_SPECULAR, light_specular );
+    unsigned flags = Bodies.Flags[body];
+
+    if (flags & BodyStar)
+        GetSunMatProp(body, material);
+    else if (flags & BodyMoon)
+        GetMoonMatProps(body, material);
+    else if (flags & BodyRings)
+        GetRingsMatProps(body, material);
+    else
+        GetPlanetMatProps(body, material);
+}
 
-    //Enable light.
-    glEnable( GL_LIGHT0 );
 
-    //Enable automatic normalization of normals.
-    glEnable( GL_NORMALIZE );
 
-    //Eliminate backfacing polygons.
-    glEnable( GL_CULL_FACE );
-    glCullFace( GL_BACK );
+/******************************************************************************
+* Author: Daniel Hodgin and Savoy Schuler
+*
+* Function: SetMatProps
+*
+* Description:
+*
+*   Function used for setting material properties found by one of the
+*   functions below, along with the object color used when lighting is off.
+*
+* Parameters:
+*
+*       material - material properties to set.
+*
+******************************************************************************/
+void SetMatProps(const Material &material)
+{
+    //Set object color.
+    SetColor( material.Color[0], material.Color[1], material.Color[2] );
+
+    //Set material properties using color arrays.
+    SetMaterial( GL_FRONT, GL_SPECULAR, material.Specular );
+    SetMaterial( GL_FRONT, GL_AMBIENT, material.Ambient );
+    SetMaterial( GL_FRONT, GL_DIFFUSE, material.Diffuse );
+    SetMaterial( GL_FRONT, GL_SHININESS, &material.Shininess );
+    SetMaterial( GL_FRONT_AND_BACK, GL_EMISSION, material.Emission );
 }
 
 
@@ -196,38 +191,36 @@ void SetLightModel()
 /******************************************************************************
 * Author: Daniel Hodgin and Savoy Schuler
 *
-* Function: SetSunMatProp
+* Function: GetSunMatProp
 *
 * Description:
 *
-*   Function used for setting the material properties for the Sun.
+*   Function used for finding the material properties for the Sun.
 *
 * Parameters:
 *
-*       sun - Planet object that holds the drawing information for the Sun.
+*       sun         - row of the Sun in the body table.
+*
+*       material    - set to the Sun's material properties.
 *
 ******************************************************************************/
-void SetSunMatProp(Planet *sun)
+void GetSunMatProp(int sun, Material &material)
 {
     //Material properties for displaying without texture map.
-    if ( textureToggle == false )
+    if ( !BodyTextured( sun ) )
     {
-        //Set color arrays for material properties.
-        GLfloat mat_emission[] = {1.0, 1.0, 0.0, 1.0};
-        GLfloat mat_shininess = { 100.0 };
-
-        //Derive material property colors from object RGB fields.
-        GLfloat color[] = {sun->getR(), sun->getG(), sun->getB()};
+        //Derive object and material property colors from object RGB fields.
+        GLfloat color[] = {Bodies.R[sun], Bodies.G[sun], Bodies.B[sun], 1.0};
 
-        //Derive object color from object RGB fields.
-        glColor3f( sun->getR(), sun->getG(), sun->getB() );
+        SetMaterialColor( material.Color, color );
+        SetMaterialColor( material.Specular, color );
+        SetMaterialColor( material.Ambient, color );
+        SetMaterialColor( material.Diffuse, color );
 
-        //Set material properties using color arrays.
-        glMaterialfv( GL_FRONT, GL_SPECULAR, color  );
-        glMaterialfv( GL_FRONT, GL_AMBIENT, color );
-        glMaterialfv( GL_FRONT, GL_DIFFUSE, color );
-        glMaterialf( GL_FRONT, GL_SHININESS, mat_shininess );
-        glMaterialfv( GL_FRONT_AND_BACK, GL_EMISSION, mat_emission );
+        //Set color arrays for material properties.
+        GLfloat mat_emission[] = {1.0, 1.0, 0.0, 1.0};
+        SetMaterialColor( material.Emission, mat_emission );
+        material.Shininess = 100.0;
     }
 
     //Material properties for displaying with texture map.
@@ -235,21 +228,20 @@ void SetSunMatProp(Planet *sun)
     {
         /*Set object color to white for best display with texture map and
         lighting.*/
-        glColor3f( 1.0, 1.0, 1.0 );
+        GLfloat white[] = { 1.0, 1.0, 1.0, 1.0 };
+        SetMaterialColor( material.Color, white );
 
         //Set color arrays for material properties.
         GLfloat mat_specular[] = { 0.0, 1.0, 0.0, 1.0 };
         GLfloat mat_diffuse[] = { 0.0, 1.0, 0.0, 1.0 };
         GLfloat mat_ambient[] = { 0.5, 1.0, 0.0, 1.0 };
         GLfloat mat_emission[] = {1.0, 1.0, 0.0, 1.0};
-        GLfloat mat_shininess = { 100.0 };
-
-        //Set material properties using color arrays.
-        glMaterialfv( GL_FRONT, GL_SPECULAR, mat_specular );
-        glMaterialfv( GL_FRONT, GL_AMBIENT, mat_ambient );
-        glMaterialfv( GL_FRONT, GL_DIFFUSE, mat_diffuse );
-        glMaterialf( GL_FRONT, GL_SHININESS, mat_shininess );
-        glMaterialfv( GL_FRONT_AND_BACK, GL_EMISSION, mat_emission );
+
+        SetMaterialColor( material.Specular, mat_specular );
+        SetMaterialColor( material.Ambient, mat_ambient );
+        SetMaterialColor( material.Diffuse, mat_diffuse );
+        SetMaterialColor( material.Emission, mat_emission );
+        material.Shininess = 100.0;
     }
 }
 
@@ -258,38 +250,37 @@ void SetSunMatProp(Planet *sun)
 /******************************************************************************
 * Author: Daniel Hodgin and Savoy Schuler
 *
-* Function: SetPlanetMatProps
+* Function: GetPlanetMatProps
 *
 * Description:
 *
-*   Function used for setting material properties of the planets.
+*   Function used for finding material properties of the planets.
 *
 * Parameters:
 *
-*       planet - Planetbject that holds the drawing information for a planet.
+*       planet      - row of the planet in the body table.
+*
+*       material    - set to the planet's material properties.
 *
 ******************************************************************************/
-void SetPlanetMatProps(Planet *planet)
+void GetPlanetMatProps(int planet, Material &material)
 {
     //Material properties for displaying without texture map.
-    if ( textureToggle == false )
+    if ( !BodyTextured( planet ) )
     {
-        //Set color arrays for material properties.
-        GLfloat mat_emission[] = {0.0, 0.0, 0.0, 1.0};
-        GLfloat mat_shininess = { 100.0 };
-
-        //Derive material property colors from object RGB fields.
-        GLfloat color[] = {planet->getR(), planet->getG(), planet->getB()};
+        //Derive object and material property colors from object RGB fields.
+        GLfloat color[] = {Bodies.R[planet], Bodies.G[planet],
+                           Bodies.B[planet], 1.0};
 
-        //Derive object color from object RGB fields.
-        glColor3f( planet->getR(), planet->getG(), planet->getB() );
+        SetMaterialColor( material.Color, color );
+        SetMaterialColor( material.Specular, color );
+        SetMaterialColor( material.Ambient, color );
+        SetMaterialColor( material.Diffuse, color );
 
-        //Set material properties using color arrays.
-        glMaterialfv( GL_FRONT, GL_SPECULAR, color  );
-        glMaterialfv( GL_FRONT, GL_AMBIENT, color );
-        glMaterialfv( GL_FRONT, GL_DIFFUSE, color );
-        glMaterialf( GL_FRONT, GL_SHININESS, mat_shininess );
-        glMaterialfv( GL_FRONT_AND_BACK, GL_EMISSION, mat_emission );
+        //Set color arrays for material properties.
+        GLfloat mat_emission[] = {0.0, 0.0, 0.0, 1.0};
+        SetMaterialColor( material.Emission, mat_emission );
+        material.Shininess = 100.0;
     }
 
     //Material properties for displaying with texture map.
@@ -297,21 +288,20 @@ void SetPlanetMatProps(Planet *planet)
     {
         /*Set object color to white for best display with texture map and
         lighting.*/
-        glColor3f( 1.0, 1.0, 1.0 );
+        GLfloat white[] = { 1.0, 1.0, 1.0, 1.0 };
+        SetMaterialColor( material.Color, white );
 
         //Set color arrays for material properties.
         GLfloat mat_specular[] = { 0.8, 0.8, 0.0, 1.0 };
         GLfloat mat_diffuse[] = { 0.8, 0.8, 0.8, 1.0 };
         GLfloat mat_ambient[] = { 0.4, 0.4, 0.4, 1.0 };
-        GLfloat mat_shininess = { 100.0 };
         GLfloat mat_emission[] = {0.0, 0.0, 0.0, 1.0};
 
-        //Set material properties using color arrays.
-        glMaterialfv( GL_FRONT, GL_SPECULAR, mat_specular );
-        glMaterialfv( GL_FRONT, GL_AMBIENT, mat_ambient );
-        glMaterialfv( GL_FRONT, GL_DIFFUSE, mat_diffuse );
-        glMaterialf( GL_FRONT, GL_SHININESS, mat_shininess );
-        glMaterialfv( GL_FRONT_AND_BACK, GL_EMISSION, mat_emission );
+        SetMaterialColor( material.Specular, mat_specular );
+        SetMaterialColor( material.Ambient, mat_ambient );
+        SetMaterialColor( material.Diffuse, mat_diffuse );
+        SetMaterialColor( material.Emission, mat_emission );
+        material.Shininess = 100.0;
     }
 }
 
@@ -320,38 +310,36 @@ void SetPlanetMatProps(Planet *planet)
 /******************************************************************************
 * Author: Daniel Hodgin and Savoy Schuler
 *
-* Function: SetMoonMatProps
+* Function: GetMoonMatProps
 *
 * Description:
 *
-*   Function used for setting the material properties of Earth's moon.
+*   Function used for finding the material properties of Earth's moon.
 *
 * Parameters:
 *
-*       Moon - Planet object that holds the drawing information for the moon.
+*       moon        - row of the moon in the body table.
+*
+*       material    - set to the moon's material properties.
 *
 ******************************************************************************/
-void SetMoonMatProps(Planet *Moon)
+void GetMoonMatProps(int moon, Material &material)
 {
     //Material properties for displaying without texture map.
-    if ( textureToggle == false )
+    if ( !BodyTextured( moon ) )
     {
-        //Set color arrays for material properties.
-        GLfloat mat_emission[] = {0.0, 0.0, 0.0, 1.0};
-        GLfloat mat_shininess = { 100.0 };
-
-        //Derive material property colors from object RGB fields.
-        GLfloat color[] = {Moon->getR(), Moon->getG(), Moon->getB()};
+        //Derive object and material property colors from object RGB fields.
+        GLfloat color[] = {Bodies.R[moon], Bodies.G[moon], Bodies.B[moon], 1.0};
 
-        //Derive object color from object RGB fields.
-        glColor3f(Moon->getR(), Moon->getG(), Moon->getB());
+        SetMaterialColor( material.Color, color );
+        SetMaterialColor( material.Specular, color );
+        SetMaterialColor( material.Ambient, color );
+        SetMaterialColor( material.Diffuse, color );
 
-        //Set material properties using color arrays.
-        glMaterialfv( GL_FRONT, GL_SPECULAR, color  );
-        glMaterialfv( GL_FRONT, GL_AMBIENT, color );
-        glMaterialfv( GL_FRONT, GL_DIFFUSE, color );
-        glMaterialf( GL_FRONT, GL_SHININESS, mat_shininess );
-        glMaterialfv( GL_FRONT_AND_BACK, GL_EMISSION, mat_emission );
+        //Set color arrays for material properties.
+        GLfloat mat_emission[] = {0.0, 0.0, 0.0, 1.0};
+        SetMaterialColor( material.Emission, mat_emission );
+        material.Shininess = 100.0;
     }
 
     //Material properties for displaying with texture map.
@@ -359,21 +347,20 @@ void SetMoonMatProps(Planet *Moon)
     {
         /*Set object color to white for best display with texture map and
         lighting.*/
-        glColor3f( 1.0, 1.0, 1.0 );
+        GLfloat white[] = { 1.0, 1.0, 1.0, 1.0 };
+        SetMaterialColor( material.Color, white );
 
         //Set color arrays for material properties.
         GLfloat mat_specular[] = { 1.0, 1.0, 1.0, 1.0 };
         GLfloat mat_diffuse[] = { 1.0, 1.0, 1.0, 1.0 };
         GLfloat mat_ambient[] = { 0.4, 0.4, 0.4, 1.0 };
-        GLfloat mat_shininess = { 100.0 };
         GLfloat mat_emission[] = {0.0, 0.0, 0.0, 1.0};
 
-        //Set material properties using color arrays.
-        glMaterialfv( GL_FRONT, GL_SPECULAR, mat_specular );
-        glMaterialfv( GL_FRONT, GL_AMBIENT, mat_ambient );
-        glMaterialfv( GL_FRONT, GL_DIFFUSE, mat_diffuse );
-        glMaterialf( GL_FRONT, GL_SHININESS, mat_shininess );
-        glMaterialfv( GL_FRONT_AND_BACK, GL_EMISSION, mat_emission );
+        SetMaterialColor( material.Specular, mat_specular );
+        SetMaterialColor( material.Ambient, mat_ambient );
+        SetMaterialColor( material.Diffuse, mat_diffuse );
+        SetMaterialColor( material.Emission, mat_emission );
+        material.Shininess = 100.0;
     }
 }
 
@@ -382,40 +369,38 @@ void SetMoonMatProps(Planet *Moon)
 /******************************************************************************
 * Author: Daniel Hodgin and Savoy Schuler
 *
-* Function: SetRingsMatProps
+* Function: GetRingsMatProps
 *
 * Description:
 *
-*   Function used for setting the material properties of Saturn's rings.
+*   Function used for finding the material properties of Saturn's rings.
 *
 * Parameters:
 *
-*       Rings - Planet object that holds the drawing information for Saturn's
-*               rings.
+*       rings       - row of Saturn's rings in the body table.
+*
+*       material    - set to the rings' material properties.
 *
 ******************************************************************************/
-void SetRingsMatProps(Planet *Rings)
+void GetRingsMatProps(int rings, Material &material)
 {
     //Material properties for displaying without texture map.
-    if ( textureToggle == false )
+    if ( !BodyTextured( rings ) )
     {
+        //Derive object and material property colors from object RGB fields.
+        GLfloat color[] = {Bodies.R[rings], Bodies.G[rings],
+                           Bodies.B[rings], 1.0};
+
+        SetMaterialColor( material.Color, color );
+        SetMaterialColor( material.Specular, color );
+        SetMaterialColor( material.Diffuse, color );
+
         //Set color arrays for material properties.
         GLfloat mat_emission[] = {0.2, 0.2, 0.2, 1.0};
         GLfloat mat_ambient[] = { 1.0, 1.0, 1.0, 1.0 };
-        GLfloat mat_shininess = { 100.0 };
-
-        //Derive material property colors from object RGB fields.
-        GLfloat color[] = {Rings->getR(), Rings->getG(), Rings->getB()};
-
-        //Derive object color from object RGB fields.
-        glColor3f( Rings->getR(), Rings->getG(), Rings->getB() );
-
-        //Set material properties using color arrays.
-        glMaterialfv( GL_FRONT, GL_SPECULAR, color  );
-        glMaterialfv( GL_FRONT, GL_AMBIENT, mat_ambient );
-        glMaterialfv( GL_FRONT, GL_DIFFUSE, color );
-        glMaterialf( GL_FRONT, GL_SHININESS, mat_shininess );
-        glMaterialfv( GL_FRONT_AND_BACK, GL_EMISSION, mat_emission );
+        SetMaterialColor( material.Emission, mat_emission );
+        SetMaterialColor( material.Ambient, mat_ambient );
+        material.Shininess = 100.0;
     }
 
     //Material properties for displaying with texture map.
@@ -423,21 +408,20 @@ void SetRingsMatProps(Planet *Rings)
     {
         /*Set object color to white for best display with texture map and
         lighting.*/
-        glColor3f( 1.0, 1.0, 1.0 );
+        GLfloat white[] = { 1.0, 1.0, 1.0, 1.0 };
+        SetMaterialColor( material.Color, white );
 
         //Set color arrays for material properties.
         GLfloat mat_specular[] = { 0.8, 0.8, 0.0, 1.0 };
         GLfloat mat_diffuse[] = { 0.8, 0.8, 0.8, 1.0 };
         GLfloat mat_ambient[] = { 1.0, 1.0, 1.0, 1.0 };
-        GLfloat mat_shininess = { 100.0 };
         GLfloat mat_emission[] = {0.2, 0.2, 0.2, 1.0};
 
-        //Set material properties using color arrays.
-        glMaterialfv( GL_FRONT, GL_SPECULAR, mat_specular );
-        glMaterialfv( GL_FRONT, GL_AMBIENT, mat_ambient );
-        glMaterialfv( GL_FRONT, GL_DIFFUSE, mat_diffuse );
-        glMaterialf( GL_FRONT, GL_SHININESS, mat_shininess );
-        glMaterialfv( GL_FRONT_AND_BACK, GL_EMISSION, mat_emission );
+        SetMaterialColor( material.Specular, mat_specular );
+        SetMaterialColor( material.Ambient, mat_ambient );
+        SetMaterialColor( material.Diffuse, mat_diffuse );
+        SetMaterialColor( material.Emission, mat_emission );
+        material.Shininess = 100.0;
     }
 }
 
@@ -468,11 +452,11 @@ void SetOrbitMatProps()
     GLfloat mat_emission[] = {0.0, 0.0, 1.0, 1.0};
 
     //Reset material properties using the zero value color arrays.
-    glMaterialfv( GL_FRONT, GL_SPECULAR, mat_specular );
-    glMaterialfv( GL_FRONT, GL_AMBIENT, mat_ambient );
-    glMaterialfv( GL_FRONT, GL_DIFFUSE, mat_diffuse );
-    glMaterialf( GL_FRONT, GL_SHININESS, mat_shininess );
-    glMaterialfv( GL_FRONT_AND_BACK, GL_EMISSION, mat_emission );
+    SetMaterial( GL_FRONT, GL_SPECULAR, mat_specular );
+    SetMaterial( GL_FRONT, GL_AMBIENT, mat_ambient );
+    SetMaterial( GL_FRONT, GL_DIFFUSE, mat_diffuse );
+    SetMaterial( GL_FRONT, GL_SHININESS, &mat_shininess );
+    SetMaterial( GL_FRONT_AND_BACK, GL_EMISSION, mat_emission );
 }
 
 
@@ -484,65 +468,43 @@ void SetOrbitMatProps()
 *
 * Description:
 *
-*   This function draws the stars in the background by drawing a sphere
-*   around the entire solar system and texture maping stars to that.
+*   This function draws the stars in the background as a skybox around the
+*   eye (see skybox.cpp). Only the view's rotation is applied, so the stars
+*   stay at infinity however the view is panned. The depth test is off while
+*   it is drawn, so it writes no depth and everything else draws over it.
+*   With texture mapping off space is left the clear color.
 *
 * Parameters:
 *
-*       space   - Space as a Planet object with drawing details.
+*       space   - row of the space backdrop in the body table.
 *
 ******************************************************************************/
-void DrawSpace(Planet *space)
+void DrawSpace(int space)
 {
-    //Draw back side of objects.
-    glDisable( GL_CULL_FACE );
-
-    //Set abient and emmison values of the space.
-    GLfloat mat_ambient[] = { 0.0, 0.0, 0.0, 1.0 };
-    GLfloat mat_emission[] = {0.0, 0.0, 0.0, 1.0};
-
-    //Set ambient and emmision of the space.
-    glMaterialfv( GL_FRONT, GL_AMBIENT, mat_ambient );
-    glMaterialfv( GL_FRONT_AND_BACK, GL_EMISSION, mat_emission );
-
-    //save the matrix.
-    glPushMatrix();
-    glColor3f( 0.0, 0.0, 0.0 );
+    if ( !textureToggle )
+        return;
 
-    //Get image and rows and cols.
-    int nrows = space->getRows();
-    int ncols = space->getCols();
-    byte* image = space->getImage();
+    //Draw inside of the box, behind everything.
+    SetCapability( GL_CULL_FACE, false );
+    SetCapability( GL_DEPTH_TEST, false );
 
-    //Set texture.
-    SetTexture(image, nrows, ncols);
+    //Show the stars as they are, in wireframe mode too.
+    SetTextureMode( GL_REPLACE );
+    SetTextureWindow( WholeTexture );
 
-    //Combine and light and texture properties.
-    glTexEnvi( GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_REPLACE );
+    if ( wire )
+        glPolygonMode( GL_FRONT_AND_BACK, GL_FILL );
 
-    //Clear the current matrix (Modelview).
-    glLoadIdentity();
-    HandleRotate();
+    //Center the box on the eye and turn it with the view.
+    LoadViewRotation();
 
-    //Back off eight units to be able to view from the origin.
-    glTranslatef ( Xpan, Ypan, Zpan );
+    DrawSkybox( space );
 
-    //Draw the sun as a yellow, wireframe sphere.
-    glColor3f( 0.0, 0.0, 0.0 );
+    if ( wire )
+        glPolygonMode( GL_FRONT_AND_BACK, GL_LINE );
 
-    //Make quadric object.
-    GLUquadric *quad;
-    quad = gluNewQuadric();
-
-    //Enable texture.
-    gluQuadricTexture(quad, GL_TRUE);
-
-    //Draw Sphere.
-    gluSphere(quad, 300.0, 100, 100 );
-    gluDeleteQuadric( quad );
-
-    //Disable drawing background.
-    glEnable( GL_CULL_FACE );
+    SetCapability( GL_DEPTH_TEST, true );
+    SetCapability( GL_CULL_FACE, true );
 }
 
 
@@ -554,67 +516,32 @@ void DrawSpace(Planet *space)
 *
 * Description:
 *
-*   This function draws the sun. It takes in the sun as a planet object.
-*   This function also set the lighting and texture properties and sets
-*   a point light source for the entire field
+*   This function draws the sun. It takes in the sun's row in the body table.
+*   This function also set the lighting and texture properties. The point
+*   light source at the sun is set by SetLightModel before any drawing, so
+*   the planets are still lit when the sun itself is outside the view.
 *
 * Parameters:
 *
-*       sun - Planet class that holds the drawing information for the sun.
+*       sun - row of the sun in the body table.
 *
 ******************************************************************************/
-void DrawSun(Planet *sun)
+void DrawSun(int sun)
 {
-    float radius = sun->getRadius();
-    int nrows = sun->getRows();
-    int ncols = sun->getCols();
-    byte* image = sun->getImage();
+    float radius = Bodies.Radius[sun];
+    float position[3] = { 0.0, 0.0, 0.0 };
 
-    //Set the lighting model.
-    SetLightModel();
-
-    //Variable to keep track sun rotation.
-    static float hours = 0.0;
-
-    //If animation is on increment time.
-    if ( spinMode )
+    //Skip the sun if it is outside the view.
+    if ( !SphereInView( position, radius ) )
     {
-        hours += AnimateIncrement;
-        hours = hours;
+        FrameStats.BodiesCulled++;
+        return;
     }
 
-    //Set suns material properties.
-    SetSunMatProp(sun);
-
-    //Set the suns textures.
-    SetTexture(image, nrows, ncols);
-    glTexEnvi( GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_MODULATE );
-
-    // Clear the current matrix (Modelview).
-    glLoadIdentity();
-
-    //Handle rotation by users view.
-    HandleRotate();
-
-    //Handle translation from user view.
-    glTranslatef ( Xpan, Ypan, Zpan );
-
-
-
-    //Calculate rotation.
-    glRotatef(360.0 * hours/25.0, 0.0, 0.0, 1.0 );
-
-    //Make quadric object.
-    GLUquadric *quad;
-    quad = gluNewQuadric();
-
-    //Enable object textures.
-    gluQuadricTexture(quad, GL_TRUE);
-
-    //Draw the sun.
-    gluSphere(quad, radius, Resolution, Resolution );
-    gluDeleteQuadric( quad );
+    FrameStats.BodiesDrawn++;
 
+    //Draw the sun, spinning, with its material and texture.
+    DrawBodySphere(sun, position, radius);
 }
 
 
@@ -627,121 +554,86 @@ void DrawSun(Planet *sun)
 * Description:
 *
 *   This function will draw the planet. It sets the position of the planet by
-*   a geometric rotation and then a geometric translation. It takes in a planet
-*   object and uses that data for the drawing information.
+*   a geometric rotation and then a geometric translation. It takes in the
+*   planet's row in the body table and uses that data for the drawing
+*   information.
+*
+*   The planet and its name are skipped if neither is in view. Its orbit is
+*   drawn separately, by DrawOrbits, and its moons and rings are rows of
+*   their own.
 *
 * Parameters:
 *
-*   planet - Planet object that contains all the information needed for drawing.
+*   planet - row of the planet in the body table.
 *
 ******************************************************************************/
-void DrawPlanet(Planet *planet)
+void DrawPlanet(int planet)
 {
     //Get information for calculating planet's location.
-    float HoursPerDay = planet->getHoursPerDay();
-    float DaysPerYear = planet->getDaysPerYear();
-    float DayOfYear = planet->getDayOfYear();
-    float HourOfDay = planet->getHourOfDay();
-    float DayIncrement;
-    float hourIncrement;
-    int Radius = planet->getRadius();
-    float Distance = planet->getDistance()*DistScale + 69600*SizeScale;
-
-    //Recenter drawing location.
-    glLoadIdentity();
-
-    //Rotate to the correct spot.
-    HandleRotate();
-
-    //Translate to the correct spot.
-    glTranslatef ( Xpan, Ypan, Zpan );
-
-    //if orbits are on then draw orbits.
-    if(paths == true)
-        DrawOrbit(Distance);
-
-    //if animation is on than increment the times of the planet.
-    if ( spinMode )
-    {
-        // Update the animation state.
-        DayIncrement = AnimateIncrement / 24.0;
-        hourIncrement = AnimateIncrement -(int)DayIncrement * 24;
+    float Radius = Bodies.Radius[planet];
+    float position[3];
 
-        //Increment the DayOfYear and HourOfDay.
-        DayOfYear += DayIncrement;
-        HourOfDay += hourIncrement;
+    //Skip the planet and its name if outside the view.
+    TransformPosition(planet, position);
 
-        //Save new times in planet object.
-        planet->setDayOfYear(DayOfYear);
-        planet->setHourOfDay(HourOfDay);
+    if ( !SphereInView( position, GetPlanetExtent(planet) ) )
+    {
+        FrameStats.BodiesCulled++;
+        return;
     }
 
-    //Get Day and Hour.
-    DayOfYear = planet->getDayOfYear();
-    HourOfDay = planet->getHourOfDay();
-
-
-    //Draw the Planet.
-
-    /*First position it around the sun. Use DayOfYear and DaysPerYear
-      calculate positions.*/
-    glRotatef( 360.0 * DayOfYear / DaysPerYear, 0.0, 0.0, 1.0 );
-
-    //Then position it away from the sun.
-    glTranslatef( Distance, 0.0, 0.0 );
-
-    // Save matrix state.
-    glPushMatrix();
-
-    /* Second, rotate the earth on its axis. Use HourOfDay and HoursPerDay
-       to determine its rotation.*/
-    glRotatef( 360.0 * HourOfDay/HoursPerDay, 0.0, 0.0, 1.0 );
+    FrameStats.BodiesDrawn++;
 
     //Draw names if names are on.
     if (planetNames == true)
-        DrawTextString(planet->getName(), planet->getRadius());
-
-
-    //Set planets Material properties.
-    SetPlanetMatProps(planet);
-
-    //Get the image and the rows and columns of the image.
-    int nrows = planet->getRows();
-    int ncols = planet->getCols();
-    byte* image = planet->getImage();
-
-    //Set the texture of the planet.
-    SetTexture(image, nrows, ncols);
+        DrawTextString(Bodies.Name[planet], position, Radius, false);
 
-    //Combine the texture and lighting propertites.
-    glTexEnvi( GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_MODULATE );
-
-    //Create the quadric object.
-    GLUquadric *quad;
-    quad = gluNewQuadric();
+    /*Draw the planet around the sun by its orbit phase, turned on its axis
+    by its spin phase.*/
+    DrawBodySphere(planet, position, Radius*SizeScale);
+}
 
-    //Enable texturing on the object.
-    gluQuadricTexture(quad, GL_TRUE);
 
-    //Draw the planet.
-    gluSphere(quad, Radius*SizeScale, Resolution, Resolution);
 
-    //Delete the Quadric.
-    gluDeleteQuadric( quad );
+/******************************************************************************
+* Author: Daniel Hodgin and Savoy Schuler
+*
+* Function: DrawMoon
+*
+* Description:
+*
+*   This function draw a moon in the proper place around its planet, as
+*   placed for the time of year by UpdateTransforms, at the size given in the
+*   catalog. This function uses the cached sphere mesh to draw the moon and
+*   texture map to it. The moon and its name are skipped if neither is in
+*   view.
+*
+* Parameters:
+*
+*   moon            - Row of the moon in the body table.
+*
+******************************************************************************/
+void DrawMoon(int moon)
+{
+    float radius = Bodies.Radius[moon] * SizeScale;
+    float position[3];
+    TransformPosition(moon, position);
 
-    /*Special cases for Saturn and Earth. If Earth draw moon.
-      If Saturn draw rings.*/
-    if(planet->getName() == "Earth")
-    {
-        DrawMoon(DayOfYear);
-    }
-    else if(planet->getName() == "Saturn")
+    //Names are drawn one unit below the moon.
+    if ( !SphereInView( position, planetNames ? radius + 1.0f : radius ) )
     {
-        DrawRings(Radius);
+        FrameStats.BodiesCulled++;
+        return;
     }
 
-    //Restore matrix state.
-    glPopMatrix();
+    FrameStats.BodiesDrawn++;
+
+    //Draw the moon in its place around its planet.
+    DrawBodySphere(moon, position, radius);
+
+    //Draw name if names toggel is set to true.
+    if (planetNames == true)
+        DrawTextString(Bodies.Name[moon], position, Bodies.Radius[moon], true);
 }
 
 
@@ -749,55 +641,73 @@ void DrawPlanet(Planet *planet)
 /******************************************************************************
 * Author: Daniel Hodgin and Savoy Schuler
 *
-* Function: DrawMoon
+* Function: Draw Rings
 *
 * Description:
 *
-*   This function draw the moon in the proper place around the earth.
-*   It reads in the day of the year and sets the location based of that value.
-*   This function uses the gluSphere function to draw the moon and texture
-*   map to it.
+*   This function draws the rings of a planet as a flat annulus from the
+*   mesh cache (see meshes.cpp). The outside and inside radii are set by
+*   offsetting the radius of the planet they circle. A bmp is also mapped
+*   to the rings. They are skipped if they are outside the view.
 *
 * Parameters:
 *
-*   DayOfYear       - The time of year to set the location of the moon.
+*   rings           - Row of the rings in the body table.
 *
 ******************************************************************************/
-void DrawMoon(int DayOfYear)
+void DrawRings(int rings)
 {
-    int nrows = Moon->getRows();
-    int ncols = Moon->getCols();
-    byte* image = Moon->getImage();
+    //Rings are sized from their planet.
+    if ( Bodies.Parent[rings] < 0 )
+        return;
 
-    //Rotate the location of the moon around the based of the time.
-    glRotatef( 360.0 * 12.0 * DayOfYear / 365.0, 0.0, 0.0, 1.0 );
+    float planetRadius = Bodies.Radius[Bodies.Parent[rings]];
+    float inner = planetRadius * SizeScale + 0.5;
+    float outer = planetRadius * SizeScale + 2;
+    float position[3];
 
-    //Translate the moon away from the earth.
-    glTranslatef( 0.7, 0.0, 0.0 );
+    //Skip the rings if they are outside the view.
+    TransformPosition(rings, position);
 
-    //Set the moons material properties.
-    SetMoonMatProps(Moon);
+    if ( !SphereInView( position, outer ) )
+    {
+        FrameStats.BodiesCulled++;
+        return;
+    }
 
-    //Set the moons textures properties.
-    SetTexture(image, nrows, ncols);
+    FrameStats.BodiesDrawn++;
 
-    //Combine texture and lighting properties.
-    glTexEnvi( GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_MODULATE );
+    //Enable drawing the back side of polygons
+    SetCapability( GL_CULL_FACE, false );
 
-    //Create quadric object.
-    GLUquadric *quad;
-    quad = gluNewQuadric();
+    /*The rings lie in the plane of the planet's orbit, so pull them toward
+    the viewer to cover the orbital path there.*/
+    SetCapability( GL_POLYGON_OFFSET_FILL, true );
+    glPolygonOffset( -1.0, -1.0 );
 
-    //Enable texture.
-    gluQuadricTexture(quad, GL_TRUE);
+    //Draw the rings with the shader renderer if it is on.
+    if ( !DrawShadedRings(rings, inner, outer, Resolution) )
+    {
+        //Set the rings material properties.
+        Material material;
+        GetMatProps(rings, material);
+        SetMatProps(material);
 
-    //Draw moon.
-    gluSphere(quad, 0.1, Resolution, Resolution );
-    gluDeleteQuadric( quad );
-    
-    //Draw name if names toggel is set to true.
-    if (planetNames == true)
-        DrawTextString(Moon->getName(), Moon->getRadius());
+        //Bind the rings texture, combined with lighting.
+        SetTexture(rings);
+        SetTextureMode( GL_MODULATE );
+
+        //Load the rings' place, turned with their planet.
+        LoadTransform(rings);
+
+        //Draw the rings from their cached annulus.
+        DrawRingMesh(rings, inner, outer, Resolution);
+    }
+
+    SetCapability( GL_POLYGON_OFFSET_FILL, false );
+
+    //Disable drawing backside of polygons.
+    SetCapability( GL_CULL_FACE, true );
 }
 
 
@@ -805,53 +715,53 @@ void DrawMoon(int DayOfYear)
 /******************************************************************************
 * Author: Daniel Hodgin and Savoy Schuler
 *
-* Function: Draw Rings
+* Function: DrawBodySphere
 *
 * Description:
 *
-*   This function draws the rings of saturn. It uses the gluCylinder to draw
-*   the rings. It takes in saturns radius and sets the outside and inside
-*   radii by offsetting that value. A bmp is also mapped to the rings.
+*   This function draws a body's sphere in its place, with its material
+*   properties and texture, at a resolution picked from its size on screen.
+*   The shader renderer draws it if it is on, as an impostor if it is only a
+*   few pixels across; otherwise the material, texture and matrix are set
+*   and it is drawn with fixed function OpenGL, from the virtual texture
+*   cache if its texture map is tiled.
 *
 * Parameters:
 *
-*   planetRadius    - The radius of saturn.
+*   body        - row of the body in the body table.
+*
+*   position    - the body's center.
+*
+*   radius      - the body's radius as drawn.
 *
 ******************************************************************************/
-void DrawRings(double planetRadius)
+void DrawBodySphere(int body, const float position[3], float radius)
 {
-    int nrows = Rings->getRows();
-    int ncols = Rings->getCols();
-    byte* image = Rings->getImage();
-
-    //Enable drawing the back side of polygons
-    glDisable( GL_CULL_FACE );
-
-    //Set the rings material properties.
-    SetRingsMatProps(Rings);
-
-    //Set the rings texture properties.
-    SetTexture(image, nrows, ncols);
+    //Too small on screen for a mesh to show, drawn as an impostor.
+    if ( ImpostorSized( ProjectedRadius( position, radius ) ) &&
+            DrawShadedImpostor( body, radius ) )
+        return;
 
-    //Combine texture mapping with lighting material properties.
-    glTexEnvi( GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_MODULATE );
+    int resolution = SelectLod( body, position, radius );
 
-    //Create glu quadric object.
-    GLUquadric *quad;
-    quad = gluNewQuadric();
+    if ( DrawShadedSphere( body, radius, resolution ) )
+        return;
 
-    //Enable textures on the object.
-    gluQuadricTexture(quad, GL_TRUE);
+    //Set the body's material properties.
+    Material material;
+    GetMatProps(body, material);
+    SetMatProps(material);
 
-    //Draw the rings using gluCylinder.
-    gluCylinder(quad, planetRadius * SizeScale + 0.5,
-                planetRadius * SizeScale + 2 ,0.1, Resolution, Resolution);
+    //Bind the body's texture, combined with lighting.
+    SetTexture(body);
+    SetTextureMode( GL_MODULATE );
 
-    //Delete the quadric object.
-    gluDeleteQuadric( quad );
+    //Load the body's place and turn.
+    LoadTransform(body);
 
-    //Disable drawing backside of polygons.
-    glEnable( GL_CULL_FACE );
+    if ( !DrawVirtualSphere( body, position, TransformAngle(body), radius,
+                             resolution ) )
+        DrawSphere( radius, resolution );
 }
 
 
@@ -859,50 +769,69 @@ void DrawRings(double planetRadius)
 /******************************************************************************
 * Author: Daniel Hodgin and Savoy Schuler
 *
-* Function: DrawOrbit
+* Function: DrawOrbits
 *
 * Description:
 *
-*   This function draws the orbit path for the planet. It takes in the planet
-*   distance to the surface and draws a circle centered at the sun.
+*   This function draws the orbital paths of the planets as blue rings
+*   centered at the sun. Orbits whose bounding sphere is outside the view are
+*   skipped, and the rest are drawn together from the cached orbit meshes
+*   (see meshes.cpp).
 *
 * Parameters:
 *
-*   planetDistance      - Distance of planet to the surface of the sun.
+*		void	- No input parameters needed.
 *
 ******************************************************************************/
-void DrawOrbit(double planetDistance)
+void DrawOrbits()
 {
+    //Skip the orbits that are outside the view.
+    float center[3] = { 0.0, 0.0, 0.0 };
+    vector<int> visible;
+
+    for ( int i = 0; i < BodyCount(); i++ )
+    {
+        if ( !( Bodies.Flags[i] & BodyPlanet ) )
+            continue;
+
+        if ( !SphereInView( center, GetOrbitRadius(i) + OrbitWidth ) )
+        {
+            FrameStats.OrbitsCulled++;
+            continue;
+        }
+
+        FrameStats.OrbitsDrawn++;
+        visible.push_back( i );
+    }
+
+    if ( visible.empty() )
+        return;
+
+    //Orbits are centered on the sun, so only the user's view is needed.
+    LoadViewMatrix();
+
     //Have opengl draw backs of objects.
-    glDisable( GL_CULL_FACE );
+    SetCapability( GL_CULL_FACE, false );
 
     //If textures toggle is off disable textures.
     if ( textureToggle == true )
-        glDisable( GL_TEXTURE_2D );
+        SetCapability( GL_TEXTURE_2D, false );
 
     //Set orbits material properties.
     SetOrbitMatProps();
 
     //Set color to blue.
-    glColor3f( 0.0, 0.0, 1.0 );
-
-    //Create quadric object.
-    GLUquadric *quad;
-    quad = gluNewQuadric();
-
-    //Enable texture.
-    gluQuadricTexture(quad, GL_TRUE);
+    SetColor( 0.0, 0.0, 1.0 );
 
-    //Draw orbit.
-    gluPartialDisk(quad,planetDistance, planetDistance+0.05,50,50,0,360);
-    gluDeleteQuadric( quad );
+    //Draw the orbits.
+    DrawOrbitMeshes( visible );
 
     //Reenable textures if were disabled.
     if ( textureToggle == true )
-        glEnable( GL_TEXTURE_2D );
+        SetCapability( GL_TEXTURE_2D, true );
 
     //Disable of drawing the back of objects.
-    glEnable( GL_CULL_FACE );
+    SetCapability( GL_CULL_FACE, true );
 }
 
 
@@ -914,7 +843,8 @@ void DrawOrbit(double planetDistance)
 *
 * Description:
 *
-*   This draws a string in the glut window based on x and y components.
+*   This queues a body's name to be drawn above or below it. Names are drawn
+*   together at the end of the frame by DrawLabels (see labels.cpp).
 *
 * Modified by: Daniel Hodgin and Savoy Schuler
 *
@@ -925,43 +855,52 @@ void DrawOrbit(double planetDistance)
 *
 * Parameters:
 *
-*       str     - text that needs to be displayed
+*       str     - text that needs to be displayed, kept until drawn
+*
+*       position    - center of the body
 *
 *       radius  - radius of the planet
 *
+*       below   - draw the text below the body instead of above (moons)
+*
 ******************************************************************************/
-void DrawTextString( string str, double radius)
+void DrawTextString( const string &str, const float position[3],
+                     double radius, bool below)
 {
-    //Disable the textures if they are off.
-    if ( textureToggle == true )
-        glDisable( GL_TEXTURE_2D );
+    //Special case for moons, draw it below the planet. Whole units, as
+    //glRasterPos3i was given, rounded down so a moon smaller than a unit
+    //still has its name below it.
+    float raster[3] = { position[0], position[1], position[2] };
 
-    //Set emission value.
-    GLfloat mat_emission[] = {1.0, 1.0, 1.0, 1.0};
-
-    //Enable emission.
-    glMaterialfv( GL_FRONT_AND_BACK, GL_EMISSION, mat_emission );
-
-    //Set the text color
-    GLfloat textColor[] = { 1.0, 1.0, 1.0 };
-    glColor3fv( textColor );
-
-    //Special case for moon, draw it below earth.
-    if(str == "Moon")
-        glRasterPos3i( 0,0, radius * SizeScale - 1 );
+    if(below)
+        raster[2] += floor( radius * SizeScale - 1.0 );
     else
-        glRasterPos3i( 0,0, radius * SizeScale + 1 );
+        raster[2] += ( int ) ( radius * SizeScale + 1 );
+
+    //Queue the text, drawn with the others at the end of the frame.
+    QueueLabel( str, raster );
+}
 
-    //Draw the text.
-    for (unsigned int i = 0; i < str.length(); i++)
-    {
-        glutBitmapCharacter( GLUT_BITMAP_9_BY_15, str[i] );
-    }
 
-    //Enable texture if it had been turned off.
-    if ( textureToggle == true )
-        glEnable( GL_TEXTURE_2D );
 
+/******************************************************************************
+* Author: Daniel Hodgin and Savoy Schuler
+*
+* Function: GetOrbitRadius
+*
+* Description:
+*
+*   This function returns the radius of a planet's orbit as drawn: its
+*   distance from the surface of the sun plus the sun's radius, both scaled.
+*
+* Parameters:
+*
+*   planet      - row of the planet in the body table.
+*
+******************************************************************************/
+float GetOrbitRadius(int planet)
+{
+    return Bodies.Distance[planet]*DistScale + 69600*SizeScale;
 }
 
 
@@ -969,36 +908,29 @@ void DrawTextString( string str, double radius)
 /******************************************************************************
 * Author: Daniel Hodgin and Savoy Schuler
 *
-* Function: SetTexture
+* Function: GetPlanetPosition
 *
 * Description:
 *
-*   This function is used for referencing texture maps stored in memory and
-*   setting it up for GL_MODULATE to mesh with material color and lighting in
-*   the glTexEnvi command.
+*   This function finds the center of a planet in solar system coordinates,
+*   matching the rotation and translation DrawPlanet uses to place it in the
+*   frame being drawn.
 *
 * Parameters:
 *
-*   image   - pointer to location of texture map in memory
-*
-*   nrows   - texture map's number of rows
+*   planet      - row of the planet in the body table.
 *
-*   ncols   - texture map's number of columns
+*   position    - returned center of the planet.
 *
 ******************************************************************************/
-int SetTexture( byte* image, int nrows, int ncols )
+void GetPlanetPosition(int planet, float position[3])
 {
-    //Set texture parameters.
-    glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT );
-    glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT );
-    glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR );
-    glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR );
-
-    //Build minmaps.
-    gluBuild2DMipmaps( GL_TEXTURE_2D, GL_RGB, ncols, nrows, GL_RGB, GL_UNSIGNED_BYTE, image );
+    float Distance = GetOrbitRadius(planet);
+    float orbitAngle = 2.0 * PI * OrbitPhase(planet);
 
-    //Return success.
-    return 0;
+    position[0] = Distance * cos( orbitAngle );
+    position[1] = Distance * sin( orbitAngle );
+    position[2] = 0.0;
 }
 
 
@@ -1006,28 +938,28 @@ int SetTexture( byte* image, int nrows, int ncols )
 /******************************************************************************
 * Author: Daniel Hodgin and Savoy Schuler
 *
-* Function: HandleRotate
+* Function: GetPlanetExtent
 *
 * Description:
 *
-*	This function handles the x,y,z rotation based off of globals that are
-*   set by our user control functions
+*   This function returns the radius of a sphere around a planet's center that
+*   holds everything drawn with the planet: the planet and its name.
 *
 * Parameters:
 *
-*		void	- No input parameters needed.
+*   planet      - row of the planet in the body table.
 *
 ******************************************************************************/
-void HandleRotate()
+float GetPlanetExtent(int planet)
 {
-    //Rotate on x axis.
-    glRotatef( Xrot, 1.0, 0.0, 0.0);
+    float radius = Bodies.Radius[planet] * SizeScale;
+    float extent = radius;
 
-    //Rotate on y axis.
-    glRotatef( Yrot, 0.0, 1.0, 0.0);
+    //Names are drawn one unit past the planet's radius.
+    if (planetNames == true)
+        extent = radius + 1.0;
 
-    //Rotate on z axis.
-    glRotatef( Zrot, 0.0, 0.0, 1.0);
+    return extent;
 }
 
 
@@ -1035,26 +967,21 @@ void HandleRotate()
 /******************************************************************************
 * Author: Daniel Hodgin and Savoy Schuler
 *
-* Function: StringToChar
+* Function: SetMaterialColor
 *
 * Description:
 *
-*   This function converts a string into a * char
+*   This function copies a color into one of a material's properties.
 *
 * Parameters:
 *
-*   str         -string to convert to a char *
+*   property    - material property to set.
+*
+*   color       - RGBA color.
 *
 ******************************************************************************/
-char * StringToChar (string str)
+static void SetMaterialColor(GLfloat property[4], const GLfloat color[4])
 {
-    //Allocate memory.
-    char * filename = new char[str.size() + 1];
-
-    //Copy data to the char * array.
-    std::copy(str.begin(), str.end(), filename);
-
-    //Add null terminator.
-    filename[str.size()] = '\0'; // don't forget the terminating 0
-    return filename;
+    for (int i = 0; i < 4; i++)
+        property[i] = color[i];
 }
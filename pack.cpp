@@ -0,0 +1,393 @@
+/******************************************************************************
+*	File: pack.cpp
+*
+*	Authors: Savoy Schuler and Daniel Hodgin
+*
+*	Date: 11-17-16
+*
+*	Description:
+*
+*		This file contains the texture pack reader. If a texture pack built by
+*       the packer (see packer.cpp and pack.h) is found at startup it is mapped
+*       into memory whole, and texture maps found in it are uploaded straight
+*       from the mapping, every mipmap level already built, instead of being
+*       decoded from their .bmp files. Only the pages actually uploaded are
+*       ever read, and they come from the page cache after the first launch.
+*       Texture maps missing from the pack are still read from their files.
+*       The backdrop's cube map faces are found here too.
+*
+*       The pack stays mapped for the whole run, so texture maps evicted by
+*       the asset loader can be uploaded again without reading anything.
+*
+*       Tiled texture maps are read a tile at a time by the virtual texture
+*       cache (see vtexture.cpp). So that reading a tile never stalls a frame,
+*       the kernel is asked to read its pages in the background, and it is
+*       only uploaded once they are all in memory.
+*
+*	File Order and Structure:
+*
+*       - Open the pack.
+*       - Find texture maps.
+*       - Read pages.
+*
+*	Modified:
+*
+*		Original
+*
+*	Functions Included:
+*
+*           //Open the pack.
+*
+*       bool OpenTexturePack( const char *filename );
+*
+*           //Find texture maps.
+*
+*       static const PackEntry* FindEntry( const char *name );
+*       bool FindPackedTexture( const char *name, TextureLevels &levels );
+*       bool FindPackedTiles( const char *name, TextureLevels &levels );
+*       const byte* FindPackedCube( const char *name, int &size );
+*
+*           //Read pages.
+*
+*       void PrefetchPack( const byte* start, size_t bytes );
+*       bool PackResident( const byte* start, size_t bytes );
+*
+******************************************************************************/
+
+/**************************** Library Includes *******************************/
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <GL/freeglut.h>
+#include <iostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#include "Planet.h"
+#include "globals.h"
+#include "pack.h"
+
+/******************************* Name Space **********************************/
+
+using namespace std;
+
+/******************************* Constants **********************************/
+
+static_assert( PackMaxLevels <= MaxTextureLevels,
+               "pack levels must fit in TextureLevels" );
+
+/********************************* Globals ***********************************/
+
+//Texture pack read at startup, if it exists.
+string PackFile = "textures.pak";
+
+//The mapped pack, NULL if none is open.
+static const byte* Pack = NULL;
+
+//Entry of each texture map in the pack.
+static unordered_map<string, const PackEntry*> PackEntries;
+
+/*************************** Function Prototypes *****************************/
+
+static const PackEntry* FindEntry( const char *name );
+
+
+
+/******************************************************************************
+* Author: Savoy Schuler and Daniel Hodgin
+*
+* Function: OpenTexturePack
+*
+* Description:
+*
+*   This function maps a texture pack into memory and reads its table of
+*   contents. Returns false if there is no pack, and also, after printing
+*   why, if it is not a pack this program can read; texture maps are then
+*   read from their own files.
+*
+* Parameters:
+*
+*   filename    - texture pack to open
+*
+******************************************************************************/
+bool OpenTexturePack( const char *filename )
+{
+#if defined(_WIN32)
+    return false;
+#else
+    int file = open( filename, O_RDONLY );
+    if ( file < 0 )
+        return false;
+
+    struct stat status;
+    if ( fstat( file, &status ) != 0 || status.st_size < ( off_t ) sizeof( PackHeader ) )
+    {
+        close( file );
+        fprintf( stderr, "OpenTexturePack(): not a texture pack: %s\n", filename );
+        return false;
+    }
+
+    uint64_t size = status.st_size;
+    void *mapping = mmap( NULL, size, PROT_READ, MAP_PRIVATE, file, 0 );
+    close( file );
+
+    if ( mapping == MAP_FAILED )
+    {
+        fprintf( stderr, "OpenTexturePack(): unable to map file: %s\n", filename );
+        return false;
+    }
+
+    //Check the header and that every level lies inside the file.
+    const byte* pack = ( const byte* ) mapping;
+    const PackHeader* header = ( const PackHeader* ) pack;
+    const PackEntry* entries = ( const PackEntry* ) ( header + 1 );
+    bool ok = memcmp( header->Magic, PackMagic, sizeof( PackMagic ) ) == 0 &&
+              header->Version == PackVersion &&
+              header->Count <= ( size - sizeof( PackHeader ) ) / sizeof( PackEntry );
+
+    for ( uint32_t i = 0; ok && i < header->Count; i++ )
+    {
+        const PackEntry &entry = entries[i];
+        uint64_t cols = entry.Cols, rows = entry.Rows;
+
+        ok = entry.Levels > 0 && entry.Levels <= ( uint32_t ) PackMaxLevels &&
+             entry.Tiled <= 1 && memchr( entry.Name, '\0', PackNameLength ) != NULL;
+
+        //A cube map is one level of square faces.
+        if ( entry.Cube )
+            ok = ok && entry.Cube == 1 && !entry.Tiled && entry.Levels == 1 &&
+                 entry.Cols == entry.Rows;
+
+        for ( uint32_t level = 0; ok && level < entry.Levels; level++ )
+        {
+            uint64_t bytes = PackLevelBytes( entry, cols, rows );
+
+            ok = bytes > 0 && entry.Offset[level] <= size &&
+                 bytes <= size - entry.Offset[level];
+
+            cols = cols > 1 ? cols / 2 : 1;
+            rows = rows > 1 ? rows / 2 : 1;
+        }
+    }
+
+    if ( !ok )
+    {
+        munmap( mapping, size );
+        fprintf( stderr, "OpenTexturePack(): not a texture pack: %s\n", filename );
+        return false;
+    }
+
+    Pack = pack;
+    for ( uint32_t i = 0; i < header->Count; i++ )
+        PackEntries[entries[i].Name] = &entries[i];
+
+    return true;
+#endif
+}
+
+
+
+/******************************************************************************
+* Author: Savoy Schuler and Daniel Hodgin
+*
+* Function: FindEntry
+*
+* Description:
+*
+*   This function returns the entry of a texture map in the open pack, or
+*   NULL if it is not there.
+*
+* Parameters:
+*
+*   name    - .bmp file the texture map was read from
+*
+******************************************************************************/
+static const PackEntry* FindEntry( const char *name )
+{
+    if ( Pack == NULL )
+        return NULL;
+
+    unordered_map<string, const PackEntry*>::iterator found = PackEntries.find( name );
+    if ( found == PackEntries.end() )
+        return NULL;
+
+    return found->second;
+}
+
+
+
+/******************************************************************************
+* Author: Savoy Schuler and Daniel Hodgin
+*
+* Function: FindPackedTexture
+*
+* Description:
+*
+*   This function looks a texture map up in the open pack. Returns true and
+*   the place of each of its levels in the mapping if it is there and not
+*   tiled.
+*
+* Parameters:
+*
+*   name    - .bmp file the texture map was read from
+*
+*   levels  - returned size and levels of the texture map
+*
+******************************************************************************/
+bool FindPackedTexture( const char *name, TextureLevels &levels )
+{
+    const PackEntry* entry = FindEntry( name );
+    if ( entry == NULL || entry->Tiled || entry->Cube )
+        return false;
+
+    levels.Cols = entry->Cols;
+    levels.Rows = entry->Rows;
+    levels.Levels = entry->Levels;
+
+    for ( uint32_t level = 0; level < entry->Levels; level++ )
+        levels.Level[level] = Pack + entry->Offset[level];
+
+    return true;
+}
+
+
+
+/******************************************************************************
+* Author: Savoy Schuler and Daniel Hodgin
+*
+* Function: FindPackedTiles
+*
+* Description:
+*
+*   This function looks a tiled texture map up in the open pack. Returns
+*   true and the place of the first tile of each of its levels in the
+*   mapping if it is there (see pack.h for the layout of the tiles).
+*
+* Parameters:
+*
+*   name    - .bmp file the texture map was read from
+*
+*   levels  - returned size and levels of the texture map
+*
+******************************************************************************/
+bool FindPackedTiles( const char *name, TextureLevels &levels )
+{
+    const PackEntry* entry = FindEntry( name );
+    if ( entry == NULL || !entry->Tiled || entry->Cube )
+        return false;
+
+    levels.Cols = entry->Cols;
+    levels.Rows = entry->Rows;
+    levels.Levels = entry->Levels;
+
+    for ( uint32_t level = 0; level < entry->Levels; level++ )
+        levels.Level[level] = Pack + entry->Offset[level];
+
+    return true;
+}
+
+
+
+/******************************************************************************
+* Author: Savoy Schuler and Daniel Hodgin
+*
+* Function: FindPackedCube
+*
+* Description:
+*
+*   This function looks a backdrop's cube map up in the open pack. Returns
+*   the place of its six faces in the mapping (see pack.h for their layout),
+*   or NULL if it is not there.
+*
+* Parameters:
+*
+*   name    - .cube file the faces would be saved to
+*
+*   size    - returned texels on each side of a face
+*
+******************************************************************************/
+const byte* FindPackedCube( const char *name, int &size )
+{
+    const PackEntry* entry = FindEntry( name );
+    if ( entry == NULL || !entry->Cube )
+        return NULL;
+
+    size = entry->Cols;
+
+    return Pack + entry->Offset[0];
+}
+
+
+
+/******************************************************************************
+* Author: Savoy Schuler and Daniel Hodgin
+*
+* Function: PrefetchPack
+*
+* Description:
+*
+*   This function asks the kernel to start reading part of the pack into
+*   memory, without waiting for it.
+*
+* Parameters:
+*
+*   start   - first byte wanted, inside the mapping
+*
+*   bytes   - number of bytes wanted
+*
+******************************************************************************/
+void PrefetchPack( const byte* start, size_t bytes )
+{
+#if !defined(_WIN32)
+    uintptr_t page = sysconf( _SC_PAGESIZE );
+    uintptr_t first = ( uintptr_t ) start / page * page;
+
+    madvise( ( void * ) first, ( uintptr_t ) start + bytes - first, MADV_WILLNEED );
+#endif
+}
+
+
+
+/******************************************************************************
+* Author: Savoy Schuler and Daniel Hodgin
+*
+* Function: PackResident
+*
+* Description:
+*
+*   Returns true if every page of part of the pack is in memory, so reading
+*   it will not wait for the disk.
+*
+* Parameters:
+*
+*   start   - first byte wanted, inside the mapping
+*
+*   bytes   - number of bytes wanted
+*
+******************************************************************************/
+bool PackResident( const byte* start, size_t bytes )
+{
+#if defined(_WIN32)
+    return true;
+#else
+    uintptr_t page = sysconf( _SC_PAGESIZE );
+    uintptr_t first = ( uintptr_t ) start / page * page;
+    size_t length = ( uintptr_t ) start + bytes - first;
+    vector<unsigned char> resident( ( length + page - 1 ) / page );
+
+    if ( mincore( ( void * ) first, length, &resident[0] ) != 0 )
+        return true;
+
+    for ( unsigned i = 0; i < resident.size(); i++ )
+        if ( !( resident[i] & 1 ) )
+            return false;
+
+    return true;
+#endif
+}
@@ -0,0 +1,118 @@
+/******************************************************************************
+*	File: pack.h
+*
+*	Authors: Savoy Schuler and Daniel Hodgin
+*
+*	Date: 11-17-16
+*
+*	Description:
+*
+*       Layout of the texture pack written by the packer (packer.cpp) and read
+*       by the program (pack.cpp). The pack starts with a PackHeader followed
+*       by one PackEntry per texture map. Each map's levels follow, starting
+*       on a page boundary, largest first and down to 1 x 1: RGB rows padded
+*       to 4 bytes, the layout glTexImage2D reads by default. Offsets are from
+*       the start of the file. Numbers are stored in the machine's own byte
+*       order, since the pack is built where it is used.
+*
+*       Texture maps wider than PackTiledCols are too big to upload whole and
+*       are stored tiled instead, for virtual texturing (see vtexture.cpp).
+*       Each level is cut into PackTileSize x PackTileSize tiles holding
+*       PackTilePayload texels of the level plus a one texel border copied
+*       from the neighbouring texels, wrapping around in longitude and
+*       clamped at the poles. A level's tiles follow each other in rows, and
+*       the levels end with the first one that fits in a single tile.
+*
+*       The backdrop's cube map (see skybox.cpp) is stored under the name of
+*       its .cube file, as a single level holding the six faces, +x, -x, +y,
+*       -y, +z, -z, each Cols x Cols RGB texels with no row padding, as in
+*       the .cube file.
+*
+*	Modified: Original
+*
+******************************************************************************/
+
+#ifndef _PACK_H_
+#define _PACK_H_
+
+/***************************** File Includes *********************************/
+
+#include <stdint.h>
+
+/******************************* Constants **********************************/
+
+//First bytes of every pack.
+const char PackMagic[4] = { 'S', 'S', 'P', 'K' };
+
+//Bumped whenever the layout changes.
+const uint32_t PackVersion = 3;
+
+//Most levels of one texture map (the same as MaxTextureLevels).
+const int PackMaxLevels = 16;
+
+//Longest texture map file name stored, including its terminating zero.
+const int PackNameLength = 64;
+
+//Each texture map's levels start on a multiple of this many bytes.
+const int PackAlignment = 4096;
+
+//Texture maps wider than this are stored tiled.
+const uint32_t PackTiledCols = 2048;
+
+//Size of a tile, and the texels of its level it holds inside its border.
+const int PackTileSize = 256;
+const int PackTilePayload = PackTileSize - 2;
+
+//Bytes in one tile (its rows need no padding).
+const uint64_t PackTileBytes = 3 * PackTileSize * PackTileSize;
+
+/******************************** Type Def ***********************************/
+
+//Start of the pack.
+struct PackHeader
+{
+    char Magic[4];                  //PackMagic
+    uint32_t Version;               //PackVersion
+    uint32_t Count;                 //number of entries following
+    uint32_t Reserved;              //zero
+};
+
+//One texture map in the pack.
+struct PackEntry
+{
+    char Name[PackNameLength];      //file the texture map was read from
+    uint32_t Cols;                  //columns in the largest level
+    uint32_t Rows;                  //rows in the largest level
+    uint32_t Levels;                //number of levels
+    uint32_t Tiled;                 //1 if stored in tiles, else 0
+    uint32_t Cube;                  //1 if a cube map's faces, else 0
+    uint32_t Reserved;              //zero
+    uint64_t Offset[PackMaxLevels]; //start of each level
+};
+
+//Rows of each level are padded to 4 bytes.
+inline uint64_t PackRowBytes( uint32_t cols )
+{
+    return ( 3 * ( uint64_t ) cols + 3 ) & ~( uint64_t ) 3;
+}
+
+//Tiles across a tiled level of this many columns (or down, for rows).
+inline uint32_t PackTiles( uint32_t texels )
+{
+    return ( texels + PackTilePayload - 1 ) / PackTilePayload;
+}
+
+//Bytes taken by one level of an entry.
+inline uint64_t PackLevelBytes( const PackEntry &entry, uint32_t cols,
+                                uint32_t rows )
+{
+    if ( entry.Cube )
+        return 6 * 3 * ( uint64_t ) cols * rows;
+
+    if ( entry.Tiled )
+        return PackTiles( cols ) * ( uint64_t ) PackTiles( rows ) * PackTileBytes;
+
+    return PackRowBytes( cols ) * rows;
+}
+
+#endif
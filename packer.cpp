@@ -0,0 +1,343 @@
+/******************************************************************************
+*	File: packer.cpp
+*
+*	Authors: Savoy Schuler and Daniel Hodgin
+*
+*	Date: 11-17-16
+*
+*	Description:
+*
+*		This file contains the texture packer, a separate program run by the
+*       Makefile ("make textures.pak"). It reads .bmp texture maps, does the
+*       work the program would otherwise redo at every launch, and writes the
+*       results to one texture pack (see pack.h): each map's full chain of
+*       mipmap levels is built by BuildMipmaps (see mipmaps.cpp), so the
+*       program can upload the levels straight from the file without decoding
+*       anything. Texture maps wider than PackTiledCols are cut into tiles for
+*       virtual texturing instead. A backdrop's texture map, marked -cube,
+*       is turned into the six faces of its cube map (see cubemap.cpp).
+*
+*       Usage: packer pack [-cube] file.bmp ...
+*
+*	File Order and Structure:
+*
+*       - Main.
+*       - Write the pack.
+*       - Cut tiles.
+*
+*	Modified:
+*
+*		Original
+*
+*	Functions Included:
+*
+*           //Main.
+*
+*       int main( int argc, char** argv );
+*
+*           //Write the pack.
+*
+*       static bool WritePack( const char* filename,
+*                              vector<PackEntry> &entries,
+*                              const vector<TextureLevels> &levels );
+*
+*           //Cut tiles.
+*
+*       static void CutTile( const byte* level, int cols, int rows, int tx,
+*                            int ty, byte* tile );
+*
+******************************************************************************/
+
+/**************************** Library Includes *******************************/
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include <climits>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "Planet.h"
+#include "globals.h"
+#include "pack.h"
+
+/******************************* Name Space **********************************/
+
+using namespace std;
+
+/*************************** Function Prototypes *****************************/
+
+static bool WritePack( const char* filename, vector<PackEntry> &entries,
+                       const vector<TextureLevels> &levels );
+static void CutTile( const byte* level, int cols, int rows, int tx, int ty,
+                     byte* tile );
+
+
+
+/******************************************************************************
+* Author: Savoy Schuler and Daniel Hodgin
+*
+* Function: main
+*
+* Description:
+*
+*   Main function of the packer. Reads every texture map named on the
+*   command line, builds its levels, or its cube map's faces if the name
+*   follows -cube, and writes them all to the pack. Returns 1, writing
+*   nothing, if any texture map can not be read.
+*
+* Parameters:
+*
+*	argc	- number of command line parameters
+*
+*	argv	- the pack to write, then the .bmp files to put in it, each
+*             backdrop's after -cube
+*
+******************************************************************************/
+int main( int argc, char** argv )
+{
+    if ( argc < 3 )
+    {
+        fprintf( stderr, "Usage: %s pack [-cube] file.bmp ...\n", argv[0] );
+        return 1;
+    }
+
+    vector<PackEntry> entries;
+    vector<TextureLevels> levels;
+
+    for ( int i = 2; i < argc; i++ )
+    {
+        int rows, cols;
+        byte* image;
+
+        bool cube = strcmp( argv[i], "-cube" ) == 0 && i + 1 < argc;
+        if ( cube )
+            i++;
+
+        //Cube maps are stored under the name of their .cube file.
+        string name = cube ? CubeCacheName( argv[i] ) : string( argv[i] );
+
+        if ( name.size() >= ( size_t ) PackNameLength )
+        {
+            fprintf( stderr, "%s: file name too long: %s\n", argv[0],
+                     name.c_str() );
+            return 1;
+        }
+
+        if ( !LoadBmpFile( argv[i], rows, cols, image ) )
+            return 1;
+
+        if ( cube )
+        {
+            /*The faces are as large as the image needs. The program makes
+            them again from the image if OpenGL can not take that size.*/
+            TextureLevels faces;
+            faces.Cols = faces.Rows = CubeFaceSize( cols, INT_MAX );
+            faces.Levels = 1;
+            faces.Level[0] = BuildCubeMap( image, cols, rows, faces.Cols );
+            delete [] image;
+
+            PackEntry entry;
+            memset( &entry, 0, sizeof( entry ) );
+            strcpy( entry.Name, name.c_str() );
+            entry.Cols = entry.Rows = faces.Cols;
+            entry.Levels = 1;
+            entry.Cube = 1;
+
+            entries.push_back( entry );
+            levels.push_back( faces );
+            continue;
+        }
+
+        //Build every level. The image and mipmaps are kept until written.
+        TextureLevels chain;
+        BuildMipmaps( image, cols, rows, chain );
+
+        PackEntry entry;
+        memset( &entry, 0, sizeof( entry ) );
+        strcpy( entry.Name, name.c_str() );
+        entry.Cols = chain.Cols;
+        entry.Rows = chain.Rows;
+        entry.Levels = chain.Levels;
+        entry.Tiled = chain.Cols > ( int ) PackTiledCols;
+
+        //Tiled levels end with the first that fits in one tile.
+        if ( entry.Tiled )
+        {
+            uint32_t cols = entry.Cols, rows = entry.Rows;
+
+            entry.Levels = 1;
+            while ( PackTiles( cols ) * PackTiles( rows ) > 1 )
+            {
+                cols = cols > 1 ? cols / 2 : 1;
+                rows = rows > 1 ? rows / 2 : 1;
+                entry.Levels++;
+            }
+        }
+
+        entries.push_back( entry );
+        levels.push_back( chain );
+    }
+
+    return WritePack( argv[1], entries, levels ) ? 0 : 1;
+}
+
+
+
+/******************************************************************************
+* Author: Savoy Schuler and Daniel Hodgin
+*
+* Function: WritePack
+*
+* Description:
+*
+*   This function writes the pack: the header, every entry, then each
+*   texture map's levels starting on a page boundary, tiled levels a tile at
+*   a time. The pack is written to
+*   a temporary file and renamed into place, so a running program never sees
+*   half of one. Returns false, after printing why, on failure.
+*
+* Parameters:
+*
+*   filename    - pack to write
+*
+*   entries     - entry of each texture map, offsets filled in here
+*
+*   levels      - levels of each texture map, largest first
+*
+******************************************************************************/
+static bool WritePack( const char* filename, vector<PackEntry> &entries,
+                       const vector<TextureLevels> &levels )
+{
+    //Lay out the levels after the header and entries.
+    uint64_t offset = sizeof( PackHeader ) + entries.size() * sizeof( PackEntry );
+
+    for ( unsigned i = 0; i < entries.size(); i++ )
+    {
+        offset = ( offset + PackAlignment - 1 ) / PackAlignment * PackAlignment;
+
+        uint32_t cols = entries[i].Cols, rows = entries[i].Rows;
+
+        for ( unsigned level = 0; level < entries[i].Levels; level++ )
+        {
+            entries[i].Offset[level] = offset;
+            offset += PackLevelBytes( entries[i], cols, rows );
+
+            cols = cols > 1 ? cols / 2 : 1;
+            rows = rows > 1 ? rows / 2 : 1;
+        }
+    }
+
+    PackHeader header;
+    memset( &header, 0, sizeof( header ) );
+    memcpy( header.Magic, PackMagic, sizeof( header.Magic ) );
+    header.Version = PackVersion;
+    header.Count = entries.size();
+
+    string temporary = string( filename ) + ".tmp";
+    FILE* outfile = fopen( temporary.c_str(), "wb" );
+    if ( !outfile )
+    {
+        fprintf( stderr, "WritePack(): unable to open file: %s\n",
+                 temporary.c_str() );
+        return false;
+    }
+
+    bool ok = fwrite( &header, sizeof( header ), 1, outfile ) == 1;
+    if ( !entries.empty() )
+        ok = ok && fwrite( &entries[0], sizeof( PackEntry ), entries.size(),
+                           outfile ) == entries.size();
+
+    vector<byte> tile( PackTileBytes );
+
+    //Pad each texture map out to its offset.
+    for ( unsigned i = 0; ok && i < entries.size(); i++ )
+    {
+        long pad = entries[i].Offset[0] - ftell( outfile );
+        vector<byte> zeros( pad );
+
+        if ( pad > 0 )
+            ok = fwrite( &zeros[0], 1, pad, outfile ) == ( size_t ) pad;
+
+        uint32_t cols = entries[i].Cols, rows = entries[i].Rows;
+
+        for ( unsigned level = 0; ok && level < entries[i].Levels; level++ )
+        {
+            const byte* image = levels[i].Level[level];
+
+            if ( entries[i].Tiled )
+            {
+                for ( uint32_t ty = 0; ok && ty < PackTiles( rows ); ty++ )
+                    for ( uint32_t tx = 0; ok && tx < PackTiles( cols ); tx++ )
+                    {
+                        CutTile( image, cols, rows, tx, ty, &tile[0] );
+                        ok = fwrite( &tile[0], 1, PackTileBytes, outfile ) ==
+                             PackTileBytes;
+                    }
+            }
+            else
+            {
+                size_t bytes = PackLevelBytes( entries[i], cols, rows );
+                ok = fwrite( image, 1, bytes, outfile ) == bytes;
+            }
+
+            cols = cols > 1 ? cols / 2 : 1;
+            rows = rows > 1 ? rows / 2 : 1;
+        }
+    }
+
+    if ( fclose( outfile ) != 0 || !ok || rename( temporary.c_str(), filename ) != 0 )
+    {
+        fprintf( stderr, "WritePack(): unable to write file: %s\n", filename );
+        remove( temporary.c_str() );
+        return false;
+    }
+
+    return true;
+}
+
+
+
+/******************************************************************************
+* Author: Savoy Schuler and Daniel Hodgin
+*
+* Function: CutTile
+*
+* Description:
+*
+*   This function copies one tile out of a level. Texels past the left and
+*   right edges of the level wrap around, as the texture map does around a
+*   sphere, and texels past the top and bottom repeat the edge row.
+*
+* Parameters:
+*
+*   level   - the level, RGB rows padded to 4 bytes
+*
+*   cols    - columns in the level
+*
+*   rows    - rows in the level
+*
+*   tx, ty  - column and row of the tile among the level's tiles
+*
+*   tile    - returned PackTileSize x PackTileSize RGB tile
+*
+******************************************************************************/
+static void CutTile( const byte* level, int cols, int rows, int tx, int ty,
+                     byte* tile )
+{
+    long rowBytes = PackRowBytes( cols );
+
+    for ( int j = 0; j < PackTileSize; j++ )
+    {
+        //First texel of the border is one before the tile's first.
+        int y = min( max( ty * PackTilePayload + j - 1, 0 ), rows - 1 );
+        const byte* row = level + y * rowBytes;
+
+        for ( int i = 0; i < PackTileSize; i++ )
+        {
+            int x = ( ( tx * PackTilePayload + i - 1 ) % cols + cols ) % cols;
+
+            memcpy( tile + 3 * ( j * PackTileSize + i ), row + 3 * x, 3 );
+        }
+    }
+}
@@ -0,0 +1,191 @@
+/******************************************************************************
+*	File: scheduler.cpp
+*
+*	Authors: Savoy Schuler and Daniel Hodgin
+*
+*	Date: 11-17-16
+*
+*	Description:
+*
+*		This file contains the frame scheduler. The simulation runs on its own
+*       thread in fixed steps (see simulation.cpp). At the start of each frame
+*       the newest snapshot it has published is taken, and FrameBlend is set
+*       from how long ago its last step was due, so bodies are drawn part of
+*       the way from the previous step to the last one.
+*
+*       While the animation runs, the next frame is asked for as soon as one
+*       is finished, or after a delay when a frame rate cap is set. While the
+*       animation is paused or single stepping no frame is asked for, so the
+*       program sits idle until input arrives. Input sent to the simulation is
+*       only seen once the simulation thread publishes its result, so until
+*       then a short timer keeps checking for it. Likewise, while texture maps
+*       are still being decoded a timer checks for finished ones, so they
+*       appear without waiting for input.
+*
+*	File Order and Structure:
+*
+*       - Take simulation snapshots.
+*       - Schedule frames.
+*
+*	Modified:
+*
+*		Original
+*
+*	Functions Included:
+*
+*           //Take simulation snapshots.
+*
+*       void TakeSnapshot();
+*
+*           //Schedule frames.
+*
+*       void ScheduleNextFrame();
+*       static void FrameTimer( int value );
+*
+******************************************************************************/
+
+/**************************** Library Includes *******************************/
+#include <cstdlib>
+#include <GL/freeglut.h>
+#include <iostream>
+#include <string>
+#include "Planet.h"
+#include "globals.h"
+
+/******************************* Constants **********************************/
+
+//Milliseconds between checks for input the simulation has not shown yet.
+static const int PendingPollTime = 1;
+
+//Milliseconds between checks for texture maps still being decoded.
+static const int AssetPollTime = 10;
+
+/********************************* Globals ***********************************/
+
+//Fraction of the way from the previous simulation step to the current one.
+float FrameBlend = 1.0;
+
+//Most frames drawn per second while animating, 0 for no cap.
+int FrameRateCap = 0;
+
+//Time, in milliseconds, of the last frame.
+static int LastFrameTime = 0;
+
+/*************************** Function Prototypes *****************************/
+
+static void FrameTimer( int value );
+
+
+
+/******************************************************************************
+* Author: Savoy Schuler and Daniel Hodgin
+*
+* Function: TakeSnapshot
+*
+* Description:
+*
+*   This function is called at the start of each frame. The newest snapshot
+*   published by the simulation thread, if any, is copied into the planets.
+*   While the animation runs FrameBlend follows the time since the snapshot's
+*   last step was due, otherwise bodies are drawn at the last step.
+*
+* Parameters:
+*
+*		void	- No input parameters needed.
+*
+******************************************************************************/
+void TakeSnapshot()
+{
+    LastFrameTime = glutGet( GLUT_ELAPSED_TIME );
+
+    ConsumeSnapshot();
+
+    //Paused or single stepping: show the last step.
+    if ( !SimulationRunning() )
+    {
+        FrameBlend = 1.0;
+        return;
+    }
+
+    //Running: blend toward the last step until the next one arrives.
+    double age = SnapshotAge();
+    FrameBlend = age < 0.0 ? 0.0 : ( age > 1.0 ? 1.0 : age );
+}
+
+
+
+/******************************************************************************
+* Author: Savoy Schuler and Daniel Hodgin
+*
+* Function: ScheduleNextFrame
+*
+* Description:
+*
+*   This function is called at the end of each frame. If the animation is
+*   running, the next frame is asked for right away, or by a timer when a
+*   frame rate cap is set. If input has been sent that the simulation has not
+*   answered yet, or texture maps are still being decoded, a short timer
+*   checks again. Otherwise nothing is asked for and the program waits for
+*   input, which asks for a redraw itself.
+*
+* Parameters:
+*
+*		void	- No input parameters needed.
+*
+******************************************************************************/
+void ScheduleNextFrame()
+{
+    //Paused: check again soon for input the simulation has not shown yet.
+    if ( !SimulationRunning() )
+    {
+        if ( SimulationPending() )
+            glutTimerFunc( PendingPollTime, FrameTimer, 0 );
+        else if ( AssetsPending() )
+            glutTimerFunc( AssetPollTime, FrameTimer, 0 );
+        return;
+    }
+
+    //No cap, draw again as soon as possible.
+    if ( FrameRateCap <= 0 )
+    {
+        glutPostRedisplay();
+        return;
+    }
+
+    //Wait out the rest of this frame's time slot.
+    int elapsed = glutGet( GLUT_ELAPSED_TIME ) - LastFrameTime;
+    int delay = 1000 / FrameRateCap - elapsed;
+
+    glutTimerFunc( delay > 0 ? delay : 0, FrameTimer, 0 );
+}
+
+
+
+/******************************************************************************
+* Author: Savoy Schuler and Daniel Hodgin
+*
+* Function: FrameTimer
+*
+* Description:
+*
+*   Timer callback used when the frame rate is capped, input is waiting on
+*   the simulation or texture maps are being decoded. Asks for the next frame
+*   if the animation is still running, a newer snapshot has been published or
+*   a texture map is ready to upload. Otherwise keeps waiting for texture
+*   maps that are still being decoded, asking again for tiles' pages.
+*
+* Parameters:
+*
+*		value	- unused timer value
+*
+******************************************************************************/
+static void FrameTimer( int value )
+{
+    if ( SimulationRunning() || SimulationPending() || AssetsReady() )
+        glutPostRedisplay();
+    else if ( AssetsPending() )
+    {
+        PrefetchAssets();
+        glutTimerFunc( AssetPollTime, FrameTimer, 0 );
+    }
+}
@@ -0,0 +1,1015 @@
+/******************************************************************************
+*	File: shaders.cpp
+*
+*	Authors: Savoy Schuler and Daniel Hodgin
+*
+*	Date: 11-17-16
+*
+*	Description:
+*
+*		This file contains the shader renderer, picked at startup with the
+*       -shaders option in place of fixed function OpenGL for the sun,
+*       planets, moon and rings. The fixed function path sets a dozen
+*       materials, a texture matrix and a modelview matrix for every body it
+*       draws. Here a GLSL program does the same lighting per vertex from one
+*       uniform buffer, filled and uploaded once at the start of each frame:
+*       the projection and the light first, then each body's model view
+*       matrix (see transforms.cpp), material properties and texture window.
+*       Drawing a body then only binds its part of the buffer, sets its
+*       radius and issues the draw.
+*
+*       The lighting is OpenGL's own: one point light at the sun, OpenGL's
+*       default ambient light, and the Blinn specular highlight of a distant
+*       viewer, clamped and then multiplied by the texture map. Flat shading
+*       uses a second program whose color is not interpolated. The shaders
+*       are GLSL 1.30 with uniform buffers, which Mesa's software
+*       rasterizers run. If they are not available the program says so and
+*       keeps to fixed function.
+*
+*       Belt members are drawn by instanced versions of the two programs,
+*       which place and size each copy of the sphere from per-instance vertex
+*       attributes (see belts.cpp) and light it with its belt's material, so
+*       every member sharing a level of detail is one draw. These need
+*       instanced arrays (OpenGL 3.3); without them belts are drawn as points.
+*       The programs are built whether or not -shaders was given, and belts
+*       drawn with them whenever OpenGL can run them, as the only other way
+*       is an unlit point per member.
+*
+*       Bodies and members too small on screen to need a mesh (see
+*       ImpostorSized) are drawn as impostors instead: a single point sprite
+*       each, sized to cover the sphere. For each pixel the impostor program
+*       finds where a ray from the viewer meets the sphere, then lights and
+*       texture maps that point as the sphere would be, discarding pixels
+*       outside it. A body's impostor is one point, and every member's in a
+*       belt one draw, in place of a sphere of Resolution slices and stacks.
+*
+*       Everything else (the skybox, orbital paths, labels, and bodies drawn
+*       from the virtual texture cache) is still drawn with fixed function,
+*       so the program in use is switched off before them.
+*
+*	File Order and Structure:
+*
+*       - Start the shader renderer.
+*       - Frame data.
+*       - Draw bodies.
+*
+*	Modified:
+*
+*		Original
+*
+*	Functions Included:
+*
+*           //Start the shader renderer.
+*
+*       bool StartShaders();
+*       static bool BuildProgram( ShaderProgram &program,
+*                                 const char *vertexSource,
+*                                 const char *fragmentSource,
+*                                 const char *defines );
+*       static GLuint CompileShader( GLenum type, const char *kind,
+*                                    const char *source,
+*                                    const char *defines );
+*
+*           //Frame data.
+*
+*       void UploadFrameData();
+*
+*           //Draw bodies.
+*
+*       bool DrawShadedSphere( int body, float radius, int resolution );
+*       bool DrawShadedRings( int rings, float inner, float outer,
+*                             int slices );
+*       bool DrawShadedMembers( int belt, GLuint instances, int first,
+*                               int count, int resolution );
+*       bool DrawShadedImpostor( int body, float radius );
+*       bool DrawShadedImpostors( int belt, GLuint instances, int first,
+*                                 int count );
+*       bool MembersShaded( int belt );
+*       void StopShading();
+*       static const ShaderProgram *ShadeBody( int body,
+*                                              const ShaderProgram &smooth,
+*                                              const ShaderProgram &flat );
+*       static void UseProgram( GLuint program );
+*
+******************************************************************************/
+
+/**************************** Library Includes *******************************/
+#define GL_GLEXT_PROTOTYPES
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <GL/freeglut.h>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "Planet.h"
+#include "globals.h"
+
+/******************************* Name Space **********************************/
+
+using namespace std;
+
+/******************************** Type Def ***********************************/
+
+//Frame uniform block, laid out as std140.
+struct FrameData
+{
+    GLfloat Projection[16];     //projection matrix
+    GLfloat LightPosition[4];   //light at the sun, in eye coordinates
+    GLfloat LightAmbient[4];    //light colors
+    GLfloat LightDiffuse[4];
+    GLfloat LightSpecular[4];
+    GLfloat SceneAmbient[4];    //ambient light everywhere
+    GLfloat Options[4];         //x: 1 if lighting is on
+};
+
+//Body uniform block, laid out as std140.
+struct BodyData
+{
+    GLfloat ModelView[16];      //model view matrix
+    GLfloat Ambient[4];         //material properties
+    GLfloat Diffuse[4];
+    GLfloat Specular[4];
+    GLfloat Emission[4];
+    GLfloat Color[4];           //color when lighting is off
+    GLfloat Window[4];          //texture window scale (xy) and offset (zw)
+    GLfloat Params[4];          //x: shininess, y: 1 if textured
+};
+
+//A linked program and where its plain uniform is.
+struct ShaderProgram
+{
+    GLuint Program;     //program object
+    GLint Scale;        //location of the mesh scale
+};
+
+/******************************* Constants **********************************/
+
+//Uniform buffer binding points of the two blocks.
+static const GLuint FrameBinding = 0;
+static const GLuint BodyBinding = 1;
+
+//Vertex attributes of the instanced and impostor programs, clear of those
+//OpenGL may share with gl_Vertex, gl_Normal and gl_MultiTexCoord0.
+static const GLuint InstanceAttribute = 6;
+static const GLuint TintAttribute = 7;
+
+//Ambient light OpenGL's default light model adds everywhere.
+static const GLfloat SceneAmbient[4] = { 0.2, 0.2, 0.2, 1.0 };
+
+//Start of every shader, after the #version line and defines: the uniform
+//blocks, and the lighting of a point on a body.
+static const char * const ShaderHeader =
+    "#extension GL_ARB_uniform_buffer_object : require\n"
+    "layout(std140) uniform Frame\n"
+    "{\n"
+    "    mat4 Projection;\n"
+    "    vec4 LightPosition;\n"
+    "    vec4 LightAmbient;\n"
+    "    vec4 LightDiffuse;\n"
+    "    vec4 LightSpecular;\n"
+    "    vec4 SceneAmbient;\n"
+    "    vec4 Options;\n"
+    "};\n"
+    "layout(std140) uniform Body\n"
+    "{\n"
+    "    mat4 ModelView;\n"
+    "    vec4 Ambient;\n"
+    "    vec4 Diffuse;\n"
+    "    vec4 Specular;\n"
+    "    vec4 Emission;\n"
+    "    vec4 Color;\n"
+    "    vec4 Window;\n"
+    "    vec4 Params;\n"
+    "};\n"
+    "vec4 Lit( vec3 normal, vec3 position, vec4 tint )\n"
+    "{\n"
+    "    if ( Options.x == 0.0 )\n"
+    "        return Color * tint;\n"
+    "    vec3 light = normalize( LightPosition.xyz - position );\n"
+    "    float diffuse = max( dot( normal, light ), 0.0 );\n"
+    "    vec3 color = Emission.rgb +\n"
+    "                 tint.rgb * Ambient.rgb * SceneAmbient.rgb +\n"
+    "                 tint.rgb * Ambient.rgb * LightAmbient.rgb +\n"
+    "                 diffuse * tint.rgb * Diffuse.rgb * LightDiffuse.rgb;\n"
+    "    if ( diffuse > 0.0 )\n"
+    "    {\n"
+    "        vec3 halfway = normalize( light + vec3( 0.0, 0.0, 1.0 ) );\n"
+    "        color += pow( max( dot( normal, halfway ), 0.0 ), Params.x ) *\n"
+    "                 Specular.rgb * LightSpecular.rgb;\n"
+    "    }\n"
+    "    return vec4( clamp( color, 0.0, 1.0 ), Diffuse.a );\n"
+    "}\n";
+
+//Lights each vertex as fixed function OpenGL does. Instanced, each copy
+//is placed and sized by Instance and its material scaled by Tint.
+static const char * const VertexSource =
+    "#ifdef INSTANCED\n"
+    "in vec4 Instance;\n"
+    "in vec4 Tint;\n"
+    "#define PLACE( v ) ( ( v ) * Instance.w + Instance.xyz )\n"
+    "#else\n"
+    "uniform float Scale;\n"
+    "const vec4 Tint = vec4( 1.0 );\n"
+    "#define PLACE( v ) ( ( v ) * Scale )\n"
+    "#endif\n"
+    "SHADE out vec4 LitColor;\n"
+    "out vec2 TexCoord;\n"
+    "void main()\n"
+    "{\n"
+    "    vec4 eye = ModelView * vec4( PLACE( gl_Vertex.xyz ), 1.0 );\n"
+    "    gl_Position = Projection * eye;\n"
+    "    TexCoord = Window.zw + Window.xy * gl_MultiTexCoord0.st;\n"
+    "    vec3 normal = normalize( mat3( ModelView ) * gl_Normal );\n"
+    "    LitColor = Lit( normal, eye.xyz, Tint );\n"
+    "}\n";
+
+//Multiplies the lit color by the texture map, as GL_MODULATE.
+static const char * const FragmentSource =
+    "uniform sampler2D Texture;\n"
+    "SHADE in vec4 LitColor;\n"
+    "in vec2 TexCoord;\n"
+    "void main()\n"
+    "{\n"
+    "    gl_FragColor = LitColor;\n"
+    "    if ( Params.y != 0.0 )\n"
+    "        gl_FragColor.rgb *= texture( Texture, TexCoord ).rgb;\n"
+    "}\n";
+
+//Sizes a point sprite to cover a sphere of radius Instance.w centered at
+//gl_Vertex. Options.y is the height of the window in pixels.
+static const char * const ImpostorVertexSource =
+    "in vec4 Instance;\n"
+    "in vec4 Tint;\n"
+    "out vec3 Center;\n"
+    "out float Radius;\n"
+    "out vec4 SphereTint;\n"
+    "void main()\n"
+    "{\n"
+    "    vec4 eye = ModelView * vec4( gl_Vertex.xyz, 1.0 );\n"
+    "    gl_Position = Projection * eye;\n"
+    "    gl_PointSize = Instance.w * Projection[1][1] * Options.y /\n"
+    "                   gl_Position.w;\n"
+    "    Center = eye.xyz;\n"
+    "    Radius = Instance.w;\n"
+    "    SphereTint = Tint;\n"
+    "}\n";
+
+//Lights and texture maps the point of the sphere seen through each pixel
+//of the sprite, with the texture coordinates the sphere mesh has there, at
+//that point's depth.
+static const char * const ImpostorFragmentSource =
+    "uniform sampler2D Texture;\n"
+    "in vec3 Center;\n"
+    "in float Radius;\n"
+    "in vec4 SphereTint;\n"
+    "void main()\n"
+    "{\n"
+    "    vec2 p = vec2( 2.0 * gl_PointCoord.x - 1.0,\n"
+    "                   1.0 - 2.0 * gl_PointCoord.y );\n"
+    "    float squared = dot( p, p );\n"
+    "    if ( squared > 1.0 )\n"
+    "        discard;\n"
+    "    vec3 normal = vec3( p, sqrt( 1.0 - squared ) );\n"
+    "    vec3 position = Center + Radius * normal;\n"
+    "    vec4 clip = Projection * vec4( position, 1.0 );\n"
+    "    gl_FragDepth = ( gl_DepthRange.diff * clip.z / clip.w +\n"
+    "                     gl_DepthRange.near + gl_DepthRange.far ) * 0.5;\n"
+    "    gl_FragColor = Lit( normal, position, SphereTint );\n"
+    "    if ( Params.y != 0.0 )\n"
+    "    {\n"
+    "        vec3 body = normal * mat3( ModelView );\n"
+    "        vec2 st = vec2( 1.0 - fract( atan( body.x, body.y ) / 6.2831853 ),\n"
+    "                        acos( clamp( -body.z, -1.0, 1.0 ) ) / 3.1415927 );\n"
+    "        gl_FragColor.rgb *= texture( Texture,\n"
+    "                                     Window.zw + Window.xy * st ).rgb;\n"
+    "    }\n"
+    "}\n";
+
+/********************************* Globals ***********************************/
+
+//Draw bodies with the shader renderer, set by the -shaders option and
+//cleared if it cannot be started.
+bool UseShaders = false;
+
+//Programs for smooth and flat shading, and their instanced versions,
+//which are left 0 if OpenGL has no instanced arrays.
+static ShaderProgram SmoothProgram;
+static ShaderProgram FlatProgram;
+static ShaderProgram InstancedSmoothProgram;
+static ShaderProgram InstancedFlatProgram;
+
+//Program for impostors.
+static ShaderProgram ImpostorProgram;
+
+//Program in use, 0 for fixed function.
+static GLuint CurrentProgram = 0;
+
+//Set once the programs and uniform buffer are built, with or without
+//-shaders, as belts are drawn with them either way.
+static bool ShadersStarted = false;
+
+//The uniform buffer, and the frame data copied to it each frame.
+static GLuint FrameBuffer = 0;
+static vector<char> FrameBytes;
+
+//Bytes from the start of the buffer to the first body's block, and from
+//each body's block to the next, as OpenGL requires them to be aligned.
+static GLintptr BodyStart = 0;
+static GLintptr BodyStride = 0;
+
+/*************************** Function Prototypes *****************************/
+
+static bool BuildProgram( ShaderProgram &program, const char *vertexSource,
+                          const char *fragmentSource, const char *defines );
+static GLuint CompileShader( GLenum type, const char *kind,
+                             const char *source, const char *defines );
+static const ShaderProgram *ShadeBody( int body, const ShaderProgram &smooth,
+                                       const ShaderProgram &flat );
+static void UseProgram( GLuint program );
+
+
+
+/******************************************************************************
+* Author: Savoy Schuler and Daniel Hodgin
+*
+* Function: StartShaders
+*
+* Description:
+*
+*   This function builds the shader programs and the uniform buffer. It
+*   needs a current OpenGL context, so it is called from OpenGLInit, with or
+*   without -shaders. Returns false, after saying why, if OpenGL cannot run
+*   them, in which case drawing stays fixed function.
+*
+* Parameters:
+*
+*		void	- No input parameters needed.
+*
+******************************************************************************/
+bool StartShaders()
+{
+    //Uniform buffers are part of OpenGL 3.1, or an extension before that.
+    int major = 0, minor = 0;
+    const char *version = ( const char * ) glGetString( GL_VERSION );
+    const char *extensions = ( const char * ) glGetString( GL_EXTENSIONS );
+
+    if ( version != NULL )
+        sscanf( version, "%d.%d", &major, &minor );
+
+    bool uniformBuffers = major > 3 || ( major == 3 && minor >= 1 ) ||
+                          ( extensions != NULL &&
+                            strstr( extensions, "GL_ARB_uniform_buffer_object" ) );
+
+    if ( major < 3 || !uniformBuffers )
+    {
+        cerr << "StartShaders(): OpenGL " << ( version ? version : "?" )
+             << " has no GLSL 1.30 uniform buffers, using fixed function"
+             << endl;
+        return false;
+    }
+
+    if ( !BuildProgram( SmoothProgram, VertexSource, FragmentSource,
+                        "#define SHADE smooth\n" ) ||
+            !BuildProgram( FlatProgram, VertexSource, FragmentSource,
+                           "#define SHADE flat\n" ) ||
+            !BuildProgram( ImpostorProgram, ImpostorVertexSource,
+                           ImpostorFragmentSource, "" ) )
+    {
+        cerr << "StartShaders(): using fixed function" << endl;
+        return false;
+    }
+
+    //Instanced arrays are part of OpenGL 3.3, or an extension before that.
+    bool instancing = major > 3 || ( major == 3 && minor >= 3 ) ||
+                      ( extensions != NULL &&
+                        strstr( extensions, "GL_ARB_instanced_arrays" ) );
+
+    if ( !instancing ||
+            !BuildProgram( InstancedSmoothProgram, VertexSource, FragmentSource,
+                           "#define SHADE smooth\n#define INSTANCED\n" ) ||
+            !BuildProgram( InstancedFlatProgram, VertexSource, FragmentSource,
+                           "#define SHADE flat\n#define INSTANCED\n" ) )
+    {
+        cerr << "StartShaders(): no instanced arrays, belts are drawn as points"
+             << endl;
+        InstancedSmoothProgram.Program = InstancedFlatProgram.Program = 0;
+    }
+
+    //Impostors can be no larger than the largest point.
+    GLfloat pointSizes[2];
+    glGetFloatv( GL_ALIASED_POINT_SIZE_RANGE, pointSizes );
+
+    if ( ImpostorPixels > pointSizes[1] / 2.0 )
+        ImpostorPixels = pointSizes[1] / 2.0;
+
+    //Body blocks are bound one at a time, at aligned offsets.
+    GLint alignment = 1;
+    glGetIntegerv( GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment );
+
+    BodyStart = ( sizeof( FrameData ) + alignment - 1 ) / alignment * alignment;
+    BodyStride = ( sizeof( BodyData ) + alignment - 1 ) / alignment * alignment;
+
+    glGenBuffers( 1, &FrameBuffer );
+    CurrentProgram = 0;
+    ShadersStarted = true;
+
+    return true;
+}
+
+
+
+/******************************************************************************
+* Author: Savoy Schuler and Daniel Hodgin
+*
+* Function: BuildProgram
+*
+* Description:
+*
+*   This function compiles and links one of the programs, and ties its
+*   uniform blocks, texture and per-instance attributes to their binding
+*   points. Returns false, after printing OpenGL's log, if it fails.
+*
+* Parameters:
+*
+*   program         - set to the program built
+*
+*   vertexSource    - the vertex shader's own source
+*
+*   fragmentSource  - the fragment shader's own source
+*
+*   defines         - SHADE, and INSTANCED for the instanced programs
+*
+******************************************************************************/
+static bool BuildProgram( ShaderProgram &program, const char *vertexSource,
+                          const char *fragmentSource, const char *defines )
+{
+    GLuint vertex = CompileShader( GL_VERTEX_SHADER, "vertex", vertexSource,
+                                   defines );
+    GLuint fragment = CompileShader( GL_FRAGMENT_SHADER, "fragment",
+                                     fragmentSource, defines );
+
+    if ( vertex == 0 || fragment == 0 )
+        return false;
+
+    program.Program = glCreateProgram();
+    glAttachShader( program.Program, vertex );
+    glAttachShader( program.Program, fragment );
+
+    //Only the instanced and impostor programs have these.
+    glBindAttribLocation( program.Program, InstanceAttribute, "Instance" );
+    glBindAttribLocation( program.Program, TintAttribute, "Tint" );
+
+    glLinkProgram( program.Program );
+
+    //The program keeps what it needs of the shaders.
+    glDeleteShader( vertex );
+    glDeleteShader( fragment );
+
+    GLint linked;
+    glGetProgramiv( program.Program, GL_LINK_STATUS, &linked );
+
+    if ( !linked )
+    {
+        char log[1024];
+        glGetProgramInfoLog( program.Program, sizeof( log ), NULL, log );
+        cerr << "BuildProgram(): link failed: " << log << endl;
+        return false;
+    }
+
+    glUniformBlockBinding( program.Program,
+                           glGetUniformBlockIndex( program.Program, "Frame" ),
+                           FrameBinding );
+    glUniformBlockBinding( program.Program,
+                           glGetUniformBlockIndex( program.Program, "Body" ),
+                           BodyBinding );
+
+    //Texture maps are on texture unit 0.
+    glUseProgram( program.Program );
+    glUniform1i( glGetUniformLocation( program.Program, "Texture" ), 0 );
+    glUseProgram( 0 );
+
+    program.Scale = glGetUniformLocation( program.Program, "Scale" );
+
+    return true;
+}
+
+
+
+/******************************************************************************
+* Author: Savoy Schuler and Daniel Hodgin
+*
+* Function: CompileShader
+*
+* Description:
+*
+*   This function compiles a shader from the shared header and its own
+*   source, after the defines picking the program's version. Returns the
+*   shader object, or 0 after printing OpenGL's log if it does not compile.
+*
+* Parameters:
+*
+*   type    - GL_VERTEX_SHADER or GL_FRAGMENT_SHADER
+*
+*   kind    - name of the shader for messages
+*
+*   source  - the shader's own source
+*
+*   defines - defines picking the program's version
+*
+******************************************************************************/
+static GLuint CompileShader( GLenum type, const char *kind,
+                             const char *source, const char *defines )
+{
+    const char *sources[] =
+    {
+        "#version 130\n",
+        defines,
+        ShaderHeader,
+        source
+    };
+
+    GLuint shader = glCreateShader( type );
+    glShaderSource( shader, 4, sources, NULL );
+    glCompileShader( shader );
+
+    GLint compiled;
+    glGetShaderiv( shader, GL_COMPILE_STATUS, &compiled );
+
+    if ( !compiled )
+    {
+        char log[1024];
+        glGetShaderInfoLog( shader, sizeof( log ), NULL, log );
+        cerr << "CompileShader(): " << kind << " shader failed: " << log
+             << endl;
+        glDeleteShader( shader );
+        return 0;
+    }
+
+    return shader;
+}
+
+
+
+/******************************************************************************
+* Author: Savoy Schuler and Daniel Hodgin
+*
+* Function: UploadFrameData
+*
+* Description:
+*
+*   This function fills the uniform buffer for the frame and uploads it in
+*   one piece: the projection, light and lighting switch, then each body's
+*   model view matrix, material properties and texture window. It is called
+*   at the start of each frame once the bodies are placed (see
+*   UpdateTransforms), and does nothing unless the programs were built.
+*
+* Parameters:
+*
+*		void	- No input parameters needed.
+*
+******************************************************************************/
+void UploadFrameData()
+{
+    if ( !ShadersStarted )
+        return;
+
+    int count = BodyCount();
+    FrameBytes.assign( BodyStart + count * BodyStride, 0 );
+
+    //Projection and light. The light is at the sun, so in eye coordinates
+    //it is where the view moves the origin.
+    FrameData *frame = ( FrameData * ) &FrameBytes[0];
+    const GLfloat *view = GetViewMatrix();
+
+    GetProjectionMatrix( frame->Projection );
+
+    for ( int i = 0; i < 4; i++ )
+    {
+        frame->LightPosition[i] = view[12 + i];
+        frame->LightAmbient[i] = LightAmbient[i];
+        frame->LightDiffuse[i] = LightDiffuse[i];
+        frame->LightSpecular[i] = LightSpecular[i];
+        frame->SceneAmbient[i] = SceneAmbient[i];
+    }
+
+    frame->Options[0] = light ? 1.0 : 0.0;
+    frame->Options[1] = ScreenHeight;
+
+    //Each body.
+    for ( int body = 0; body < count; body++ )
+    {
+        BodyData *data = ( BodyData * ) &FrameBytes[BodyStart +
+                                                    body * BodyStride];
+
+        //The backdrop is drawn by the skybox.
+        if ( Bodies.Flags[body] & BodyBackdrop )
+            continue;
+
+        Material material;
+        GetMatProps( body, material );
+
+        memcpy( data->ModelView, TransformMatrix( body ),
+                sizeof( data->ModelView ) );
+        memcpy( data->Ambient, material.Ambient, sizeof( data->Ambient ) );
+        memcpy( data->Diffuse, material.Diffuse, sizeof( data->Diffuse ) );
+        memcpy( data->Specular, material.Specular, sizeof( data->Specular ) );
+        memcpy( data->Emission, material.Emission, sizeof( data->Emission ) );
+        memcpy( data->Color, material.Color, sizeof( data->Color ) );
+
+        const TextureWindow &window = Bodies.Window[body];
+        data->Window[0] = window.Scale[0];
+        data->Window[1] = window.Scale[1];
+        data->Window[2] = window.Offset[0];
+        data->Window[3] = window.Offset[1];
+
+        data->Params[0] = material.Shininess;
+        data->Params[1] = BodyTextured( body ) ? 1.0 : 0.0;
+    }
+
+    glBindBuffer( GL_UNIFORM_BUFFER, FrameBuffer );
+    glBufferData( GL_UNIFORM_BUFFER, FrameBytes.size(), &FrameBytes[0],
+                  GL_STREAM_DRAW );
+    glBindBuffer( GL_UNIFORM_BUFFER, 0 );
+
+    glBindBufferRange( GL_UNIFORM_BUFFER, FrameBinding, FrameBuffer, 0,
+                       sizeof( FrameData ) );
+}
+
+
+
+/******************************************************************************
+* Author: Savoy Schuler and Daniel Hodgin
+*
+* Function: DrawShadedSphere
+*
+* Description:
+*
+*   This function draws a body's sphere with the shader renderer, in the
+*   place, material and texture uploaded for it this frame. Returns false,
+*   with fixed function back in use, if the shader renderer is off or the
+*   body is drawn from the virtual texture cache, for the caller to draw it.
+*
+* Parameters:
+*
+*   body        - row of the body in the table
+*
+*   radius      - radius of the sphere
+*
+*   resolution  - number of slices and stacks in the sphere
+*
+******************************************************************************/
+bool DrawShadedSphere( int body, float radius, int resolution )
+{
+    const ShaderProgram *program = ShadeBody( body, SmoothProgram,
+                                              FlatProgram );
+    if ( program == NULL )
+        return false;
+
+    glUniform1f( program->Scale, radius );
+    DrawUnitSphere( resolution );
+
+    FrameStats.BodiesShaded++;
+    return true;
+}
+
+
+
+/******************************************************************************
+* Author: Savoy Schuler and Daniel Hodgin
+*
+* Function: DrawShadedRings
+*
+* Description:
+*
+*   This function draws rings with the shader renderer, from their cached
+*   annulus. Returns false, with fixed function back in use, if the shader
+*   renderer is off or the rings are drawn from the virtual texture cache.
+*
+* Parameters:
+*
+*   rings   - row of the rings in the table
+*
+*   inner   - inner radius of the rings
+*
+*   outer   - outer radius of the rings
+*
+*   slices  - number of slices around the rings
+*
+******************************************************************************/
+bool DrawShadedRings( int rings, float inner, float outer, int slices )
+{
+    const ShaderProgram *program = ShadeBody( rings, SmoothProgram,
+                                              FlatProgram );
+    if ( program == NULL )
+        return false;
+
+    glUniform1f( program->Scale, 1.0 );
+    DrawRingMesh( rings, inner, outer, slices );
+
+    FrameStats.BodiesShaded++;
+    return true;
+}
+
+
+
+/******************************************************************************
+* Author: Savoy Schuler and Daniel Hodgin
+*
+* Function: DrawShadedMembers
+*
+* Description:
+*
+*   This function draws belt members with one instanced call, each a copy of
+*   the sphere placed, sized and tinted by its BeltInstance and lit with the
+*   belt's material. Returns false, with fixed function back in use, if the
+*   shader renderer is off or OpenGL has no instanced arrays.
+*
+* Parameters:
+*
+*   belt        - row of the belt in the table
+*
+*   instances   - buffer object holding the members' BeltInstance data
+*
+*   first       - first member to draw in the buffer
+*
+*   count       - number of members to draw
+*
+*   resolution  - number of slices and stacks in each member's sphere
+*
+******************************************************************************/
+bool DrawShadedMembers( int belt, GLuint instances, int first, int count,
+                        int resolution )
+{
+    if ( ShadeBody( belt, InstancedSmoothProgram,
+                    InstancedFlatProgram ) == NULL )
+        return false;
+
+    //Step through the members once per copy of the sphere.
+    GLintptr start = first * sizeof( BeltInstance );
+
+    glBindBuffer( GL_ARRAY_BUFFER, instances );
+
+    glEnableVertexAttribArray( InstanceAttribute );
+    glVertexAttribPointer( InstanceAttribute, 4, GL_FLOAT, GL_FALSE,
+                           sizeof( BeltInstance ),
+                           ( GLvoid * ) ( start +
+                                          offsetof( BeltInstance, Position ) ) );
+    glVertexAttribDivisor( InstanceAttribute, 1 );
+
+    glEnableVertexAttribArray( TintAttribute );
+    glVertexAttribPointer( TintAttribute, 4, GL_FLOAT, GL_FALSE,
+                           sizeof( BeltInstance ),
+                           ( GLvoid * ) ( start +
+                                          offsetof( BeltInstance, Tint ) ) );
+    glVertexAttribDivisor( TintAttribute, 1 );
+
+    glBindBuffer( GL_ARRAY_BUFFER, 0 );
+
+    DrawUnitSpheres( resolution, count );
+
+    //Restore the attributes for drawing without instances.
+    glVertexAttribDivisor( InstanceAttribute, 0 );
+    glVertexAttribDivisor( TintAttribute, 0 );
+    glDisableVertexAttribArray( InstanceAttribute );
+    glDisableVertexAttribArray( TintAttribute );
+
+    return true;
+}
+
+
+
+/******************************************************************************
+* Author: Savoy Schuler and Daniel Hodgin
+*
+* Function: DrawShadedImpostor
+*
+* Description:
+*
+*   This function draws a body as an impostor, a point sprite lit and
+*   texture mapped as its sphere would be. Returns false, with fixed
+*   function back in use, if the shader renderer is off or the body is drawn
+*   from the virtual texture cache.
+*
+* Parameters:
+*
+*   body    - row of the body in the table
+*
+*   radius  - radius of the body
+*
+******************************************************************************/
+bool DrawShadedImpostor( int body, float radius )
+{
+    if ( ShadeBody( body, ImpostorProgram, ImpostorProgram ) == NULL )
+        return false;
+
+    SetCapability( GL_PROGRAM_POINT_SIZE, true );
+    SetCapability( GL_POINT_SPRITE, true );
+
+    //One point at the body's center.
+    glVertexAttrib4f( InstanceAttribute, 0.0, 0.0, 0.0, radius );
+    glVertexAttrib4f( TintAttribute, 1.0, 1.0, 1.0, 1.0 );
+
+    glBegin( GL_POINTS );
+    glVertex3f( 0.0, 0.0, 0.0 );
+    glEnd();
+
+    FrameStats.BodiesShaded++;
+    FrameStats.Impostors++;
+    return true;
+}
+
+
+
+/******************************************************************************
+* Author: Savoy Schuler and Daniel Hodgin
+*
+* Function: DrawShadedImpostors
+*
+* Description:
+*
+*   This function draws belt members as impostors with one call, a point
+*   sprite each, placed, sized and tinted by its BeltInstance and lit with
+*   the belt's material. Returns false, with fixed function back in use, if
+*   the shader renderer is off.
+*
+* Parameters:
+*
+*   belt        - row of the belt in the table
+*
+*   instances   - buffer object holding the members' BeltInstance data
+*
+*   first       - first member to draw in the buffer
+*
+*   count       - number of members to draw
+*
+******************************************************************************/
+bool DrawShadedImpostors( int belt, GLuint instances, int first, int count )
+{
+    if ( ShadeBody( belt, ImpostorProgram, ImpostorProgram ) == NULL )
+        return false;
+
+    SetCapability( GL_PROGRAM_POINT_SIZE, true );
+    SetCapability( GL_POINT_SPRITE, true );
+
+    //One point per member, at its center.
+    glBindBuffer( GL_ARRAY_BUFFER, instances );
+
+    glEnableClientState( GL_VERTEX_ARRAY );
+    glVertexPointer( 3, GL_FLOAT, sizeof( BeltInstance ),
+                     ( GLvoid * ) offsetof( BeltInstance, Position ) );
+
+    glEnableVertexAttribArray( InstanceAttribute );
+    glVertexAttribPointer( InstanceAttribute, 4, GL_FLOAT, GL_FALSE,
+                           sizeof( BeltInstance ),
+                           ( GLvoid * ) offsetof( BeltInstance, Position ) );
+
+    glEnableVertexAttribArray( TintAttribute );
+    glVertexAttribPointer( TintAttribute, 4, GL_FLOAT, GL_FALSE,
+                           sizeof( BeltInstance ),
+                           ( GLvoid * ) offsetof( BeltInstance, Tint ) );
+
+    glBindBuffer( GL_ARRAY_BUFFER, 0 );
+
+    glDrawArrays( GL_POINTS, first, count );
+
+    glDisableClientState( GL_VERTEX_ARRAY );
+    glDisableVertexAttribArray( InstanceAttribute );
+    glDisableVertexAttribArray( TintAttribute );
+
+    FrameStats.Impostors += count;
+    return true;
+}
+
+
+
+/******************************************************************************
+* Author: Savoy Schuler and Daniel Hodgin
+*
+* Function: MembersShaded
+*
+* Description:
+*
+*   Returns true if the members of a belt can be drawn with the shader
+*   renderer, as instanced spheres and impostors, so the belt can be drawn
+*   one way or the other before any of it is.
+*
+* Parameters:
+*
+*   belt    - row of the belt in the table
+*
+******************************************************************************/
+bool MembersShaded( int belt )
+{
+    return ShadersStarted && !VirtualTextured( belt ) &&
+           InstancedSmoothProgram.Program != 0 &&
+           InstancedFlatProgram.Program != 0 && ImpostorProgram.Program != 0;
+}
+
+
+
+/******************************************************************************
+* Author: Savoy Schuler and Daniel Hodgin
+*
+* Function: StopShading
+*
+* Description:
+*
+*   This function goes back to fixed function OpenGL, for drawing what the
+*   shader renderer does not, with points as OpenGL draws them.
+*
+* Parameters:
+*
+*		void	- No input parameters needed.
+*
+******************************************************************************/
+void StopShading()
+{
+    UseProgram( 0 );
+
+    SetCapability( GL_PROGRAM_POINT_SIZE, false );
+    SetCapability( GL_POINT_SPRITE, false );
+}
+
+
+
+/******************************************************************************
+* Author: Savoy Schuler and Daniel Hodgin
+*
+* Function: ShadeBody
+*
+* Description:
+*
+*   This function readies the shader renderer to draw a body: the program
+*   for the shade model, the body's block of the uniform buffer and its
+*   texture. Returns the program in use, or NULL, using fixed function, if
+*   the shader renderer is off (for belts, if it was not built), the body
+*   has a virtual texture or the program was not built.
+*
+* Parameters:
+*
+*   body    - row of the body in the table
+*
+*   smooth  - program for smooth shading
+*
+*   flat    - program for flat shading
+*
+******************************************************************************/
+static const ShaderProgram *ShadeBody( int body, const ShaderProgram &smooth,
+                                       const ShaderProgram &flat )
+{
+    const ShaderProgram *program = shade ? &flat : &smooth;
+
+    //Belts are shaded whenever they can be, other bodies with -shaders.
+    bool shaded = ( Bodies.Flags[body] & BodyBelt ) ? ShadersStarted :
+                  UseShaders;
+
+    if ( !shaded || VirtualTextured( body ) || program->Program == 0 )
+    {
+        UseProgram( 0 );
+        return NULL;
+    }
+
+    UseProgram( program->Program );
+
+    glBindBufferRange( GL_UNIFORM_BUFFER, BodyBinding, FrameBuffer,
+                       BodyStart + body * BodyStride, sizeof( BodyData ) );
+
+    //Keep the texture map loaded, as SetTexture does.
+    if ( textureToggle )
+        RequestTexture( body );
+
+    BindTexture( Bodies.Texture[body] );
+
+    return program;
+}
+
+
+
+/******************************************************************************
+* Author: Savoy Schuler and Daniel Hodgin
+*
+* Function: UseProgram
+*
+* Description:
+*
+*   This function puts a program in use, unless it already is.
+*
+* Parameters:
+*
+*   program - program object, 0 for fixed function
+*
+******************************************************************************/
+static void UseProgram( GLuint program )
+{
+    if ( program == CurrentProgram )
+    {
+        CountStateCall( false );
+        return;
+    }
+
+    glUseProgram( program );
+    CurrentProgram = program;
+    CountStateCall( true );
+}
@@ -0,0 +1,589 @@
+/******************************************************************************
+*	File: simulation.cpp
+*
+*	Authors: Savoy Schuler and Daniel Hodgin
+*
+*	Date: 11-17-16
+*
+*	Description:
+*
+*		This file contains the simulation thread. The orbits and rotations of
+*       the celestial bodies are advanced on their own thread in fixed steps of
+*       SimulationStep seconds, each moving the animation ahead by
+*       AnimateIncrement hours. The simulation thread owns its copy of every
+*       body's phases as well as the animation state (spinMode, singleStep,
+*       AnimateIncrement); the GLUT thread never touches them.
+*
+*       After each batch of steps the simulation publishes a snapshot of every
+*       body's phases, before and after the last step, through a lock free
+*       triple buffer. At the start of each frame Animate takes the newest
+*       snapshot and copies it into the body table for drawing.
+*
+*       Input reaches the simulation through a bounded single-producer,
+*       single-consumer command queue. The GLUT thread is the only producer
+*       and the simulation thread the only consumer. The simulation thread
+*       sleeps on a condition variable while paused, so it uses no CPU until a
+*       command arrives.
+*
+*	File Order and Structure:
+*
+*       - Start/stop the thread.
+*       - Command queue.
+*       - Simulation thread.
+*       - Snapshot handoff.
+*
+*	Modified:
+*
+*		Original
+*
+*	Functions Included:
+*
+*           //Start/stop the thread.
+*
+*       void StartSimulation();
+*       void StopSimulation();
+*
+*           //Command queue.
+*
+*       bool SendSimulationCommand( SimulationCommand command );
+*       static bool ReceiveCommand( SimulationCommand &command );
+*
+*           //Simulation thread.
+*
+*       static void SimulationLoop();
+*       static void RunCommand( SimulationCommand command );
+*       static void PublishSnapshot();
+*
+*           //Snapshot handoff.
+*
+*       bool ConsumeSnapshot();
+*       bool SimulationRunning();
+*       bool SimulationPending();
+*       double SnapshotAge();
+*
+******************************************************************************/
+
+/**************************** Library Includes *******************************/
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cmath>
+#include <cstdlib>
+#include <GL/freeglut.h>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "Planet.h"
+#include "globals.h"
+
+/******************************* Name Space **********************************/
+
+using namespace std;
+
+/******************************** Type Def ***********************************/
+
+typedef chrono::steady_clock Clock;
+
+//State of every body published to the renderer.
+struct SimulationSnapshot
+{
+    unsigned Sequence;          //increases with every published snapshot
+    Clock::time_point Time;     //time the last step was due
+    bool Running;               //whether the animation is running
+    unsigned CommandsRun;       //number of commands run so far
+    BodyPhases Phases;          //phases of every body
+};
+
+/******************************* Constants **********************************/
+
+//Length of one simulation step in seconds (each step is AnimateIncrement hours).
+static const double SimulationStep = 1.0 / 60.0;
+
+//Most real time, in seconds, caught up on after a stall.
+static const double MaxCatchUp = 0.25;
+
+//Number of commands the queue holds (a power of two).
+static const unsigned CommandQueueSize = 64;
+
+//Flag set in LatestSnapshot when it has not been read yet.
+static const int SnapshotFresh = 4;
+
+/********************************* Globals ***********************************/
+
+/* Owned by the simulation thread: */
+
+//Animation state.
+static GLenum spinMode = GL_TRUE;
+static GLenum singleStep = GL_TRUE;
+
+//Time step for animation (in Earth hours).
+static float AnimateIncrement = 0.5;
+
+//Phases of every body in the body table.
+static BodyPhases Phases;
+
+//Snapshot slot being written.
+static int BackSnapshot = 0;
+
+//Number of snapshots published.
+static unsigned Sequence = 0;
+
+//Number of commands run.
+static unsigned CommandsRun = 0;
+
+/* Owned by the GLUT thread: */
+
+//Snapshot slot being read.
+static int FrontSnapshot = 1;
+
+//Number of commands sent.
+static unsigned CommandsSent = 0;
+
+/* Shared between the threads: */
+
+//Triple buffer of snapshots.
+static SimulationSnapshot Snapshots[3];
+
+//Slot of the newest snapshot, with SnapshotFresh set until it is read.
+static atomic<int> LatestSnapshot( 2 );
+
+//Single-producer, single-consumer ring of commands.
+static SimulationCommand CommandQueue[CommandQueueSize];
+static atomic<unsigned> CommandHead( 0 );
+static atomic<unsigned> CommandTail( 0 );
+
+//Used only to put the simulation thread to sleep and wake it up.
+static mutex WakeMutex;
+static condition_variable WakeSignal;
+
+//Set to end the simulation thread.
+static atomic<bool> Quit( false );
+
+//The simulation thread.
+static thread *SimulationThread = NULL;
+
+/*************************** Function Prototypes *****************************/
+
+static bool ReceiveCommand( SimulationCommand &command );
+static void SimulationLoop();
+static void RunCommand( SimulationCommand command );
+static void PublishSnapshot();
+
+
+
+/******************************************************************************
+* Author: Savoy Schuler and Daniel Hodgin
+*
+* Function: StartSimulation
+*
+* Description:
+*
+*   This function publishes the starting phases of the bodies in the body
+*   table and starts the simulation thread. All bodies must be in the table
+*   before it is called. The thread is stopped when the program exits.
+*
+* Parameters:
+*
+*		void	- No input parameters needed.
+*
+******************************************************************************/
+void StartSimulation()
+{
+    //Size every snapshot once so publishing never allocates.
+    Phases = Bodies.Phases;
+
+    for ( int i = 0; i < 3; i++ )
+        Snapshots[i].Phases = Phases;
+
+    Snapshots[BackSnapshot].Time = Clock::now();
+    PublishSnapshot();
+
+    SimulationThread = new thread( SimulationLoop );
+    atexit( StopSimulation );
+}
+
+
+
+/******************************************************************************
+* Author: Savoy Schuler and Daniel Hodgin
+*
+* Function: StopSimulation
+*
+* Description:
+*
+*   This function ends the simulation thread and waits for it to finish.
+*
+* Parameters:
+*
+*		void	- No input parameters needed.
+*
+******************************************************************************/
+void StopSimulation()
+{
+    if ( SimulationThread == NULL )
+        return;
+
+    {
+        lock_guard<mutex> lock( WakeMutex );
+        Quit = true;
+    }
+    WakeSignal.notify_one();
+
+    SimulationThread->join();
+    delete SimulationThread;
+    SimulationThread = NULL;
+}
+
+
+
+/******************************************************************************
+* Author: Savoy Schuler and Daniel Hodgin
+*
+* Function: SendSimulationCommand
+*
+* Description:
+*
+*   This function queues a command for the simulation thread and wakes it.
+*   It must only be called from the GLUT thread. Returns false, dropping the
+*   command, if the queue is full.
+*
+* Parameters:
+*
+*   command - command to queue
+*
+******************************************************************************/
+bool SendSimulationCommand( SimulationCommand command )
+{
+    unsigned tail = CommandTail.load( memory_order_relaxed );
+
+    //Queue is full.
+    if ( tail - CommandHead.load( memory_order_acquire ) == CommandQueueSize )
+        return false;
+
+    CommandQueue[tail % CommandQueueSize] = command;
+    CommandTail.store( tail + 1, memory_order_release );
+    CommandsSent++;
+
+    //Wake the simulation thread if it is waiting.
+    {
+        lock_guard<mutex> lock( WakeMutex );
+    }
+    WakeSignal.notify_one();
+
+    return true;
+}
+
+
+
+/******************************************************************************
+* Author: Savoy Schuler and Daniel Hodgin
+*
+* Function: ReceiveCommand
+*
+* Description:
+*
+*   This function takes the oldest command off the queue. It must only be
+*   called from the simulation thread. Returns false if the queue is empty.
+*
+* Parameters:
+*
+*   command - returned command
+*
+******************************************************************************/
+static bool ReceiveCommand( SimulationCommand &command )
+{
+    unsigned head = CommandHead.load( memory_order_relaxed );
+
+    //Queue is empty.
+    if ( head == CommandTail.load( memory_order_acquire ) )
+        return false;
+
+    command = CommandQueue[head % CommandQueueSize];
+    CommandHead.store( head + 1, memory_order_release );
+
+    return true;
+}
+
+
+
+/******************************************************************************
+* Author: Savoy Schuler and Daniel Hodgin
+*
+* Function: SimulationLoop
+*
+* Description:
+*
+*   This is the body of the simulation thread. Each pass runs any queued
+*   commands, takes every step that has come due while the animation runs,
+*   and publishes a snapshot if anything changed. It then sleeps until the
+*   next step is due, or until a command arrives if the animation is paused.
+*
+* Parameters:
+*
+*		void	- No input parameters needed.
+*
+******************************************************************************/
+static void SimulationLoop()
+{
+    Clock::duration step = chrono::duration_cast<Clock::duration>(
+                               chrono::duration<double>( SimulationStep ) );
+    Clock::duration maxCatchUp = chrono::duration_cast<Clock::duration>(
+                                     chrono::duration<double>( MaxCatchUp ) );
+    Clock::time_point nextStep = Clock::now();
+    bool wasRunning = false;
+
+    while ( !Quit )
+    {
+        bool changed = false;
+        SimulationCommand command;
+
+        //Run queued commands.
+        while ( ReceiveCommand( command ) )
+        {
+            RunCommand( command );
+            CommandsRun++;
+            changed = true;
+        }
+
+        //Single step: take one step and pause again.
+        if ( spinMode && singleStep )
+        {
+            UpdateBodies( Phases, AnimateIncrement );
+            spinMode = GL_FALSE;
+            changed = true;
+        }
+
+        Clock::time_point now = Clock::now();
+
+        //Time spent paused does not count once the animation starts again.
+        if ( spinMode && !wasRunning )
+            nextStep = now;
+
+        wasRunning = spinMode;
+
+        //Take every step that has come due.
+        if ( spinMode )
+        {
+            //Avoid falling further behind after a long stall.
+            if ( now - nextStep > maxCatchUp )
+                nextStep = now - maxCatchUp;
+
+            while ( nextStep <= now )
+            {
+                UpdateBodies( Phases, AnimateIncrement );
+                nextStep += step;
+                changed = true;
+            }
+        }
+
+        if ( changed )
+        {
+            Snapshots[BackSnapshot].Time = nextStep - step;
+            PublishSnapshot();
+        }
+
+        //Sleep until the next step is due or a command arrives.
+        unique_lock<mutex> lock( WakeMutex );
+
+        if ( spinMode )
+            WakeSignal.wait_until( lock, nextStep );
+        else if ( !Quit && CommandHead == CommandTail )
+            WakeSignal.wait( lock );
+    }
+}
+
+
+
+/******************************************************************************
+* Author: Savoy Schuler and Daniel Hodgin
+*
+* Function: RunCommand
+*
+* Description:
+*
+*   This function carries out one command on the simulation thread.
+*
+*   Starting or stopping leaves single step mode if it is on. Stepping takes
+*   one step and pauses. Speeding up doubles the time step, bounded to avoid
+*   implicitly setting it to infinity, and slowing down halves it, bounded so
+*   it can not reach zero. Resetting puts every planet back at its start.
+*
+* Parameters:
+*
+*   command - command to run
+*
+******************************************************************************/
+static void RunCommand( SimulationCommand command )
+{
+    switch ( command )
+    {
+    //Start or stop the animation.
+    case CommandStartStop:
+        if ( singleStep )
+        {
+            singleStep = GL_FALSE;
+            spinMode = GL_TRUE;
+        }
+        else
+        {
+            spinMode = !spinMode;
+        }
+        break;
+
+    //Step the animation forward once.
+    case CommandStep:
+        singleStep = GL_TRUE;
+        spinMode = GL_TRUE;
+        break;
+
+    //Double the animation time step.
+    case CommandSpeedUp:
+        if ( AnimateIncrement < 4380.0 )
+            AnimateIncrement *= 2.0;
+        break;
+
+    //Halve the animation time step.
+    case CommandSpeedDown:
+        if ( AnimateIncrement > 0.0125 )
+            AnimateIncrement /= 2.0;
+        break;
+
+    //Move the planets back to their starting positions.
+    case CommandReset:
+        ResetBodies( Phases );
+        break;
+    }
+}
+
+
+
+/******************************************************************************
+* Author: Savoy Schuler and Daniel Hodgin
+*
+* Function: PublishSnapshot
+*
+* Description:
+*
+*   This function copies the phases into the back snapshot and swaps it with
+*   the newest one, marking it fresh. The previous newest snapshot becomes the
+*   new back snapshot. The renderer is never blocked.
+*
+* Parameters:
+*
+*		void	- No input parameters needed.
+*
+******************************************************************************/
+static void PublishSnapshot()
+{
+    SimulationSnapshot &snapshot = Snapshots[BackSnapshot];
+
+    snapshot.Sequence = ++Sequence;
+    snapshot.Running = spinMode;
+    snapshot.CommandsRun = CommandsRun;
+    snapshot.Phases = Phases;
+
+    BackSnapshot = LatestSnapshot.exchange( BackSnapshot | SnapshotFresh,
+                                            memory_order_acq_rel ) & 3;
+}
+
+
+
+/******************************************************************************
+* Author: Savoy Schuler and Daniel Hodgin
+*
+* Function: ConsumeSnapshot
+*
+* Description:
+*
+*   This function is called by the GLUT thread at the start of each frame.
+*   If a newer snapshot has been published it is swapped in and its phases
+*   are copied into the body table. Returns true if there was a new snapshot.
+*
+* Parameters:
+*
+*		void	- No input parameters needed.
+*
+******************************************************************************/
+bool ConsumeSnapshot()
+{
+    //Nothing new since the last frame.
+    if ( !( LatestSnapshot.load( memory_order_acquire ) & SnapshotFresh ) )
+        return false;
+
+    FrontSnapshot = LatestSnapshot.exchange( FrontSnapshot,
+                    memory_order_acq_rel ) & 3;
+
+    //Copy the phases into the body table for drawing.
+    Bodies.Phases = Snapshots[FrontSnapshot].Phases;
+
+    return true;
+}
+
+
+
+/******************************************************************************
+* Author: Savoy Schuler and Daniel Hodgin
+*
+* Function: SimulationRunning
+*
+* Description:
+*
+*   Returns whether the animation was running in the snapshot being drawn.
+*
+* Parameters:
+*
+*		void	- No input parameters needed.
+*
+******************************************************************************/
+bool SimulationRunning()
+{
+    return Snapshots[FrontSnapshot].Running;
+}
+
+
+
+/******************************************************************************
+* Author: Savoy Schuler and Daniel Hodgin
+*
+* Function: SimulationPending
+*
+* Description:
+*
+*   Returns whether commands have been sent that the snapshot being drawn does
+*   not show yet.
+*
+* Parameters:
+*
+*		void	- No input parameters needed.
+*
+******************************************************************************/
+bool SimulationPending()
+{
+    return Snapshots[FrontSnapshot].CommandsRun != CommandsSent;
+}
+
+
+
+/******************************************************************************
+* Author: Savoy Schuler and Daniel Hodgin
+*
+* Function: SnapshotAge
+*
+* Description:
+*
+*   Returns how far past the last step of the snapshot being drawn the
+*   current time is, in simulation steps. Used for blending between steps.
+*
+* Parameters:
+*
+*		void	- No input parameters needed.
+*
+******************************************************************************/
+double SnapshotAge()
+{
+    chrono::duration<double> age = Clock::now() - Snapshots[FrontSnapshot].Time;
+
+    return age.count() / SimulationStep;
+}
@@ -0,0 +1,338 @@
+/******************************************************************************
+*	File: skybox.cpp
+*
+*	Authors: Savoy Schuler and Daniel Hodgin
+*
+*	Date: 11-17-16
+*
+*	Description:
+*
+*		This file contains the skybox, the stars drawn behind everything.
+*       The backdrop's texture map is an equirectangular image, made for
+*       wrapping around a sphere. Rather than a finely tessellated sphere,
+*       it is turned into a cube map once and drawn on a cube of 12
+*       triangles around the eye, with the depth test off so it costs no
+*       depth writes and everything else draws over it.
+*
+*       The cube map is loaded like any texture map (see assets.cpp): the
+*       first time the backdrop is drawn it is requested, a worker reads its
+*       faces from the backdrop's .cube file or makes them from the image
+*       (see cubemap.cpp), and UploadAssets hands them to UploadSkybox on the
+*       GLUT thread. Faces found in the texture pack (see pack.cpp) go
+*       straight to upload. The stars are missing until the cube map arrives.
+*
+*	File Order and Structure:
+*
+*       - Register and draw skyboxes.
+*       - Load skyboxes.
+*
+*	Modified:
+*
+*		Original - Replaces the textured sphere drawn by DrawSpace.
+*
+*       Cube maps are loaded by the asset loader's workers, or taken from
+*       the texture pack, instead of on the GLUT thread.
+*
+*	Functions Included:
+*
+*           //Register and draw skyboxes.
+*
+*       void RegisterSkybox( const char *filename, int body );
+*       void DrawSkybox( int body );
+*
+*           //Load skyboxes.
+*
+*       void LoadSkybox( int body );
+*       void UploadSkybox( int body );
+*
+******************************************************************************/
+
+/**************************** Library Includes *******************************/
+#define GL_GLEXT_PROTOTYPES
+#include <cstdlib>
+#include <GL/freeglut.h>
+#include <iostream>
+#include <map>
+#include <string>
+#include "Planet.h"
+#include "globals.h"
+
+/******************************* Name Space **********************************/
+
+using namespace std;
+
+/******************************** Type Def ***********************************/
+
+//The cube map drawn for one backdrop body.
+struct Skybox
+{
+    string Filename;        //equirectangular .bmp texture map
+    GLuint Texture;         //cube map texture object, 0 until uploaded
+    bool Requested;         //set once handed to the asset loader
+    int MaxSize;            //largest face size OpenGL allows
+    int Size;               //texels on each side of a face
+    byte* Faces;            //faces read or made by a worker, until uploaded
+    const byte* Packed;     //faces in the texture pack, or NULL
+};
+
+/******************************* Constants **********************************/
+
+//Half the side of the cube drawn. Any size between the near and far planes
+//looks the same, since the cube moves with the eye.
+static const GLfloat SkyboxSize = 10.0;
+
+//Corners of the cube, also its cube map texture coordinates.
+static const GLfloat CubeCorners[8][3] =
+{
+    { -SkyboxSize, -SkyboxSize, -SkyboxSize },
+    {  SkyboxSize, -SkyboxSize, -SkyboxSize },
+    { -SkyboxSize,  SkyboxSize, -SkyboxSize },
+    {  SkyboxSize,  SkyboxSize, -SkyboxSize },
+    { -SkyboxSize, -SkyboxSize,  SkyboxSize },
+    {  SkyboxSize, -SkyboxSize,  SkyboxSize },
+    { -SkyboxSize,  SkyboxSize,  SkyboxSize },
+    {  SkyboxSize,  SkyboxSize,  SkyboxSize }
+};
+
+//Two triangles on each face of the cube.
+static const GLubyte CubeIndices[36] =
+{
+    1, 3, 7,  1, 7, 5,      //+x
+    0, 4, 6,  0, 6, 2,      //-x
+    2, 6, 7,  2, 7, 3,      //+y
+    0, 1, 5,  0, 5, 4,      //-y
+    4, 5, 7,  4, 7, 6,      //+z
+    0, 2, 3,  0, 3, 1       //-z
+};
+
+/********************************* Globals ***********************************/
+
+/* Owned by the GLUT thread, except each skybox's Size and Faces while it is
+   loading, which belong to the worker loading it: */
+
+//Skybox of each backdrop body.
+static map<int, Skybox> Skyboxes;
+
+//Vertex and index buffers of the cube, 0 until made.
+static GLuint CubeBuffer = 0;
+static GLuint CubeIndexBuffer = 0;
+
+
+
+/******************************************************************************
+* Author: Savoy Schuler and Daniel Hodgin
+*
+* Function: RegisterSkybox
+*
+* Description:
+*
+*   This function records the texture map of a backdrop body, and looks for
+*   its faces in the texture pack. Nothing is read until the backdrop is
+*   first drawn.
+*
+* Parameters:
+*
+*   filename    - equirectangular .bmp texture map
+*
+*   body        - row of the backdrop in the table
+*
+******************************************************************************/
+void RegisterSkybox( const char *filename, int body )
+{
+    Skybox skybox;
+    skybox.Filename = filename;
+    skybox.Texture = 0;
+    skybox.Requested = false;
+    skybox.MaxSize = 0;
+    skybox.Size = 0;
+    skybox.Faces = NULL;
+    skybox.Packed = FindPackedCube( CubeCacheName( filename ).c_str(),
+                                    skybox.Size );
+
+    Skyboxes[body] = skybox;
+}
+
+
+
+/******************************************************************************
+* Author: Savoy Schuler and Daniel Hodgin
+*
+* Function: DrawSkybox
+*
+* Description:
+*
+*   This function draws a backdrop's cube map on a cube centered at the
+*   current origin. The first time, it hands the cube map to the asset
+*   loader instead, and nothing is drawn until UploadSkybox has made its
+*   texture object, nor ever if the cube map could not be loaded. The caller
+*   sets the matrix, texture mode and depth test.
+*
+* Parameters:
+*
+*   body    - row of the backdrop in the table
+*
+******************************************************************************/
+void DrawSkybox( int body )
+{
+    map<int, Skybox>::iterator found = Skyboxes.find( body );
+    if ( found == Skyboxes.end() )
+        return;
+
+    Skybox &skybox = found->second;
+    if ( !skybox.Requested )
+    {
+        skybox.Requested = true;
+
+        //Only the GLUT thread may ask OpenGL how large the faces can be.
+        GLint maxSize;
+        glGetIntegerv( GL_MAX_CUBE_MAP_TEXTURE_SIZE, &maxSize );
+        skybox.MaxSize = maxSize;
+
+        //Faces packed larger than that are made again from the image.
+        if ( skybox.Size > skybox.MaxSize )
+            skybox.Packed = NULL;
+
+        RequestSkybox( body, skybox.Packed != NULL );
+    }
+
+    if ( skybox.Texture == 0 )
+        return;
+
+    //Make the cube the first time.
+    if ( CubeBuffer == 0 )
+    {
+        glGenBuffers( 1, &CubeBuffer );
+        glBindBuffer( GL_ARRAY_BUFFER, CubeBuffer );
+        glBufferData( GL_ARRAY_BUFFER, sizeof( CubeCorners ), CubeCorners,
+                      GL_STATIC_DRAW );
+
+        glGenBuffers( 1, &CubeIndexBuffer );
+        glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, CubeIndexBuffer );
+        glBufferData( GL_ELEMENT_ARRAY_BUFFER, sizeof( CubeIndices ),
+                      CubeIndices, GL_STATIC_DRAW );
+    }
+
+    //The cube map takes the place of the 2D texture while enabled.
+    glBindTexture( GL_TEXTURE_CUBE_MAP, skybox.Texture );
+    SetCapability( GL_TEXTURE_CUBE_MAP, true );
+
+    //Each corner is its own texture coordinate.
+    glBindBuffer( GL_ARRAY_BUFFER, CubeBuffer );
+    glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, CubeIndexBuffer );
+
+    glEnableClientState( GL_VERTEX_ARRAY );
+    glEnableClientState( GL_TEXTURE_COORD_ARRAY );
+
+    glVertexPointer( 3, GL_FLOAT, 0, 0 );
+    glTexCoordPointer( 3, GL_FLOAT, 0, 0 );
+
+    glDrawElements( GL_TRIANGLES, 36, GL_UNSIGNED_BYTE, 0 );
+    FrameStats.Triangles += 12;
+
+    //Restore client state.
+    glDisableClientState( GL_VERTEX_ARRAY );
+    glDisableClientState( GL_TEXTURE_COORD_ARRAY );
+
+    glBindBuffer( GL_ARRAY_BUFFER, 0 );
+    glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, 0 );
+
+    SetCapability( GL_TEXTURE_CUBE_MAP, false );
+}
+
+
+
+/******************************************************************************
+* Author: Savoy Schuler and Daniel Hodgin
+*
+* Function: LoadSkybox
+*
+* Description:
+*
+*   This function is run by an asset loader worker for each skybox
+*   requested. It reads the skybox's faces from its .cube file if that is up
+*   to date, or else makes them from its texture map and saves them to the
+*   .cube file for next time. The faces are left NULL if neither could be
+*   read. It uses no OpenGL.
+*
+* Parameters:
+*
+*   body    - row of the backdrop in the table
+*
+******************************************************************************/
+void LoadSkybox( int body )
+{
+    Skybox &skybox = Skyboxes.find( body )->second;
+
+    skybox.Faces = ReadCubeCache( skybox.Filename, skybox.MaxSize,
+                                  skybox.Size );
+    if ( skybox.Faces != NULL )
+        return;
+
+    int rows, cols;
+    byte* image;
+
+    if ( !LoadBmpFile( skybox.Filename.c_str(), rows, cols, image ) )
+        return;
+
+    skybox.Size = CubeFaceSize( cols, skybox.MaxSize );
+    skybox.Faces = BuildCubeMap( image, cols, rows, skybox.Size );
+    delete [] image;
+
+    WriteCubeCache( skybox.Filename, skybox.Faces, skybox.Size );
+}
+
+
+
+/******************************************************************************
+* Author: Savoy Schuler and Daniel Hodgin
+*
+* Function: UploadSkybox
+*
+* Description:
+*
+*   This function is called by UploadAssets for each skybox loaded. It
+*   creates the skybox's cube map texture object from the faces in the
+*   texture pack or those a worker made, and frees the latter. Nothing is
+*   created if there are no faces.
+*
+* Parameters:
+*
+*   body    - row of the backdrop in the table
+*
+******************************************************************************/
+void UploadSkybox( int body )
+{
+    Skybox &skybox = Skyboxes.find( body )->second;
+
+    const byte* faces = skybox.Packed != NULL ? skybox.Packed : skybox.Faces;
+    if ( faces == NULL )
+        return;
+
+    int size = skybox.Size;
+
+    glGenTextures( 1, &skybox.Texture );
+    glBindTexture( GL_TEXTURE_CUBE_MAP, skybox.Texture );
+
+    //Clamp to the edges so the faces meet without seams. The faces are at
+    //least as fine as the image, so no mipmaps are needed.
+    glTexParameteri( GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE );
+    glTexParameteri( GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE );
+    glTexParameteri( GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE );
+    glTexParameteri( GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_LINEAR );
+    glTexParameteri( GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_LINEAR );
+
+    //Face rows need no padding.
+    glPixelStorei( GL_UNPACK_ALIGNMENT, 1 );
+
+    size_t faceBytes = 3 * ( size_t ) size * size;
+    for ( int face = 0; face < 6; face++ )
+        glTexImage2D( GL_TEXTURE_CUBE_MAP_POSITIVE_X + face, 0, GL_RGB, size,
+                      size, 0, GL_RGB, GL_UNSIGNED_BYTE,
+                      faces + face * faceBytes );
+
+    glPixelStorei( GL_UNPACK_ALIGNMENT, 4 );
+
+    //OpenGL has its own copy now.
+    delete [] skybox.Faces;
+    skybox.Faces = NULL;
+}
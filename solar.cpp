@@ -25,15 +25,29 @@
  *
  * @par Usage Instructions:
  *
- *		solar
+ *		solar [-fps N] [-catalog file] [-texmem MB] [-shaders]
+ *		      [-impostor N] [-headless N] [-size WxH] [-step H]
+ *		      [-output name]
+ *
+ *		-fps N	- draw at most N frames per second while animating
+ *		-catalog file	- read the bodies from file instead of bodies.csv
+ *		-texmem MB	- most memory texture maps may take (default 256)
+ *		-shaders	- draw the bodies with GLSL shaders
+ *		-impostor N	- draw belt members, and with -shaders bodies, under
+ *				  N pixels in radius as impostors (default 8, 0 for never)
+ *		-headless N	- draw N frames to files without a window, and exit
+ *		-size WxH	- size of the headless frames (default 1000x1000)
+ *		-step H	- animation hours between headless frames (default 0.5)
+ *		-output name	- start of the headless frames' file names
+ *				  (default frame, making frame0000.ppm and on)
  *
  * @par Input:
  *
- *		<none>
+ *		bodies.csv	- catalog of the celestial bodies and their texture maps
  *
  * @par Output:
  *
- *		<none>
+ *		With -headless, the frames as binary PPM files.
  *
  * @details:
  *
@@ -75,6 +89,7 @@
  *****************************************************************************/
 
 /**************************** Library Includes *******************************/
+#include <cstdio>
 #include <cstdlib>
 #include <GL/freeglut.h>
 #include <iostream>
@@ -92,7 +107,16 @@
 *
 *   Main function of the program. Sets up the viewing screen and sets the
 *   callback function before permenantly entering the glut main loop, never to
-*   return.
+*   return. An optional "-fps N" argument caps the frame rate and an optional
+*   "-catalog file" argument picks the catalog the bodies are read from. The
+*   catalog is read here and the loader that decodes its texture maps in the
+*   background is started, so the first frame does not wait for them. An
+*   optional "-texmem MB" argument sets how much memory textures may take,
+*   and "-shaders" draws the bodies with the shader renderer, with
+*   "-impostor N" setting the radius in pixels bodies and belt members are
+*   drawn as impostors under. An optional "-headless N" argument draws N
+*   frames to files with no window instead, sized by "-size WxH", "-step H"
+*   hours apart and named by "-output name", then exits.
 *
 * Parameters:
 *
@@ -103,6 +127,54 @@
 ******************************************************************************/
 int main( int argc, char** argv )
 {
+    //Read the optional frame rate cap, body catalog, texture budget,
+    //renderer, impostor size and headless frames. GLUT's own arguments are
+    //skipped here and read by glutInit.
+    for ( int i = 1; i < argc; i++ )
+    {
+        if ( strcmp( argv[i], "-fps" ) == 0 && i + 1 < argc )
+            FrameRateCap = atoi( argv[i + 1] );
+        else if ( strcmp( argv[i], "-catalog" ) == 0 && i + 1 < argc )
+            CatalogFile = argv[i + 1];
+        else if ( strcmp( argv[i], "-texmem" ) == 0 && i + 1 < argc )
+            TextureBudget = ( size_t ) atoi( argv[i + 1] ) * 1024 * 1024;
+        else if ( strcmp( argv[i], "-shaders" ) == 0 )
+            UseShaders = true;
+        else if ( strcmp( argv[i], "-impostor" ) == 0 && i + 1 < argc )
+            ImpostorPixels = atof( argv[i + 1] );
+        else if ( strcmp( argv[i], "-headless" ) == 0 && i + 1 < argc )
+            HeadlessFrames = atoi( argv[i + 1] );
+        else if ( strcmp( argv[i], "-size" ) == 0 && i + 1 < argc )
+        {
+            char extra;
+            if ( sscanf( argv[i + 1], "%dx%d%c", &HeadlessWidth,
+                         &HeadlessHeight, &extra ) != 2 ||
+                    HeadlessWidth <= 0 || HeadlessHeight <= 0 )
+            {
+                fprintf( stderr, "main(): -size must be WxH, both positive: "
+                         "%s\n", argv[i + 1] );
+                return 1;
+            }
+        }
+        else if ( strcmp( argv[i], "-step" ) == 0 && i + 1 < argc )
+            HeadlessStep = atof( argv[i + 1] );
+        else if ( strcmp( argv[i], "-output" ) == 0 && i + 1 < argc )
+            HeadlessOutput = argv[i + 1];
+    }
+
+    //Map the texture pack, if built, then read the body catalog and start
+    //the loader that decodes its texture maps as they are needed.
+    OpenTexturePack( PackFile.c_str() );
+
+    if ( !LoadCatalog( CatalogFile.c_str() ) )
+        return 1;
+
+    StartAssetLoader();
+
+    //Draw the frames to files, with no window or display, if asked.
+    if ( HeadlessFrames > 0 )
+        return RunHeadless();
+
     //Set double buffer for animation.
     glutInit( &argc, argv );
     glutInitDisplayMode( GLUT_DOUBLE | GLUT_RGB | GLUT_DEPTH );
@@ -0,0 +1,125 @@
+/******************************************************************************
+*	File: stats.cpp
+*
+*	Authors: Savoy Schuler and Daniel Hodgin
+*
+*	Date: 11-17-16
+*
+*	Description:
+*
+*		This file contains the per-frame statistics. The draw functions add to
+*       the counters in FrameStats as they work, the counters are cleared at
+*       the start of every frame, and, while statistics are toggled on, the
+*       counters of the last frame are printed to the console about once a
+*       second along with the frame rate.
+*
+*	File Order and Structure:
+*
+*       - Frame statistics.
+*
+*	Modified:
+*
+*		Original
+*
+*	Functions Included:
+*
+*           //Frame statistics.
+*
+*       void ResetFrameStats();
+*       void ReportFrameStats();
+*
+******************************************************************************/
+
+/**************************** Library Includes *******************************/
+#include <cstdlib>
+#include <GL/freeglut.h>
+#include <iostream>
+#include <string>
+#include "Planet.h"
+#include "globals.h"
+
+/******************************* Name Space **********************************/
+
+using namespace std;
+
+/********************************* Globals ***********************************/
+
+//Counters for the frame being drawn.
+FrameStatistics FrameStats;
+
+
+
+/******************************************************************************
+* Author: Savoy Schuler and Daniel Hodgin
+*
+* Function: ResetFrameStats
+*
+* Description:
+*
+*   This function clears the frame counters. It is called at the start of
+*   each frame before anything is drawn.
+*
+* Parameters:
+*
+*		void	- No input parameters needed.
+*
+******************************************************************************/
+void ResetFrameStats()
+{
+    FrameStats = FrameStatistics();
+}
+
+
+
+/******************************************************************************
+* Author: Savoy Schuler and Daniel Hodgin
+*
+* Function: ReportFrameStats
+*
+* Description:
+*
+*   This function is called at the end of each frame. If statistics are
+*   toggled on, the counters of the frame just drawn are printed at most once
+*   a second, along with the number of frames drawn per second.
+*
+* Parameters:
+*
+*		void	- No input parameters needed.
+*
+******************************************************************************/
+void ReportFrameStats()
+{
+    static int frames = 0;
+    static int lastReport = 0;
+
+    frames++;
+
+    int now = glutGet( GLUT_ELAPSED_TIME );
+    if ( now - lastReport < 1000 )
+        return;
+
+    if ( showStats )
+    {
+        cout << frames * 1000.0 / ( now - lastReport ) << " fps, "
+             << FrameStats.Triangles << " triangles, "
+             << FrameStats.BodiesDrawn << " bodies drawn, "
+             << FrameStats.BodiesCulled << " culled, "
+             << FrameStats.OrbitsDrawn << " orbits drawn, "
+             << FrameStats.OrbitsCulled << " culled, "
+             << FrameStats.StateCalls << " state changes ("
+             << FrameStats.StateCallsElided << " skipped), "
+             << FrameStats.LabelsDrawn << " labels drawn, "
+             << FrameStats.LabelsHidden << " hidden, "
+             << FrameStats.BodiesShaded << " shaded, "
+             << FrameStats.MembersDrawn << " belt members drawn, "
+             << FrameStats.MembersCulled << " culled, in "
+             << FrameStats.BeltDraws << " draws, "
+             << FrameStats.Impostors << " impostors, "
+             << ResidentTextures() << " textures in "
+             << ResidentTextureBytes() / ( 1024 * 1024 ) << " MB, "
+             << ResidentTiles() << " tiles" << endl;
+    }
+
+    frames = 0;
+    lastReport = now;
+}
@@ -0,0 +1,304 @@
+/******************************************************************************
+*	File: textures.cpp
+*
+*	Authors: Savoy Schuler and Daniel Hodgin
+*
+*	Date: 11-17-16
+*
+*	Description:
+*
+*		This file contains the texture manager. Each celestial body's texture
+*       map is uploaded once the asset loader has decoded it and built its
+*       mipmaps (see mipmaps.cpp), or straight from the texture pack: into a
+*       cell of the texture atlas shared by all bodies (see atlas.cpp), or to
+*       its own OpenGL texture object if it does not fit there. Drawing a body
+*       then only needs the texture object and window stored in the body
+*       table. The texture object bound and the window in the texture matrix
+*       are remembered, so bodies drawn one after another from the atlas need
+*       no texture binds. A body whose texture map has not arrived yet has no
+*       texture object and is drawn in its own color.
+*
+*	File Order and Structure:
+*
+*       - Create texture objects.
+*       - Bind texture objects.
+*
+*	Modified:
+*
+*		Texture objects are created once at load time instead of rebuilding
+*       mipmaps every time a body is drawn.
+*
+*	Functions Included:
+*
+*           //Create texture objects.
+*
+*       int CreateTextureLevels( int body, const TextureLevels &levels );
+*       void DeleteTexture( int body, int cell );
+*
+*           //Bind texture objects.
+*
+*       void SetTexture( int body );
+*       void BindTexture( GLuint texture );
+*       void SetTextureWindow( const TextureWindow &window );
+*       bool BodyTextured( int body );
+*
+******************************************************************************/
+
+/**************************** Library Includes *******************************/
+#include <cstdlib>
+#include <cstring>
+#include <GL/freeglut.h>
+#include <iostream>
+#include <string>
+#include "Planet.h"
+#include "globals.h"
+
+/********************************* Globals ***********************************/
+
+//Texture object bound to GL_TEXTURE_2D.
+static GLuint BoundTexture = 0;
+
+//Window loaded into the texture matrix.
+static TextureWindow LoadedWindow = WholeTexture;
+
+
+
+/******************************************************************************
+* Author: Daniel Hodgin and Savoy Schuler
+*
+* Function: CreateTextureLevels
+*
+* Description:
+*
+*   This function uploads a texture map for a body and stores the texture
+*   object and window holding it in the body table. The largest level goes
+*   into the atlas if it fits, and its atlas cell is returned. Otherwise a
+*   texture object of its own is created from the mipmap levels and -1 is
+*   returned: the texture parameters are set and the levels uploaded a
+*   single time here, so later draws only have to bind the texture object.
+*   Levels larger than OpenGL allows are skipped, as gluBuild2DMipmaps would
+*   shrink them. The levels are blended between when the texture map is
+*   drawn smaller than its largest level, so minified bodies do not
+*   shimmer; the atlas holds only the largest level.
+*
+* Parameters:
+*
+*   body    - row of the body whose texture map is uploaded.
+*
+*   levels  - the texture map's levels, built by BuildMipmaps or the packer.
+*
+******************************************************************************/
+int CreateTextureLevels( int body, const TextureLevels &levels )
+{
+    GLuint texture;
+    GLint maxSize;
+
+    //Share the atlas if there is room.
+    int cell = AddToAtlas( levels, Bodies.Window[body] );
+    if ( cell >= 0 )
+    {
+        Bodies.Texture[body] = AtlasTexture();
+        return cell;
+    }
+
+    //Create and bind a new texture object.
+    glGenTextures( 1, &texture );
+    BindTexture( texture );
+
+    //Set texture parameters. These are stored with the texture object.
+    glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT );
+    glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT );
+    glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR );
+    glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER,
+                     GL_LINEAR_MIPMAP_LINEAR );
+
+    //Upload each level that fits, rows padded to 4 bytes.
+    glGetIntegerv( GL_MAX_TEXTURE_SIZE, &maxSize );
+    glPixelStorei( GL_UNPACK_ALIGNMENT, 4 );
+
+    int cols = levels.Cols, rows = levels.Rows, first = 0;
+
+    for ( int level = 0; level < levels.Levels; level++ )
+    {
+        if ( cols > maxSize || rows > maxSize )
+            first = level + 1;
+        else
+            glTexImage2D( GL_TEXTURE_2D, level - first, GL_RGB, cols, rows, 0,
+                          GL_RGB, GL_UNSIGNED_BYTE, levels.Level[level] );
+
+        cols = cols > 1 ? cols / 2 : 1;
+        rows = rows > 1 ? rows / 2 : 1;
+    }
+
+    //Sample only the levels uploaded, which may stop short of 1x1.
+    glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL,
+                     levels.Levels - 1 - first );
+
+    //Save the texture object in the body table.
+    Bodies.Texture[body] = texture;
+    Bodies.Window[body] = WholeTexture;
+
+    return -1;
+}
+
+
+
+/******************************************************************************
+* Author: Daniel Hodgin and Savoy Schuler
+*
+* Function: DeleteTexture
+*
+* Description:
+*
+*   This function frees a texture map uploaded by CreateTextureLevels: its
+*   atlas cell, or else its texture object. The body table is left for the
+*   caller to clear.
+*
+* Parameters:
+*
+*   body    - row of a body the texture map was uploaded for.
+*
+*   cell    - atlas cell returned by CreateTextureLevels.
+*
+******************************************************************************/
+void DeleteTexture( int body, int cell )
+{
+    if ( cell >= 0 )
+    {
+        RemoveFromAtlas( cell );
+        return;
+    }
+
+    GLuint texture = Bodies.Texture[body];
+
+    //OpenGL binds texture object 0 in place of a deleted bound one.
+    if ( BoundTexture == texture )
+        BoundTexture = 0;
+
+    glDeleteTextures( 1, &texture );
+}
+
+
+
+/******************************************************************************
+* Author: Daniel Hodgin and Savoy Schuler
+*
+* Function: SetTexture
+*
+* Description:
+*
+*   This function binds a body's texture object for drawing and loads its
+*   window into the texture matrix. Texture parameters were set when the
+*   texture object was created, so only the bind is needed, and none at all
+*   if the last body drawn used the same texture object. Bodies without a
+*   texture object bind the default texture. With texture mapping on, the
+*   body's texture map is requested from the asset loader, which loads it if
+*   needed and keeps it from being evicted.
+*
+* Parameters:
+*
+*   body    - row of the body whose texture is bound.
+*
+******************************************************************************/
+void SetTexture( int body )
+{
+    if ( textureToggle )
+        RequestTexture( body );
+
+    BindTexture( Bodies.Texture[body] );
+    SetTextureWindow( Bodies.Window[body] );
+}
+
+
+
+/******************************************************************************
+* Author: Daniel Hodgin and Savoy Schuler
+*
+* Function: BindTexture
+*
+* Description:
+*
+*   This function binds a texture object to GL_TEXTURE_2D, unless it is
+*   already bound. All texture binds go through here so the one bound is
+*   always known. Binds made and skipped are counted with the other state
+*   changes (see glstate.cpp).
+*
+* Parameters:
+*
+*   texture - texture object to bind, 0 for the default texture.
+*
+******************************************************************************/
+void BindTexture( GLuint texture )
+{
+    if ( texture == BoundTexture )
+    {
+        CountStateCall( false );
+        return;
+    }
+
+    glBindTexture( GL_TEXTURE_2D, texture );
+    BoundTexture = texture;
+    CountStateCall( true );
+}
+
+
+
+/******************************************************************************
+* Author: Daniel Hodgin and Savoy Schuler
+*
+* Function: SetTextureWindow
+*
+* Description:
+*
+*   This function loads the texture matrix taking texture coordinates of a
+*   texture map to its window of the bound texture object, unless that
+*   window is already loaded. All changes to the texture matrix go through
+*   here.
+*
+* Parameters:
+*
+*   window  - window of the texture object to draw from.
+*
+******************************************************************************/
+void SetTextureWindow( const TextureWindow &window )
+{
+    if ( memcmp( &window, &LoadedWindow, sizeof( window ) ) == 0 )
+    {
+        CountStateCall( false );
+        return;
+    }
+
+    glMatrixMode( GL_TEXTURE );
+    glLoadIdentity();
+    glTranslatef( window.Offset[0], window.Offset[1], 0.0 );
+    glScalef( window.Scale[0], window.Scale[1], 1.0 );
+    glMatrixMode( GL_MODELVIEW );
+
+    LoadedWindow = window;
+    CountStateCall( true );
+}
+
+
+
+/******************************************************************************
+* Author: Daniel Hodgin and Savoy Schuler
+*
+* Function: BodyTextured
+*
+* Description:
+*
+*   Returns true if a body is drawn with its texture map: texture mapping is
+*   on and the body's texture object has been created, or its virtual
+*   texture has a tile to draw from. Otherwise the body is drawn in its own
+*   color.
+*
+* Parameters:
+*
+*   body    - row of the body in the table.
+*
+******************************************************************************/
+bool BodyTextured( int body )
+{
+    return textureToggle && ( Bodies.Texture[body] != 0 ||
+                              VirtualTextured( body ) );
+}
@@ -0,0 +1,320 @@
+/******************************************************************************
+*	File: transforms.cpp
+*
+*	Authors: Savoy Schuler and Daniel Hodgin
+*
+*	Date: 11-17-16
+*
+*	Description:
+*
+*		This file contains the body transforms. Every body is drawn turned
+*       about the z axis and moved in the plane of the orbits: a planet by
+*       its orbit and then its spin, the Earth's moon by the Earth's frame
+*       and then its own turn, rings in their planet's frame. Rather than
+*       have each draw function build its matrix from the view with
+*       glRotatef and glTranslatef, once per frame UpdateTransforms finds
+*       where each body is and how far it has turned, then works out the
+*       model view matrices of every body in one pass into a single array,
+*       16 floats per body. Drawing a body then loads its matrix with one
+*       glLoadMatrixf.
+*
+*	File Order and Structure:
+*
+*       - Update transforms.
+*       - Use transforms.
+*
+*	Modified:
+*
+*		Original - Replaces the glRotatef and glTranslatef calls of the draw
+*       functions.
+*
+*	Functions Included:
+*
+*           //Update transforms.
+*
+*       void UpdateTransforms();
+*       static void PlaceBody( int body );
+*       static void MultiplyTransforms();
+*
+*           //Use transforms.
+*
+*       void LoadTransform( int body );
+*       const GLfloat* TransformMatrix( int body );
+*       void TransformPosition( int body, float position[3] );
+*       float TransformAngle( int body );
+*
+******************************************************************************/
+
+/**************************** Library Includes *******************************/
+#include <cstdlib>
+#include <cmath>
+#include <GL/freeglut.h>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "Planet.h"
+#include "globals.h"
+
+/******************************* Name Space **********************************/
+
+using namespace std;
+
+/******************************** Type Def ***********************************/
+
+//Where every body is drawn in this frame, one row per body and one array
+//per field, like the body table.
+struct TransformTable
+{
+    vector<float> Angle;        //turn about the z axis, in degrees
+    vector<float> X, Y, Z;      //center in solar system coordinates
+    vector<GLfloat> Matrix;     //model view matrix, 16 floats per body
+};
+
+/********************************* Globals ***********************************/
+
+//Transforms of every body for the frame being drawn.
+static TransformTable Transforms;
+
+/*************************** Function Prototypes *****************************/
+
+static void PlaceBody( int body );
+static void MultiplyTransforms();
+
+
+
+/******************************************************************************
+* Author: Savoy Schuler and Daniel Hodgin
+*
+* Function: UpdateTransforms
+*
+* Description:
+*
+*   This function finds the model view matrix of every body for the frame.
+*   Bodies are placed first, those drawn with another body after it, and
+*   the matrices are then all worked out together. This should be called
+*   once at the start of each frame, after the snapshot is taken and the
+*   camera updated.
+*
+* Parameters:
+*
+*		void	- No input parameters needed.
+*
+******************************************************************************/
+void UpdateTransforms()
+{
+    int count = BodyCount();
+
+    Transforms.Angle.resize( count );
+    Transforms.X.resize( count );
+    Transforms.Y.resize( count );
+    Transforms.Z.resize( count );
+    Transforms.Matrix.resize( 16 * count );
+
+    //Moons and rings are placed from their planets, so place planets first.
+    for ( int i = 0; i < count; i++ )
+        if ( !( Bodies.Flags[i] & ( BodyMoon | BodyRings ) ) )
+            PlaceBody( i );
+
+    for ( int i = 0; i < count; i++ )
+        if ( Bodies.Flags[i] & ( BodyMoon | BodyRings ) )
+            PlaceBody( i );
+
+    MultiplyTransforms();
+}
+
+
+
+/******************************************************************************
+* Author: Savoy Schuler and Daniel Hodgin
+*
+* Function: PlaceBody
+*
+* Description:
+*
+*   This function finds where a body is drawn and how far it is turned. The
+*   sun turns at the origin, a planet's orbit and spin add up to one turn
+*   once it is moved out to its orbit, a moon circles its planet by its own
+*   orbit and spin, and rings are placed as their planet. The backdrop is not
+*   placed here (see DrawSpace).
+*
+* Parameters:
+*
+*   body    - row of the body in the table
+*
+******************************************************************************/
+static void PlaceBody( int body )
+{
+    unsigned flags = Bodies.Flags[body];
+    int parent = Bodies.Parent[body];
+    float position[3] = { 0.0, 0.0, 0.0 };
+    float turn = 0.0;
+
+    if ( flags & BodyStar )
+    {
+        turn = SpinPhase( body );
+    }
+    else if ( flags & BodyPlanet )
+    {
+        GetPlanetPosition( body, position );
+        turn = OrbitPhase( body ) + SpinPhase( body );
+    }
+    else if ( ( flags & BodyMoon ) && parent >= 0 )
+    {
+        /*The moon circles its planet, out from the planet's surface, and
+        keeps one face to it unless it has a spin of its own.*/
+        float orbitAngle = 2.0 * PI * OrbitPhase( body );
+        float distance = Bodies.Radius[parent] * SizeScale +
+                         Bodies.Distance[body] * MoonDistScale;
+
+        position[0] = Transforms.X[parent] + distance * cos( orbitAngle );
+        position[1] = Transforms.Y[parent] + distance * sin( orbitAngle );
+        turn = OrbitPhase( body ) + SpinPhase( body );
+    }
+    else if ( ( flags & BodyRings ) && parent >= 0 )
+    {
+        turn = Transforms.Angle[parent] / 360.0;
+        position[0] = Transforms.X[parent];
+        position[1] = Transforms.Y[parent];
+        position[2] = Transforms.Z[parent];
+    }
+
+    Transforms.Angle[body] = 360.0 * turn;
+    Transforms.X[body] = position[0];
+    Transforms.Y[body] = position[1];
+    Transforms.Z[body] = position[2];
+}
+
+
+
+/******************************************************************************
+* Author: Savoy Schuler and Daniel Hodgin
+*
+* Function: MultiplyTransforms
+*
+* Description:
+*
+*   This function works out every body's model view matrix, the view matrix
+*   times the body's turn and position, in a single pass over the table.
+*   A body's matrix only turns about z and moves, so the view's third
+*   column is kept, its first two are turned by the body's angle, and its
+*   fourth is moved by the body's position. Matrices are column major, as
+*   glLoadMatrixf takes them.
+*
+* Parameters:
+*
+*		void	- No input parameters needed.
+*
+******************************************************************************/
+static void MultiplyTransforms()
+{
+    const GLfloat *view = GetViewMatrix();
+    int count = Transforms.Angle.size();
+
+    for ( int i = 0; i < count; i++ )
+    {
+        float angle = Transforms.Angle[i] * PI / 180.0;
+        float c = cos( angle ), s = sin( angle );
+        float x = Transforms.X[i], y = Transforms.Y[i], z = Transforms.Z[i];
+        GLfloat *matrix = &Transforms.Matrix[16 * i];
+
+        for ( int row = 0; row < 4; row++ )
+        {
+            matrix[row] = c * view[row] + s * view[4 + row];
+            matrix[4 + row] = c * view[4 + row] - s * view[row];
+            matrix[8 + row] = view[8 + row];
+            matrix[12 + row] = x * view[row] + y * view[4 + row] +
+                               z * view[8 + row] + view[12 + row];
+        }
+    }
+}
+
+
+
+/******************************************************************************
+* Author: Savoy Schuler and Daniel Hodgin
+*
+* Function: LoadTransform
+*
+* Description:
+*
+*   This function loads a body's model view matrix for drawing it, centered
+*   at the origin and turned.
+*
+* Parameters:
+*
+*   body    - row of the body in the table
+*
+******************************************************************************/
+void LoadTransform( int body )
+{
+    glLoadMatrixf( &Transforms.Matrix[16 * body] );
+}
+
+
+
+/******************************************************************************
+* Author: Savoy Schuler and Daniel Hodgin
+*
+* Function: TransformMatrix
+*
+* Description:
+*
+*   Returns a body's model view matrix for this frame, 16 floats in column
+*   major order, for the shader renderer to upload (see shaders.cpp).
+*
+* Parameters:
+*
+*   body    - row of the body in the table
+*
+******************************************************************************/
+const GLfloat* TransformMatrix( int body )
+{
+    return &Transforms.Matrix[16 * body];
+}
+
+
+
+/******************************************************************************
+* Author: Savoy Schuler and Daniel Hodgin
+*
+* Function: TransformPosition
+*
+* Description:
+*
+*   This function returns the center of a body in this frame.
+*
+* Parameters:
+*
+*   body        - row of the body in the table
+*
+*   position    - set to the body's center in solar system coordinates
+*
+******************************************************************************/
+void TransformPosition( int body, float position[3] )
+{
+    position[0] = Transforms.X[body];
+    position[1] = Transforms.Y[body];
+    position[2] = Transforms.Z[body];
+}
+
+
+
+/******************************************************************************
+* Author: Savoy Schuler and Daniel Hodgin
+*
+* Function: TransformAngle
+*
+* Description:
+*
+*   Returns how far a body is turned about the z axis in this frame, in
+*   degrees.
+*
+* Parameters:
+*
+*   body    - row of the body in the table
+*
+******************************************************************************/
+float TransformAngle( int body )
+{
+    return Transforms.Angle[body];
+}
@@ -0,0 +1,973 @@
+/******************************************************************************
+*	File: vtexture.cpp
+*
+*	Authors: Savoy Schuler and Daniel Hodgin
+*
+*	Date: 11-17-16
+*
+*	Description:
+*
+*		This file contains the virtual texture cache, used for texture maps
+*       too big to upload whole. The packer stores such maps in tiles (see
+*       pack.h), and only the tiles needed for the parts of a body in view, at
+*       the detail its size on screen calls for, are ever uploaded.
+*
+*       Each tiled texture map has a page table: one entry per tile of each
+*       level, holding the slot of the tile cache the tile is in. The cache
+*       is a fixed number of slots, each a texture object one tile in size,
+*       so the memory used never grows no matter how large the texture maps
+*       are. When every slot is taken, the tile least recently drawn from is
+*       replaced, unless it was drawn from in the last frame.
+*
+*       A body is drawn one patch of its sphere per tile, starting from the
+*       single tile of the smallest level. A tile facing away from the eye or
+*       outside the view is skipped; a tile with fewer texels than the pixels
+*       it covers is split into the four tiles of the next larger level that
+*       cover it. Each patch is drawn with the texture matrix set to map the
+*       sphere's texture coordinates into its tile. A tile not in the cache
+*       yet is requested and its patch drawn from the nearest tile of a
+*       smaller level that is, so close views sharpen as tiles arrive.
+*
+*       Tiles are read straight from the mapped texture pack. When a tile is
+*       requested, the kernel is asked to read its pages in the background
+*       and it is uploaded at the start of a later frame, once the pages are
+*       in memory, at most TileUploadsPerFrame tiles a frame.
+*
+*	File Order and Structure:
+*
+*       - Register virtual textures.
+*       - Draw virtual textures.
+*       - Request and upload tiles.
+*
+*	Modified:
+*
+*		Original
+*
+*	Functions Included:
+*
+*           //Register virtual textures.
+*
+*       bool RegisterVirtualTexture( const char *filename, int body );
+*       bool VirtualTextured( int body );
+*
+*           //Draw virtual textures.
+*
+*       bool DrawVirtualSphere( int body, const float position[3],
+*                               float angle, float radius, int resolution );
+*       static void DrawTile( const TileView &view, int level, int tx, int ty,
+*                             int fallback, int fallbackLevel,
+*                             int fallbackTx, int fallbackTy );
+*       static void DrawPatch( const TileView &view, float s0, float s1,
+*                              float t0, float t1 );
+*       static void SphereDirection( float s, float t, float direction[3] );
+*       static void PatchLines( float first, float last, int resolution,
+*                               vector<float> &lines );
+*
+*           //Request and upload tiles.
+*
+*       static void RequestTile( int texture, int level, int tile );
+*       static int FindSlot();
+*       static bool SlotFree();
+*       bool UploadTiles();
+*       bool TilesPending();
+*       bool TilesReady();
+*       void PrefetchTiles();
+*       int ResidentTiles();
+*
+******************************************************************************/
+
+/**************************** Library Includes *******************************/
+#include <cstdlib>
+#include <cmath>
+#include <GL/freeglut.h>
+#include <iostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "Planet.h"
+#include "globals.h"
+#include "pack.h"
+
+/******************************* Name Space **********************************/
+
+using namespace std;
+
+/******************************** Type Def ***********************************/
+
+//Page table entries of tiles not in the cache.
+enum TilePage
+{
+    TileAbsent = -1,    //not in the cache or requested
+    TileRequested = -2  //waiting for its pages to be read
+};
+
+//A tiled texture map and its page table.
+struct VirtualTexture
+{
+    TextureLevels Levels;               //first tile of each level in the pack
+    vector<int> Pages[MaxTextureLevels];    //cache slot of each tile, or TilePage
+};
+
+//A slot of the tile cache.
+struct TileSlot
+{
+    GLuint Object;      //texture object holding the tile
+    int Texture;        //virtual texture of the tile held, -1 for none
+    int Level;          //level of the tile held
+    int Tile;           //tile held, numbered along the rows of its level
+    unsigned LastUsed;  //frame it was last drawn from
+};
+
+//A tile waiting for its pages to be read.
+struct TileRequest
+{
+    int Texture;        //virtual texture of the tile
+    int Level;          //level of the tile
+    int Tile;           //tile, numbered along the rows of its level
+    unsigned LastWanted;    //frame it was last needed in
+};
+
+//What is needed to draw the tiles of one body.
+struct TileView
+{
+    int Texture;            //virtual texture drawn
+    float Position[3];      //center of the body in solar system coordinates
+    float Cos, Sin;         //turn of the body about the z axis
+    float Radius;           //radius of the body as drawn
+    float Eye[3];           //eye relative to the body, in radii, unturned
+    float EyeDistance;      //length of Eye
+    int Resolution;         //slices and stacks around the whole sphere
+};
+
+/******************************* Constants **********************************/
+
+//Slots in the tile cache (3 bytes a texel, about 24 MB).
+static const int TileSlots = 128;
+
+//Most tiles uploaded at the start of one frame.
+static const int TileUploadsPerFrame = 8;
+
+/********************************* Globals ***********************************/
+
+//Every tiled texture map registered.
+static vector<VirtualTexture> VirtualTextures;
+
+//Virtual texture of each body, -1 for none.
+static vector<int> BodyVirtual;
+
+//Virtual texture index of each file registered.
+static unordered_map<string, int> VirtualFiles;
+
+//The tile cache, grown one slot at a time up to TileSlots.
+static vector<TileSlot> Slots;
+
+//Tiles waiting for their pages to be read.
+static vector<TileRequest> TileRequests;
+
+//Number of the frame being drawn.
+static unsigned TileFrame = 0;
+
+//Patch vertices and indices, reused for every patch drawn.
+static vector<GLfloat> PatchVertices;
+static vector<GLuint> PatchIndices;
+
+/*************************** Function Prototypes *****************************/
+
+static void DrawTile( const TileView &view, int level, int tx, int ty,
+                      int fallback, int fallbackLevel, int fallbackTx,
+                      int fallbackTy );
+static void DrawPatch( const TileView &view, float s0, float s1, float t0,
+                       float t1 );
+static void SphereDirection( float s, float t, float direction[3] );
+static void PatchLines( float first, float last, int resolution,
+                        vector<float> &lines );
+static void RequestTile( int texture, int level, int tile );
+static int FindSlot();
+static bool SlotFree();
+
+/******************************* Inline Helpers ******************************/
+
+//Columns (or rows) in a level.
+static inline int LevelSize( int size, int level )
+{
+    return max( size >> level, 1 );
+}
+
+
+
+/******************************************************************************
+* Author: Savoy Schuler and Daniel Hodgin
+*
+* Function: PrefetchTiles
+*
+* Description:
+*
+*   This function asks the kernel again to read the pages of every requested
+*   tile not uploaded yet. Pages read for a tile may be dropped again under
+*   memory pressure before UploadTiles gets to them, and would otherwise
+*   never be read.
+*
+* Parameters:
+*
+*		void	- No input parameters needed.
+*
+******************************************************************************/
+void PrefetchTiles()
+{
+    for ( unsigned i = 0; i < TileRequests.size(); i++ )
+    {
+        TileRequest &request = TileRequests[i];
+
+        PrefetchPack( VirtualTextures[request.Texture].Levels.Level[request.Level] +
+                      request.Tile * PackTileBytes, PackTileBytes );
+    }
+}
+
+
+
+/******************************************************************************
+* Author: Savoy Schuler and Daniel Hodgin
+*
+* Function: RegisterVirtualTexture
+*
+* Description:
+*
+*   This function draws a body from virtual textures if its texture map is
+*   tiled in the texture pack. A file registered for another body is shared.
+*   Returns false, registering nothing, if the texture map is not tiled.
+*
+* Parameters:
+*
+*   filename    - .bmp texture map
+*
+*   body        - row of the body in the table
+*
+******************************************************************************/
+bool RegisterVirtualTexture( const char *filename, int body )
+{
+    unordered_map<string, int>::iterator texture = VirtualFiles.find( filename );
+
+    if ( texture == VirtualFiles.end() )
+    {
+        VirtualTexture entry;
+
+        if ( !FindPackedTiles( filename, entry.Levels ) )
+            return false;
+
+        //Nothing is in the cache yet.
+        for ( int level = 0; level < entry.Levels.Levels; level++ )
+        {
+            int cols = LevelSize( entry.Levels.Cols, level );
+            int rows = LevelSize( entry.Levels.Rows, level );
+
+            entry.Pages[level].assign( PackTiles( cols ) * PackTiles( rows ),
+                                       TileAbsent );
+        }
+
+        texture = VirtualFiles.insert( make_pair( string( filename ),
+                                                  VirtualTextures.size() ) ).first;
+        VirtualTextures.push_back( entry );
+    }
+
+    if ( ( int ) BodyVirtual.size() <= body )
+        BodyVirtual.resize( body + 1, -1 );
+
+    BodyVirtual[body] = texture->second;
+
+    return true;
+}
+
+
+
+/******************************************************************************
+* Author: Savoy Schuler and Daniel Hodgin
+*
+* Function: VirtualTextured
+*
+* Description:
+*
+*   Returns true if a body is drawn from a virtual texture whose smallest
+*   level is in the cache, so every part of it has a tile to draw from.
+*
+* Parameters:
+*
+*   body    - row of the body in the table
+*
+******************************************************************************/
+bool VirtualTextured( int body )
+{
+    if ( body >= ( int ) BodyVirtual.size() || BodyVirtual[body] < 0 )
+        return false;
+
+    VirtualTexture &texture = VirtualTextures[BodyVirtual[body]];
+
+    return texture.Pages[texture.Levels.Levels - 1][0] >= 0;
+}
+
+
+
+/******************************************************************************
+* Author: Savoy Schuler and Daniel Hodgin
+*
+* Function: DrawVirtualSphere
+*
+* Description:
+*
+*   This function draws a body's sphere from its virtual texture, taking the
+*   place of DrawSphere. Its smallest level is requested first; until it is
+*   in the cache, and for bodies without a virtual texture or with texture
+*   mapping off, nothing is drawn and false is returned.
+*
+* Parameters:
+*
+*   body        - row of the body being drawn
+*
+*   position    - center of the body in solar system coordinates
+*
+*   angle       - turn of the body about the z axis, in degrees
+*
+*   radius      - radius of the body as drawn
+*
+*   resolution  - slices and stacks of the whole sphere
+*
+******************************************************************************/
+bool DrawVirtualSphere( int body, const float position[3], float angle,
+                        float radius, int resolution )
+{
+    if ( !textureToggle || body >= ( int ) BodyVirtual.size() ||
+            BodyVirtual[body] < 0 )
+        return false;
+
+    int index = BodyVirtual[body];
+    VirtualTexture &texture = VirtualTextures[index];
+    int smallest = texture.Levels.Levels - 1;
+
+    if ( texture.Pages[smallest][0] < 0 )
+    {
+        RequestTile( index, smallest, 0 );
+        return false;
+    }
+
+    //Find the eye relative to the body, undoing the body's turn.
+    TileView view;
+    float eye[3];
+
+    view.Texture = index;
+    view.Cos = cos( angle * PI / 180.0 );
+    view.Sin = sin( angle * PI / 180.0 );
+    view.Radius = radius;
+    view.Resolution = resolution;
+
+    CameraPosition( eye );
+    for ( int i = 0; i < 3; i++ )
+    {
+        view.Position[i] = position[i];
+        eye[i] = ( eye[i] - position[i] ) / radius;
+    }
+
+    view.Eye[0] = view.Cos * eye[0] + view.Sin * eye[1];
+    view.Eye[1] = -view.Sin * eye[0] + view.Cos * eye[1];
+    view.Eye[2] = eye[2];
+    view.EyeDistance = sqrt( eye[0] * eye[0] + eye[1] * eye[1] +
+                             eye[2] * eye[2] );
+
+    //Scale the unit sphere to the requested size.
+    glPushMatrix();
+    glScalef( radius, radius, radius );
+
+    glEnableClientState( GL_VERTEX_ARRAY );
+    glEnableClientState( GL_NORMAL_ARRAY );
+    glEnableClientState( GL_TEXTURE_COORD_ARRAY );
+
+    DrawTile( view, smallest, 0, 0, -1, 0, 0, 0 );
+
+    //Restore the texture matrix and client state.
+    SetTextureWindow( WholeTexture );
+
+    glDisableClientState( GL_VERTEX_ARRAY );
+    glDisableClientState( GL_NORMAL_ARRAY );
+    glDisableClientState( GL_TEXTURE_COORD_ARRAY );
+
+    glPopMatrix();
+
+    return true;
+}
+
+
+
+/******************************************************************************
+* Author: Savoy Schuler and Daniel Hodgin
+*
+* Function: DrawTile
+*
+* Description:
+*
+*   This function draws the patch of the sphere covered by one tile, or the
+*   patches of the four tiles of the next larger level covering it if this
+*   tile has too few texels for its size on screen. The patch is skipped if
+*   it faces away from the eye or is outside the view. A tile not in the
+*   cache is requested and drawn from the fallback tile instead.
+*
+* Parameters:
+*
+*   view            - body being drawn
+*
+*   level           - level of the tile
+*
+*   tx, ty          - column and row of the tile among the level's tiles
+*
+*   fallback        - cache slot of the nearest smaller tile, -1 for none
+*
+*   fallbackLevel   - level of the fallback tile
+*
+*   fallbackTx, fallbackTy  - column and row of the fallback tile
+*
+******************************************************************************/
+static void DrawTile( const TileView &view, int level, int tx, int ty,
+                      int fallback, int fallbackLevel, int fallbackTx,
+                      int fallbackTy )
+{
+    VirtualTexture &texture = VirtualTextures[view.Texture];
+    int cols = LevelSize( texture.Levels.Cols, level );
+    int rows = LevelSize( texture.Levels.Rows, level );
+    int tile = ty * PackTiles( cols ) + tx;
+
+    //Part of the texture map the tile covers.
+    float s0 = ( float ) tx * PackTilePayload / cols;
+    float s1 = min( ( float ) ( tx + 1 ) * PackTilePayload / cols, 1.0f );
+    float t0 = ( float ) ty * PackTilePayload / rows;
+    float t1 = min( ( float ) ( ty + 1 ) * PackTilePayload / rows, 1.0f );
+
+    /*Find the middle of the patch and how far, in radians, its farthest
+    corner or edge is from it.*/
+    float middle[3], point[3];
+    SphereDirection( ( s0 + s1 ) / 2, ( t0 + t1 ) / 2, middle );
+
+    float nearest = 1.0;
+    for ( int j = 0; j <= 2; j++ )
+        for ( int i = 0; i <= 2; i++ )
+        {
+            SphereDirection( s0 + ( s1 - s0 ) * i / 2, t0 + ( t1 - t0 ) * j / 2,
+                             point );
+            nearest = min( nearest, middle[0] * point[0] +
+                           middle[1] * point[1] + middle[2] * point[2] );
+        }
+
+    float spread = acos( max( -1.0f, min( nearest, 1.0f ) ) );
+
+    //Skip patches facing away from the eye, past the sphere's horizon.
+    if ( view.EyeDistance > 1.0 )
+    {
+        float horizon = acos( 1.0 / view.EyeDistance );
+        float facing = ( middle[0] * view.Eye[0] + middle[1] * view.Eye[1] +
+                         middle[2] * view.Eye[2] ) / view.EyeDistance;
+
+        if ( horizon + spread < PI && facing < cos( horizon + spread ) )
+            return;
+    }
+
+    //Skip patches outside the view, bounded by a sphere around the middle.
+    float world[3], bound;
+
+    if ( spread < PI / 2 )
+    {
+        world[0] = view.Position[0] + view.Radius *
+                   ( view.Cos * middle[0] - view.Sin * middle[1] );
+        world[1] = view.Position[1] + view.Radius *
+                   ( view.Sin * middle[0] + view.Cos * middle[1] );
+        world[2] = view.Position[2] + view.Radius * middle[2];
+        bound = 2.0 * view.Radius * sin( spread / 2 );
+    }
+    else
+    {
+        for ( int i = 0; i < 3; i++ )
+            world[i] = view.Position[i];
+        bound = view.Radius;
+    }
+
+    if ( !SphereInView( world, bound ) )
+        return;
+
+    //This tile is now the nearest fallback of the tiles covering it.
+    int slot = texture.Pages[level][tile];
+    if ( slot >= 0 )
+    {
+        Slots[slot].LastUsed = TileFrame;
+        fallback = slot;
+        fallbackLevel = level;
+        fallbackTx = tx;
+        fallbackTy = ty;
+    }
+
+    /*Texels needed around the sphere for one texel per pixel at the nearest
+    point of the patch.*/
+    float dx = view.Eye[0] - middle[0];
+    float dy = view.Eye[1] - middle[1];
+    float dz = view.Eye[2] - middle[2];
+    float distance = view.Radius * sqrt( dx * dx + dy * dy + dz * dz ) - bound;
+    float needed = 2.0 * PI * view.Radius *
+                   PixelsPerUnit( max( distance, 1.0e-4f * view.Radius ) );
+
+    //Split tiles with too few texels into the tiles of the next level.
+    if ( level > 0 && cols < needed )
+    {
+        int childCols = PackTiles( LevelSize( texture.Levels.Cols, level - 1 ) );
+        int childRows = PackTiles( LevelSize( texture.Levels.Rows, level - 1 ) );
+
+        for ( int y = 2 * ty; y <= 2 * ty + 1 && y < childRows; y++ )
+            for ( int x = 2 * tx; x <= 2 * tx + 1 && x < childCols; x++ )
+                DrawTile( view, level - 1, x, y, fallback, fallbackLevel,
+                          fallbackTx, fallbackTy );
+        return;
+    }
+
+    if ( slot < 0 )
+        RequestTile( view.Texture, level, tile );
+
+    if ( fallback < 0 )
+        return;
+
+    //Map the sphere's texture coordinates into the tile drawn from.
+    int fallbackCols = LevelSize( texture.Levels.Cols, fallbackLevel );
+    int fallbackRows = LevelSize( texture.Levels.Rows, fallbackLevel );
+
+    TextureWindow window;
+    window.Scale[0] = ( float ) fallbackCols / PackTileSize;
+    window.Scale[1] = ( float ) fallbackRows / PackTileSize;
+    window.Offset[0] = ( 1.0 - fallbackTx * PackTilePayload ) / PackTileSize;
+    window.Offset[1] = ( 1.0 - fallbackTy * PackTilePayload ) / PackTileSize;
+
+    BindTexture( Slots[fallback].Object );
+    SetTextureWindow( window );
+
+    DrawPatch( view, s0, s1, t0, t1 );
+}
+
+
+
+/******************************************************************************
+* Author: Savoy Schuler and Daniel Hodgin
+*
+* Function: DrawPatch
+*
+* Description:
+*
+*   This function draws the part of the unit sphere covering part of the
+*   texture map, laid out like the spheres of meshes.cpp. Vertices are put
+*   on the lines of the whole sphere's slices and stacks, plus the patch's
+*   edges, so neighbouring patches share the vertices along their edges.
+*
+* Parameters:
+*
+*   view    - body being drawn
+*
+*   s0, s1  - first and last texture column covered
+*
+*   t0, t1  - first and last texture row covered
+*
+******************************************************************************/
+static void DrawPatch( const TileView &view, float s0, float s1, float t0,
+                       float t1 )
+{
+    static vector<float> sLines, tLines;
+
+    PatchLines( s0, s1, view.Resolution, sLines );
+    PatchLines( t0, t1, view.Resolution, tLines );
+
+    int slices = sLines.size() - 1;
+    int stacks = tLines.size() - 1;
+
+    //Position (also the normal) and texture coordinates of each vertex.
+    PatchVertices.resize( ( slices + 1 ) * ( stacks + 1 ) * 5 );
+    GLfloat *vertex = &PatchVertices[0];
+
+    //Stacks run down from the top, slices around the way gluSphere turns.
+    for ( int j = stacks; j >= 0; j-- )
+    {
+        for ( int i = slices; i >= 0; i-- )
+        {
+            SphereDirection( sLines[i], tLines[j], vertex );
+            vertex[3] = sLines[i];
+            vertex[4] = tLines[j];
+            vertex += 5;
+        }
+    }
+
+    //Two counter-clockwise (outward facing) triangles per slice and stack.
+    PatchIndices.clear();
+    for ( int j = 0; j < stacks; j++ )
+    {
+        for ( int i = 0; i < slices; i++ )
+        {
+            GLuint top = j * ( slices + 1 ) + i;
+            GLuint bottom = top + slices + 1;
+
+            PatchIndices.push_back( bottom );
+            PatchIndices.push_back( top );
+            PatchIndices.push_back( top + 1 );
+
+            PatchIndices.push_back( bottom );
+            PatchIndices.push_back( top + 1 );
+            PatchIndices.push_back( bottom + 1 );
+        }
+    }
+
+    glVertexPointer( 3, GL_FLOAT, 5 * sizeof( GLfloat ), &PatchVertices[0] );
+    glNormalPointer( GL_FLOAT, 5 * sizeof( GLfloat ), &PatchVertices[0] );
+    glTexCoordPointer( 2, GL_FLOAT, 5 * sizeof( GLfloat ), &PatchVertices[3] );
+
+    glDrawElements( GL_TRIANGLES, PatchIndices.size(), GL_UNSIGNED_INT,
+                    &PatchIndices[0] );
+    FrameStats.Triangles += PatchIndices.size() / 3;
+}
+
+
+
+/******************************************************************************
+* Author: Savoy Schuler and Daniel Hodgin
+*
+* Function: SphereDirection
+*
+* Description:
+*
+*   This function finds the point of the unit sphere that texture
+*   coordinates are mapped to, the same way as the spheres of meshes.cpp.
+*
+* Parameters:
+*
+*   s, t        - texture coordinates
+*
+*   direction   - returned point on the unit sphere
+*
+******************************************************************************/
+static void SphereDirection( float s, float t, float direction[3] )
+{
+    float theta = 2.0 * PI * ( 1.0 - s );
+    float rho = PI * ( 1.0 - t );
+
+    direction[0] = sin( rho ) * sin( theta );
+    direction[1] = sin( rho ) * cos( theta );
+    direction[2] = cos( rho );
+}
+
+
+
+/******************************************************************************
+* Author: Savoy Schuler and Daniel Hodgin
+*
+* Function: PatchLines
+*
+* Description:
+*
+*   This function lists where a patch's vertices go along one direction:
+*   its two edges, and every line of the whole sphere's resolution between.
+*
+* Parameters:
+*
+*   first, last - edges of the patch, as texture coordinates
+*
+*   resolution  - lines around the whole sphere
+*
+*   lines       - returned lines, from first to last
+*
+******************************************************************************/
+static void PatchLines( float first, float last, int resolution,
+                        vector<float> &lines )
+{
+    lines.clear();
+    lines.push_back( first );
+
+    for ( int k = ( int ) floor( first * resolution ) + 1;
+            k < last * resolution; k++ )
+        lines.push_back( ( float ) k / resolution );
+
+    lines.push_back( last );
+}
+
+
+
+/******************************************************************************
+* Author: Savoy Schuler and Daniel Hodgin
+*
+* Function: RequestTile
+*
+* Description:
+*
+*   This function asks for a tile that is not in the cache. The kernel is
+*   asked to start reading its pages, and UploadTiles uploads it once they
+*   are in memory. Asking again only marks it as still needed.
+*
+* Parameters:
+*
+*   texture - virtual texture of the tile
+*
+*   level   - level of the tile
+*
+*   tile    - tile, numbered along the rows of its level
+*
+******************************************************************************/
+static void RequestTile( int texture, int level, int tile )
+{
+    int &page = VirtualTextures[texture].Pages[level][tile];
+
+    if ( page == TileRequested )
+    {
+        for ( unsigned i = 0; i < TileRequests.size(); i++ )
+            if ( TileRequests[i].Texture == texture &&
+                    TileRequests[i].Level == level && TileRequests[i].Tile == tile )
+                TileRequests[i].LastWanted = TileFrame;
+        return;
+    }
+
+    TileRequest request = { texture, level, tile, TileFrame };
+    TileRequests.push_back( request );
+    page = TileRequested;
+
+    PrefetchPack( VirtualTextures[texture].Levels.Level[level] +
+                  tile * PackTileBytes, PackTileBytes );
+}
+
+
+
+/******************************************************************************
+* Author: Savoy Schuler and Daniel Hodgin
+*
+* Function: FindSlot
+*
+* Description:
+*
+*   This function returns a slot of the tile cache to upload a tile into: a
+*   new one while there are fewer than TileSlots, otherwise the slot least
+*   recently drawn from, whose tile is dropped from its page table. Returns
+*   -1 if every slot was drawn from in the last frame.
+*
+* Parameters:
+*
+*		void	- No input parameters needed.
+*
+******************************************************************************/
+static int FindSlot()
+{
+    if ( Slots.size() < ( unsigned ) TileSlots )
+    {
+        TileSlot slot;
+        slot.Texture = -1;
+        slot.LastUsed = 0;
+
+        //Each slot holds one tile, clamped so its border is the only
+        //neighbour sampled.
+        glGenTextures( 1, &slot.Object );
+        BindTexture( slot.Object );
+        glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE );
+        glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE );
+        glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR );
+        glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR );
+        glTexImage2D( GL_TEXTURE_2D, 0, GL_RGB, PackTileSize, PackTileSize, 0,
+                      GL_RGB, GL_UNSIGNED_BYTE, NULL );
+
+        Slots.push_back( slot );
+        return Slots.size() - 1;
+    }
+
+    int oldest = -1;
+    for ( unsigned i = 0; i < Slots.size(); i++ )
+        if ( Slots[i].LastUsed != TileFrame &&
+                ( oldest < 0 || Slots[i].LastUsed < Slots[oldest].LastUsed ) )
+            oldest = i;
+
+    if ( oldest >= 0 && Slots[oldest].Texture >= 0 )
+    {
+        TileSlot &slot = Slots[oldest];
+        VirtualTextures[slot.Texture].Pages[slot.Level][slot.Tile] = TileAbsent;
+        slot.Texture = -1;
+    }
+
+    return oldest;
+}
+
+
+
+/******************************************************************************
+* Author: Savoy Schuler and Daniel Hodgin
+*
+* Function: SlotFree
+*
+* Description:
+*
+*   Returns true if FindSlot would find a slot: the cache is not full, or
+*   some slot was not drawn from in the last frame.
+*
+* Parameters:
+*
+*		void	- No input parameters needed.
+*
+******************************************************************************/
+static bool SlotFree()
+{
+    if ( Slots.size() < ( unsigned ) TileSlots )
+        return true;
+
+    for ( unsigned i = 0; i < Slots.size(); i++ )
+        if ( Slots[i].LastUsed != TileFrame )
+            return true;
+
+    return false;
+}
+
+
+
+/******************************************************************************
+* Author: Savoy Schuler and Daniel Hodgin
+*
+* Function: UploadTiles
+*
+* Description:
+*
+*   This function is called by the GLUT thread at the start of each frame,
+*   from UploadAssets. Requested tiles whose pages are in memory are copied
+*   into the tile cache, at most TileUploadsPerFrame of them. Requests no
+*   longer needed in the last frame, or with no slot free for them, are
+*   dropped; they are asked for again if still needed. Returns true if any
+*   tile was uploaded.
+*
+* Parameters:
+*
+*		void	- No input parameters needed.
+*
+******************************************************************************/
+bool UploadTiles()
+{
+    int uploads = 0;
+    unsigned kept = 0;
+
+    glPixelStorei( GL_UNPACK_ALIGNMENT, 4 );
+
+    for ( unsigned i = 0; i < TileRequests.size(); i++ )
+    {
+        TileRequest &request = TileRequests[i];
+        VirtualTexture &texture = VirtualTextures[request.Texture];
+        int &page = texture.Pages[request.Level][request.Tile];
+        const byte* data = texture.Levels.Level[request.Level] +
+                           request.Tile * PackTileBytes;
+
+        //Not needed any more.
+        if ( request.LastWanted != TileFrame )
+        {
+            page = TileAbsent;
+            continue;
+        }
+
+        //Not read yet, or enough uploaded this frame.
+        if ( uploads == TileUploadsPerFrame ||
+                !PackResident( data, PackTileBytes ) )
+        {
+            TileRequests[kept++] = request;
+            continue;
+        }
+
+        int slot = FindSlot();
+        if ( slot < 0 )
+        {
+            page = TileAbsent;
+            continue;
+        }
+
+        BindTexture( Slots[slot].Object );
+        glTexSubImage2D( GL_TEXTURE_2D, 0, 0, 0, PackTileSize, PackTileSize,
+                         GL_RGB, GL_UNSIGNED_BYTE, data );
+
+        Slots[slot].Texture = request.Texture;
+        Slots[slot].Level = request.Level;
+        Slots[slot].Tile = request.Tile;
+        Slots[slot].LastUsed = TileFrame;
+        page = slot;
+        uploads++;
+    }
+
+    TileRequests.resize( kept );
+    TileFrame++;
+
+    return uploads > 0;
+}
+
+
+
+/******************************************************************************
+* Author: Savoy Schuler and Daniel Hodgin
+*
+* Function: TilesPending
+*
+* Description:
+*
+*   Returns true while any requested tile has not been uploaded yet.
+*
+* Parameters:
+*
+*		void	- No input parameters needed.
+*
+******************************************************************************/
+bool TilesPending()
+{
+    return !TileRequests.empty();
+}
+
+
+
+/******************************************************************************
+* Author: Savoy Schuler and Daniel Hodgin
+*
+* Function: TilesReady
+*
+* Description:
+*
+*   Returns true if a requested tile's pages are in memory and there is a
+*   slot for it, so it can be uploaded by UploadTiles.
+*
+* Parameters:
+*
+*		void	- No input parameters needed.
+*
+******************************************************************************/
+bool TilesReady()
+{
+    if ( !SlotFree() )
+        return false;
+
+    for ( unsigned i = 0; i < TileRequests.size(); i++ )
+    {
+        TileRequest &request = TileRequests[i];
+
+        if ( PackResident( VirtualTextures[request.Texture].Levels.Level[request.Level] +
+                           request.Tile * PackTileBytes, PackTileBytes ) )
+            return true;
+    }
+
+    return false;
+}
+
+
+
+/******************************************************************************
+* Author: Savoy Schuler and Daniel Hodgin
+*
+* Function: ResidentTiles
+*
+* Description:
+*
+*   Returns the number of tiles in the tile cache.
+*
+* Parameters:
+*
+*		void	- No input parameters needed.
+*
+******************************************************************************/
+int ResidentTiles()
+{
+    int count = 0;
+
+    for ( unsigned i = 0; i < Slots.size(); i++ )
+        if ( Slots[i].Texture >= 0 )
+            count++;
+
+    return count;
+}